@@ -0,0 +1,138 @@
+// bench/bench_report.cpp
+#include "bench_report.h"
+#include "models/alloc_tracker.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+
+double percentileMs(const std::vector<qint64>& sorted, double p)
+{
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[index] / 1e6;
+}
+
+} // namespace
+
+LatencyStats runFrames(const QString& name, int frames, const std::function<void()>& frame)
+{
+    LatencyStats stats;
+    stats.name = name;
+    stats.samples.reserve(frames);
+
+    // One untimed frame so font and style caches are warm
+    frame();
+
+    QElapsedTimer timer;
+    for (int i = 0; i < frames; ++i) {
+        timer.start();
+        frame();
+        stats.samples.push_back(timer.nsecsElapsed());
+    }
+    return stats;
+}
+
+void reportLatencies(QTextStream& out, const QList<LatencyStats>& results)
+{
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+           .arg("benchmark", -28)
+           .arg("count", 7)
+           .arg("p50 ms", 9)
+           .arg("p90 ms", 9)
+           .arg("p99 ms", 9)
+           .arg("max ms", 9);
+
+    for (const LatencyStats& stats : results) {
+        std::vector<qint64> sorted = stats.samples;
+        std::sort(sorted.begin(), sorted.end());
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+               .arg(stats.name, -28)
+               .arg(sorted.size(), 7)
+               .arg(percentileMs(sorted, 0.50), 9, 'f', 3)
+               .arg(percentileMs(sorted, 0.90), 9, 'f', 3)
+               .arg(percentileMs(sorted, 0.99), 9, 'f', 3)
+               .arg(sorted.empty() ? 0.0 : sorted.back() / 1e6, 9, 'f', 3);
+    }
+    out.flush();
+}
+
+void reportAllocations(QTextStream& out)
+{
+    if (!AllocTracker::isEnabled()) return;
+
+    out << QString("\n%1 %2 %3 %4 %5\n")
+           .arg("allocation tag", -28)
+           .arg("scopes", 9)
+           .arg("allocs", 11)
+           .arg("allocs/op", 11)
+           .arg("bytes/op", 11);
+
+    for (const AllocTracker::TagCounters& counters : AllocTracker::report()) {
+        double perScope = counters.scopes ? double(counters.allocations) / counters.scopes : 0.0;
+        double bytesPerScope = counters.scopes ? double(counters.bytes) / counters.scopes : 0.0;
+        out << QString("%1 %2 %3 %4 %5\n")
+               .arg(counters.tag, -28)
+               .arg(counters.scopes, 9)
+               .arg(counters.allocations, 11)
+               .arg(perScope, 11, 'f', 1)
+               .arg(bytesPerScope, 11, 'f', 0);
+    }
+    out.flush();
+}
+
+void reportHeapUsage(QTextStream& out)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+    const double inUse = double(info.uordblks);
+    const double freeHeld = double(info.fordblks);
+    out << QString("\nheap: %1 KiB in use, %2 KiB free in arenas (%3% fragmentation)\n")
+           .arg(inUse / 1024, 0, 'f', 0)
+           .arg(freeHeld / 1024, 0, 'f', 0)
+           .arg(inUse + freeHeld > 0 ? 100.0 * freeHeld / (inUse + freeHeld) : 0.0, 0, 'f', 1);
+    out.flush();
+#else
+    Q_UNUSED(out);
+#endif
+}
+
+bool checkAllocationBudgets(QTextStream& out, const QStringList& budgets)
+{
+    if (budgets.isEmpty()) return true;
+    if (!AllocTracker::isEnabled()) {
+        out << "allocation budgets ignored: built without WORKOUT_ALLOC_TRACKING\n";
+        return true;
+    }
+
+    const QList<AllocTracker::TagCounters> counters = AllocTracker::report();
+    bool withinBudget = true;
+
+    for (const QString& budget : budgets) {
+        const QString tag = budget.section(QLatin1Char('='), 0, 0);
+        bool ok = false;
+        const double limit = budget.section(QLatin1Char('='), 1).toDouble(&ok);
+        if (!ok) {
+            out << "invalid allocation budget: " << budget << "\n";
+            withinBudget = false;
+            continue;
+        }
+
+        for (const AllocTracker::TagCounters& entry : counters) {
+            if (entry.tag != tag || entry.scopes == 0) continue;
+            double perScope = double(entry.allocations) / entry.scopes;
+            if (perScope > limit) {
+                out << QString("ALLOCATION BUDGET EXCEEDED: %1 averages %2 allocations per op, budget %3\n")
+                       .arg(tag)
+                       .arg(perScope, 0, 'f', 1)
+                       .arg(limit);
+                withinBudget = false;
+            }
+        }
+    }
+    out.flush();
+    return withinBudget;
+}
@@ -0,0 +1,35 @@
+// bench/bench_report.h
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <QList>
+#include <QStringList>
+#include <QString>
+#include <QTextStream>
+#include <functional>
+#include <vector>
+
+struct LatencyStats {
+    QString name;
+    std::vector<qint64> samples; // nanoseconds per sample
+};
+
+// Runs `frame` once untimed, then `frames` timed times
+LatencyStats runFrames(const QString& name, int frames, const std::function<void()>& frame);
+
+// Prints one row per benchmark with p50/p90/p99/max in milliseconds
+void reportLatencies(QTextStream& out, const QList<LatencyStats>& results);
+
+// Prints allocation counters per tag; a no-op unless the build has
+// WORKOUT_ALLOC_TRACKING enabled
+void reportAllocations(QTextStream& out);
+
+// Prints heap bytes in use and bytes held free by the allocator, a rough
+// fragmentation measure after a workload. Needs glibc 2.33 or later.
+void reportHeapUsage(QTextStream& out);
+
+// Checks "tag=N" budgets against the average allocations per scope entry.
+// Prints every violation and returns false if there was one.
+bool checkAllocationBudgets(QTextStream& out, const QStringList& budgets);
+
+#endif // BENCH_REPORT_H
@@ -0,0 +1,107 @@
+// bench/render_bench.cpp
+//
+// Times full repaints and navigation of the calendar widgets under the
+// offscreen QPA platform. Run with --help for options.
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QImage>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include "bench_report.h"
+#include "models/alloc_tracker.h"
+#include "synthetic_store.h"
+#include "views/customcalendarwidget.h"
+#include "views/weekview.h"
+
+int main(int argc, char *argv[])
+{
+    // Must be set before QApplication picks a platform plugin
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Repaint and navigation benchmark for the calendar views");
+    parser.addHelpOption();
+    QCommandLineOption framesOption("frames", "Timed frames per benchmark.", "n", "200");
+    QCommandLineOption yearsOption("years", "Years of synthetic history to load.", "n", "5");
+    QCommandLineOption seedOption("seed", "Seed for the synthetic history.", "n", "1");
+    QCommandLineOption budgetOption("alloc-budget", "Fail if a tag averages more than N allocations (tag=N).", "tag=N");
+    parser.addOption(framesOption);
+    parser.addOption(yearsOption);
+    parser.addOption(seedOption);
+    parser.addOption(budgetOption);
+    parser.process(app);
+
+    int frames = qMax(1, parser.value(framesOption).toInt());
+    int years = qMax(0, parser.value(yearsOption).toInt());
+    quint32 seed = parser.value(seedOption).toUInt();
+
+    QTemporaryDir tempDir;
+    QString storePath = QDir(tempDir.path()).filePath("workouts.json");
+    HistoryConfig history;
+    history.years = years;
+    history.seed = seed;
+    if (!tempDir.isValid() || !loadSyntheticStore(storePath, history)) {
+        qCritical("Could not create the synthetic store");
+        return 1;
+    }
+
+    CustomCalendarWidget calendar;
+    calendar.resize(800, 600);
+    calendar.loadSavedData();
+    calendar.show();
+
+    WeekView weekView;
+    weekView.resize(1100, 300);
+    weekView.loadWorkoutData();
+    weekView.show();
+
+    QApplication::processEvents();
+
+    // Render into preallocated images so the timings cover painting only
+    QImage calendarImage(calendar.size(), QImage::Format_ARGB32_Premultiplied);
+    QImage weekImage(weekView.size(), QImage::Format_ARGB32_Premultiplied);
+
+    AllocTracker::reset();
+    QList<LatencyStats> results;
+
+    results << runFrames("calendar repaint", frames, [&]() {
+        calendar.render(&calendarImage);
+    });
+
+    results << runFrames("week repaint", frames, [&]() {
+        weekView.render(&weekImage);
+    });
+
+    results << runFrames("week nextWeek + repaint", frames, [&]() {
+        weekView.nextWeek();
+        weekView.render(&weekImage);
+    });
+
+    results << runFrames("week prevWeek + repaint", frames, [&]() {
+        weekView.prevWeek();
+        weekView.render(&weekImage);
+    });
+
+    results << runFrames("calendar nextMonth + repaint", frames, [&]() {
+        calendar.showNextMonth();
+        calendar.render(&calendarImage);
+    });
+
+    results << runFrames("calendar prevMonth + repaint", frames, [&]() {
+        calendar.showPreviousMonth();
+        calendar.render(&calendarImage);
+    });
+
+    QTextStream out(stdout);
+    out << "Synthetic store: " << years << " years, seed " << seed << "\n";
+    reportLatencies(out, results);
+    reportAllocations(out);
+
+    return checkAllocationBudgets(out, parser.values(budgetOption)) ? 0 : 3;
+}
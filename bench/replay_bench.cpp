@@ -0,0 +1,181 @@
+// bench/replay_bench.cpp
+//
+// Replays a trace of UI-level operations against a full MainWindow (or, with
+// --storage-only, against a bare StorageManager) under the offscreen platform
+// and reports end-to-end latency per operation type.
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QMap>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include "bench_report.h"
+#include "models/alloc_tracker.h"
+#include "synthetic_store.h"
+#include "workload_trace.h"
+#include "models/storage_manager.h"
+#include "views/mainwindow.h"
+
+namespace {
+
+using Timings = QMap<int, std::vector<qint64>>;
+
+void replayOnWindow(const QVector<TraceOp>& ops, Timings& timings)
+{
+    MainWindow window;
+    window.resize(1100, 700);
+    window.show();
+    QApplication::processEvents();
+
+    CustomCalendarWidget* calendar = window.findChild<CustomCalendarWidget*>();
+    WeekView* weekView = window.findChild<WeekView*>();
+    StorageManager& storage = StorageManager::instance();
+    QImage weekImage(QSize(1100, 300), QImage::Format_ARGB32_Premultiplied);
+
+    QElapsedTimer timer;
+    for (const TraceOp& op : ops) {
+        timer.start();
+
+        // Each case goes through the same public calls the UI makes
+        switch (op.kind) {
+            case TraceOp::Select:
+                emit calendar->clicked(op.date);
+                break;
+            case TraceOp::Status:
+                calendar->setDayStatus(op.date, op.status);
+                break;
+            case TraceOp::Save: {
+                const WorkoutRecord* existing = storage.find(op.date);
+                WorkoutStatus status = existing ? existing->status : WorkoutStatus::NoWorkout;
+                storage.saveWorkout(op.date, op.name, op.description, op.exercises, status);
+                calendar->setWorkoutData(op.date, *storage.find(op.date));
+                calendar->setDayStatus(op.date, status);
+                break;
+            }
+            case TraceOp::Paste:
+                applyToStore(storage, op);
+                weekView->updateCell(op.date);
+                break;
+            case TraceOp::NavWeek:
+                op.step > 0 ? weekView->nextWeek() : weekView->prevWeek();
+                weekView->render(&weekImage);
+                break;
+            case TraceOp::NavMonth:
+                op.step > 0 ? calendar->showNextMonth() : calendar->showPreviousMonth();
+                calendar->repaint();
+                break;
+        }
+        QApplication::processEvents();
+
+        timings[op.kind].push_back(timer.nsecsElapsed());
+    }
+}
+
+void replayOnStore(const QString& dataPath, const QVector<TraceOp>& ops, Timings& timings)
+{
+    StorageManager store;
+    store.loadFromFile(dataPath);
+
+    QElapsedTimer timer;
+    for (const TraceOp& op : ops) {
+        timer.start();
+        applyToStore(store, op);
+        timings[op.kind].push_back(timer.nsecsElapsed());
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("WorkoutTrackerReplay");
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("End-to-end replay of UI operation traces");
+    parser.addHelpOption();
+    QCommandLineOption dataOption("data", "Data file to start from (default: synthetic).", "file");
+    QCommandLineOption traceOption("trace", "Trace to replay (default: generated).", "file");
+    QCommandLineOption yearsOption("years", "Years of synthetic history.", "n", "5");
+    QCommandLineOption opsOption("ops", "Operations in a generated trace.", "n", "500");
+    QCommandLineOption seedOption("seed", "Seed for generated data.", "n", "1");
+    QCommandLineOption storageOnlyOption("storage-only", "Replay against StorageManager only.");
+    QCommandLineOption budgetOption("alloc-budget", "Fail if a tag averages more than N allocations (tag=N).", "tag=N");
+    parser.addOptions({dataOption, traceOption, yearsOption, opsOption, seedOption, storageOnlyOption,
+                       budgetOption});
+    parser.process(app);
+
+    const quint32 seed = parser.value(seedOption).toUInt();
+
+    // The replay edits its own copy so the input file is never touched
+    QTemporaryDir tempDir;
+    QString dataPath = QDir(tempDir.path()).filePath("workouts.json");
+    if (parser.isSet(dataOption)) {
+        if (!QFile::copy(parser.value(dataOption), dataPath)) {
+            qCritical("Could not copy the data file");
+            return 1;
+        }
+        QFile::setPermissions(dataPath, QFile::ReadOwner | QFile::WriteOwner);
+    } else {
+        HistoryConfig history;
+        history.years = qMax(0, parser.value(yearsOption).toInt());
+        history.seed = seed;
+        StorageManager generated;
+        fillSyntheticHistory(generated, history);
+        if (!generated.saveToFile(dataPath)) {
+            qCritical("Could not write the synthetic store");
+            return 1;
+        }
+    }
+
+    QVector<TraceOp> ops;
+    if (parser.isSet(traceOption)) {
+        QFile traceFile(parser.value(traceOption));
+        if (!traceFile.open(QIODevice::ReadOnly) || !readTrace(traceFile, ops)) {
+            qCritical("Could not read the trace");
+            return 1;
+        }
+    } else {
+        TraceConfig trace;
+        trace.operations = qMax(0, parser.value(opsOption).toInt());
+        trace.seed = seed + 1;
+        ops = generateTrace(trace);
+    }
+
+    AllocTracker::reset();
+    Timings timings;
+    if (parser.isSet(storageOnlyOption)) {
+        replayOnStore(dataPath, ops, timings);
+    } else {
+        // MainWindow loads from the default location, which is a test
+        // directory while test mode is enabled
+        QDir appData(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+        appData.mkpath(".");
+        QString windowPath = appData.filePath("workouts.json");
+        QFile::remove(windowPath);
+        QFile::copy(dataPath, windowPath);
+
+        replayOnWindow(ops, timings);
+        QFile::remove(windowPath);
+    }
+
+    QList<LatencyStats> results;
+    for (auto it = timings.begin(); it != timings.end(); ++it) {
+        results << LatencyStats{traceOpName(static_cast<TraceOp::Kind>(it.key())), it.value()};
+    }
+
+    QTextStream out(stdout);
+    out << "Replayed " << ops.size() << " operations"
+        << (parser.isSet(storageOnlyOption) ? " against StorageManager\n" : " against MainWindow\n");
+    reportLatencies(out, results);
+    reportAllocations(out);
+    return checkAllocationBudgets(out, parser.values(budgetOption)) ? 0 : 3;
+}
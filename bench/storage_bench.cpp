@@ -0,0 +1,148 @@
+// bench/storage_bench.cpp
+//
+// Times and counts allocations of the StorageManager hot paths on a synthetic
+// history: bulk load, per-day reads, status edits, full saves and the
+// analytics kernels over the whole history.
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include "bench_report.h"
+#include "synthetic_store.h"
+#include "models/alloc_tracker.h"
+#include "models/analytics.h"
+#include "models/exercise_name_index.h"
+#include "models/storage_manager.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("default.debug=false\ndefault.info=false");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("StorageManager load/save benchmark");
+    parser.addHelpOption();
+    QCommandLineOption yearsOption("years", "Years of synthetic history.", "n", "20");
+    QCommandLineOption iterationsOption("iterations", "Timed iterations per benchmark.", "n", "20");
+    QCommandLineOption seedOption("seed", "Seed for the synthetic history.", "n", "1");
+    QCommandLineOption budgetOption("alloc-budget", "Fail if a tag averages more than N allocations (tag=N).", "tag=N");
+    parser.addOptions({yearsOption, iterationsOption, seedOption, budgetOption});
+    parser.process(app);
+
+    const int iterations = qMax(1, parser.value(iterationsOption).toInt());
+
+    HistoryConfig history;
+    history.years = qMax(0, parser.value(yearsOption).toInt());
+    history.seed = parser.value(seedOption).toUInt();
+
+    QTemporaryDir tempDir;
+    const QString dataPath = QDir(tempDir.path()).filePath("workouts.json");
+    const QString savePath = QDir(tempDir.path()).filePath("saved.json");
+    {
+        StorageManager generated;
+        fillSyntheticHistory(generated, history);
+        if (!tempDir.isValid() || !generated.saveToFile(dataPath)) {
+            qCritical("Could not write the synthetic store");
+            return 1;
+        }
+    }
+
+    StorageManager store;
+    store.setAutoSave(false);
+    store.loadFromFile(dataPath);
+    const QVector<QDate> dates = store.getAllWorkoutDates();
+    if (dates.isEmpty()) {
+        qCritical("Synthetic store is empty");
+        return 1;
+    }
+
+    AllocTracker::reset();
+    QList<LatencyStats> results;
+
+    results << runFrames("loadFromFile", iterations, [&]() {
+        store.loadFromFile(dataPath);
+    });
+
+    results << runFrames("loadWorkout (all days)", iterations, [&]() {
+        QString name, description;
+        QVector<Exercise> exercises;
+        WorkoutStatus status;
+        for (const QDate& date : dates) {
+            store.loadWorkout(date, name, description, exercises, status);
+        }
+    });
+
+    results << runFrames("find (all days)", iterations, [&]() {
+        int exerciseCount = 0;
+        for (const QDate& date : dates) {
+            if (const WorkoutRecord* workout = store.find(date)) {
+                exerciseCount += workout->exercises().size();
+            }
+        }
+        Q_UNUSED(exerciseCount);
+    });
+
+    QRandomGenerator rng(history.seed);
+    results << runFrames("setStatus (x100)", iterations, [&]() {
+        for (int i = 0; i < 100; ++i) {
+            const QDate& date = dates[rng.bounded(dates.size())];
+            store.setStatus(date, i % 2 ? WorkoutStatus::Completed : WorkoutStatus::Missed);
+        }
+    });
+
+    results << runFrames("saveToFile", iterations, [&]() {
+        store.saveToFile(savePath);
+    });
+
+    const QDate first = dates.first();
+    const QDate last = dates.last();
+    results << runFrames("dailyLoad (full history)", iterations, [&]() {
+        Analytics::dailyLoad(store.records(), store.sets(), first, last);
+    });
+
+    const Analytics::DailyLoad load = Analytics::dailyLoad(store.records(), store.sets(), first, last);
+    QVector<float> series(load.size());
+    results << runFrames("acuteChronicRatio (full history)", iterations, [&]() {
+        Analytics::acuteChronicRatio(load.volume.constData(), series.data(), load.size());
+    });
+
+    // The synthetic history has no set detail; time the 1RM kernel on
+    // columns of a comparable size instead
+    const qsizetype setCount = qsizetype(dates.size()) * 20;
+    QVector<float> weights(setCount);
+    QVector<qint32> reps(setCount);
+    for (qsizetype i = 0; i < setCount; ++i) {
+        weights[i] = float(20 + rng.bounded(180));
+        reps[i] = qint32(1 + rng.bounded(15));
+    }
+    QVector<float> estimates(setCount);
+    results << runFrames("estimateOneRepMax (20 sets/day)", iterations, [&]() {
+        Analytics::estimateOneRepMax(weights.constData(), reps.constData(), estimates.data(),
+                                     setCount, Analytics::OneRepMaxFormula::Epley);
+    });
+
+    // Completion over a large vocabulary: one lookup per keystroke of
+    // typing a name
+    ExerciseNameIndex nameIndex;
+    const QStringList vocabulary = syntheticExerciseNames(20000);
+    for (qsizetype i = 0; i < vocabulary.size(); ++i) {
+        nameIndex.add(vocabulary[i], first.addDays(i % 3650));
+    }
+    results << runFrames("name completion (20k names, one word)", iterations, [&]() {
+        const QString& name = vocabulary[rng.bounded(vocabulary.size())];
+        for (qsizetype length = 1; length <= name.size(); ++length) {
+            nameIndex.complete(name.left(length));
+        }
+    });
+
+    QTextStream out(stdout);
+    out << "Synthetic store: " << history.years << " years, " << dates.size() << " workouts\n";
+    reportLatencies(out, results);
+    reportAllocations(out);
+    reportHeapUsage(out);
+
+    return checkAllocationBudgets(out, parser.values(budgetOption)) ? 0 : 3;
+}
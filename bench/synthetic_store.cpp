@@ -0,0 +1,77 @@
+// bench/synthetic_store.cpp
+#include "synthetic_store.h"
+#include "models/storage_manager.h"
+#include <QRandomGenerator>
+
+QStringList syntheticExerciseNames(int size)
+{
+    static const QStringList baseNames = {
+        "Bench press", "Squat", "Deadlift", "Overhead press", "Barbell row",
+        "Pull-up", "Dip", "Lunge", "Romanian deadlift", "Face pull",
+        "Incline press", "Front squat", "Hip thrust", "Lat pulldown", "Curl"
+    };
+
+    QStringList names;
+    for (int i = 0; i < qMax(1, size); ++i) {
+        if (i < baseNames.size()) {
+            names << baseNames[i];
+        } else {
+            names << QString("%1 %2").arg(baseNames[i % baseNames.size()]).arg(i / baseNames.size() + 1);
+        }
+    }
+    return names;
+}
+
+void fillSyntheticHistory(StorageManager& store, const HistoryConfig& config)
+{
+    static const QStringList workoutNames = {
+        "Push day A", "Pull day A", "Legs", "Push day B", "Pull day B", "Full body"
+    };
+    const QStringList exerciseNames = syntheticExerciseNames(config.vocabulary);
+
+    QRandomGenerator rng(config.seed);
+    const bool autoSave = store.isAutoSave();
+    store.setAutoSave(false);
+
+    QDate date = config.lastDay.addYears(-config.years);
+    for (; date <= config.lastDay; date = date.addDays(1)) {
+        if (int(rng.bounded(7)) >= config.sessionsPerWeek) continue;
+
+        int roll = rng.bounded(100);
+        WorkoutStatus status = WorkoutStatus::NoWorkout;
+        if (roll < config.completedPercent) {
+            status = WorkoutStatus::Completed;
+        } else if (roll < config.completedPercent + config.missedPercent) {
+            status = WorkoutStatus::Missed;
+        } else if (roll < config.completedPercent + config.missedPercent + config.restPercent) {
+            status = WorkoutStatus::RestDay;
+        }
+
+        QVector<Exercise> exercises;
+        if (status != WorkoutStatus::RestDay) {
+            int exerciseCount = 3 + rng.bounded(8);
+            for (int i = 0; i < exerciseCount; ++i) {
+                exercises.append(Exercise{exerciseNames[rng.bounded(exerciseNames.size())],
+                                          3 + int(rng.bounded(3)),
+                                          5 + int(rng.bounded(8))});
+            }
+        }
+
+        QString name = status == WorkoutStatus::RestDay
+            ? QString()
+            : workoutNames[rng.bounded(workoutNames.size())];
+        store.saveWorkout(date, name, QString(), exercises, status);
+    }
+
+    store.setAutoSave(autoSave);
+}
+
+bool loadSyntheticStore(const QString& filePath, const HistoryConfig& config)
+{
+    StorageManager generated;
+    fillSyntheticHistory(generated, config);
+    if (!generated.saveToFile(filePath)) {
+        return false;
+    }
+    return StorageManager::instance().loadFromFile(filePath);
+}
@@ -0,0 +1,33 @@
+// bench/synthetic_store.h
+#ifndef SYNTHETIC_STORE_H
+#define SYNTHETIC_STORE_H
+
+#include <QDate>
+#include <QString>
+#include <QStringList>
+
+class StorageManager;
+
+struct HistoryConfig {
+    int years = 5;
+    int sessionsPerWeek = 4;
+    int vocabulary = 10;          // distinct exercise names
+    int completedPercent = 70;
+    int missedPercent = 15;
+    int restPercent = 10;         // the remainder stays planned
+    quint32 seed = 1;
+    QDate lastDay = QDate::currentDate();
+};
+
+// Exercise names used by the generator, the first `size` of a fixed list
+// padded with numbered variants
+QStringList syntheticExerciseNames(int size);
+
+// Fills `store` with a history described by `config`. The same config always
+// produces the same records. The store is left unsaved.
+void fillSyntheticHistory(StorageManager& store, const HistoryConfig& config);
+
+// Writes a synthetic history to `filePath` and loads it into StorageManager.
+bool loadSyntheticStore(const QString& filePath, const HistoryConfig& config);
+
+#endif // SYNTHETIC_STORE_H
@@ -0,0 +1,184 @@
+// bench/workload_trace.cpp
+#include "workload_trace.h"
+#include "synthetic_store.h"
+#include "models/storage_manager.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <utility>
+
+namespace {
+
+const char* const kindNames[] = { "status", "save", "paste", "select", "nav-week", "nav-month" };
+
+bool kindFromName(const QString& name, TraceOp::Kind& kind)
+{
+    for (int i = 0; i <= TraceOp::NavMonth; ++i) {
+        if (name == QLatin1String(kindNames[i])) {
+            kind = static_cast<TraceOp::Kind>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+QDate randomDay(QRandomGenerator& rng, const QDate& from, const QDate& to)
+{
+    qint64 span = qMax<qint64>(1, from.daysTo(to) + 1);
+    return from.addDays(rng.bounded(span));
+}
+
+} // namespace
+
+QString traceOpName(TraceOp::Kind kind)
+{
+    return QString::fromLatin1(kindNames[kind]);
+}
+
+QVector<TraceOp> generateTrace(const TraceConfig& config)
+{
+    static const WorkoutStatus statuses[] = {
+        WorkoutStatus::Completed, WorkoutStatus::Missed,
+        WorkoutStatus::RestDay, WorkoutStatus::NoWorkout
+    };
+    const QStringList exerciseNames = syntheticExerciseNames(config.vocabulary);
+    const QDate to = config.to.isValid() ? config.to : QDate::currentDate();
+    const QDate from = config.from.isValid() ? config.from : to.addDays(-90);
+
+    QRandomGenerator rng(config.seed);
+    QVector<TraceOp> ops;
+    ops.reserve(config.operations);
+
+    // Mix loosely modelled on a session: mostly browsing and status changes
+    for (int i = 0; i < config.operations; ++i) {
+        TraceOp op;
+        op.date = randomDay(rng, from, to);
+
+        int roll = rng.bounded(100);
+        if (roll < 30) {
+            op.kind = TraceOp::Select;
+        } else if (roll < 55) {
+            op.kind = TraceOp::Status;
+            op.status = statuses[rng.bounded(4)];
+        } else if (roll < 70) {
+            op.kind = TraceOp::Save;
+            op.name = QString("Workout %1").arg(rng.bounded(20));
+            op.status = WorkoutStatus::NoWorkout;
+            int exerciseCount = 3 + rng.bounded(8);
+            for (int e = 0; e < exerciseCount; ++e) {
+                op.exercises.append(Exercise{exerciseNames[rng.bounded(exerciseNames.size())],
+                                             3 + int(rng.bounded(3)),
+                                             5 + int(rng.bounded(8))});
+            }
+        } else if (roll < 78) {
+            op.kind = TraceOp::Paste;
+            op.source = randomDay(rng, from, to);
+        } else if (roll < 92) {
+            op.kind = TraceOp::NavWeek;
+            op.step = rng.bounded(2) ? 1 : -1;
+        } else {
+            op.kind = TraceOp::NavMonth;
+            op.step = rng.bounded(2) ? 1 : -1;
+        }
+        ops.append(op);
+    }
+    return ops;
+}
+
+void writeTrace(const QVector<TraceOp>& ops, QIODevice& device)
+{
+    for (const TraceOp& op : ops) {
+        QJsonObject opObj;
+        opObj["op"] = traceOpName(op.kind);
+        opObj["date"] = op.date.toString(Qt::ISODate);
+
+        switch (op.kind) {
+            case TraceOp::Status:
+                opObj["status"] = workoutStatusName(op.status);
+                break;
+            case TraceOp::Save: {
+                opObj["name"] = op.name;
+                opObj["description"] = op.description;
+                QJsonArray exercisesArray;
+                for (const Exercise& exercise : op.exercises) {
+                    QJsonObject exerciseObj;
+                    exerciseObj["name"] = exercise.name;
+                    exerciseObj["sets"] = exercise.sets;
+                    exerciseObj["reps"] = exercise.reps;
+                    exercisesArray.append(exerciseObj);
+                }
+                opObj["exercises"] = exercisesArray;
+                break;
+            }
+            case TraceOp::Paste:
+                opObj["source"] = op.source.toString(Qt::ISODate);
+                break;
+            case TraceOp::NavWeek:
+            case TraceOp::NavMonth:
+                opObj["step"] = op.step;
+                break;
+            case TraceOp::Select:
+                break;
+        }
+
+        device.write(QJsonDocument(opObj).toJson(QJsonDocument::Compact));
+        device.write("\n");
+    }
+}
+
+bool readTrace(QIODevice& device, QVector<TraceOp>& ops)
+{
+    ops.clear();
+    while (!device.atEnd()) {
+        QByteArray line = device.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject()) return false;
+        QJsonObject opObj = doc.object();
+
+        TraceOp op;
+        if (!kindFromName(opObj["op"].toString(), op.kind)) return false;
+        op.date = QDate::fromString(opObj["date"].toString(), Qt::ISODate);
+        op.source = QDate::fromString(opObj["source"].toString(), Qt::ISODate);
+        parseWorkoutStatus(opObj["status"].toString(), op.status);
+        op.name = opObj["name"].toString();
+        op.description = opObj["description"].toString();
+        op.step = opObj["step"].toInt(1);
+
+        const QJsonArray exercisesArray = opObj["exercises"].toArray();
+        for (const QJsonValue& value : exercisesArray) {
+            QJsonObject exerciseObj = value.toObject();
+            op.exercises.append(Exercise{exerciseObj["name"].toString(),
+                                         exerciseObj["sets"].toInt(),
+                                         exerciseObj["reps"].toInt()});
+        }
+        ops.append(op);
+    }
+    return true;
+}
+
+void applyToStore(StorageManager& store, const TraceOp& op)
+{
+    switch (op.kind) {
+        case TraceOp::Status:
+            store.setStatus(op.date, op.status);
+            break;
+        case TraceOp::Save: {
+            const WorkoutRecord* existing = store.find(op.date);
+            WorkoutStatus status = existing ? existing->status : WorkoutStatus::NoWorkout;
+            store.saveWorkout(op.date, op.name, op.description, op.exercises, status);
+            break;
+        }
+        case TraceOp::Paste:
+            if (const WorkoutRecord* source = store.find(op.source)) {
+                WorkoutRecord copy = *source;
+                copy.status = WorkoutStatus::NoWorkout;
+                store.saveWorkout(op.date, std::move(copy));
+            }
+            break;
+        default:
+            break;
+    }
+}
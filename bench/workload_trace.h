@@ -0,0 +1,53 @@
+// bench/workload_trace.h
+#ifndef WORKLOAD_TRACE_H
+#define WORKLOAD_TRACE_H
+
+#include <QDate>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+#include "models/types.h"
+#include "models/workout_status.h"
+
+class StorageManager;
+
+// One UI-level operation. Traces are stored as JSON lines, one op per line.
+struct TraceOp {
+    enum Kind {
+        Status,     // context-menu status change on `date`
+        Save,       // workout dialog accepted for `date`
+        Paste,      // copy `source` onto `date`
+        Select,     // day clicked
+        NavWeek,    // week view next/prev by `step`
+        NavMonth    // month view next/prev by `step`
+    };
+
+    Kind kind = Select;
+    QDate date;
+    QDate source;
+    WorkoutStatus status = WorkoutStatus::NoWorkout;
+    QString name;
+    QString description;
+    QVector<Exercise> exercises;
+    int step = 1;
+};
+
+struct TraceConfig {
+    int operations = 1000;
+    QDate from;                   // edits land between from and to
+    QDate to;
+    int vocabulary = 10;
+    quint32 seed = 1;
+};
+
+QString traceOpName(TraceOp::Kind kind);
+
+QVector<TraceOp> generateTrace(const TraceConfig& config);
+void writeTrace(const QVector<TraceOp>& ops, QIODevice& device);
+bool readTrace(QIODevice& device, QVector<TraceOp>& ops);
+
+// Applies a storage-level op directly to `store`; navigation and selection
+// ops have no storage effect and are ignored
+void applyToStore(StorageManager& store, const TraceOp& op);
+
+#endif // WORKLOAD_TRACE_H
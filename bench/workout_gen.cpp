@@ -0,0 +1,80 @@
+// bench/workout_gen.cpp
+//
+// Writes a synthetic workout history, and optionally a replayable trace of
+// UI-level operations over it. Run with --help for options.
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QLoggingCategory>
+#include <cstdio>
+#include "synthetic_store.h"
+#include "workload_trace.h"
+#include "models/storage_manager.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("default.debug=false\ndefault.info=false");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Synthetic workout history and trace generator");
+    parser.addHelpOption();
+    QCommandLineOption outputOption({"o", "output"}, "Data file to write.", "file", "workouts.json");
+    QCommandLineOption yearsOption("years", "Years of history.", "n", "5");
+    QCommandLineOption perWeekOption("per-week", "Sessions per week (0-7).", "n", "4");
+    QCommandLineOption vocabularyOption("vocabulary", "Distinct exercise names.", "n", "10");
+    QCommandLineOption completedOption("completed", "Percent of sessions completed.", "pct", "70");
+    QCommandLineOption missedOption("missed", "Percent of sessions missed.", "pct", "15");
+    QCommandLineOption restOption("rest", "Percent of sessions marked rest days.", "pct", "10");
+    QCommandLineOption seedOption("seed", "Random seed.", "n", "1");
+    QCommandLineOption traceOption("trace", "Also write an operation trace (JSON lines).", "file");
+    QCommandLineOption opsOption("ops", "Operations in the trace.", "n", "1000");
+    QCommandLineOption traceDaysOption("trace-days", "Trace edits land in the last N days.", "n", "90");
+    parser.addOptions({outputOption, yearsOption, perWeekOption, vocabularyOption,
+                       completedOption, missedOption, restOption, seedOption,
+                       traceOption, opsOption, traceDaysOption});
+    parser.process(app);
+
+    HistoryConfig history;
+    history.years = qMax(0, parser.value(yearsOption).toInt());
+    history.sessionsPerWeek = qBound(0, parser.value(perWeekOption).toInt(), 7);
+    history.vocabulary = qMax(1, parser.value(vocabularyOption).toInt());
+    history.completedPercent = parser.value(completedOption).toInt();
+    history.missedPercent = parser.value(missedOption).toInt();
+    history.restPercent = parser.value(restOption).toInt();
+    history.seed = parser.value(seedOption).toUInt();
+
+    if (history.completedPercent + history.missedPercent + history.restPercent > 100) {
+        std::fprintf(stderr, "workout-gen: status percentages add up to more than 100\n");
+        return 1;
+    }
+
+    // Saving through StorageManager keeps the output in the current file format
+    StorageManager store;
+    fillSyntheticHistory(store, history);
+    const QString outputPath = parser.value(outputOption);
+    if (!store.saveToFile(outputPath)) {
+        std::fprintf(stderr, "workout-gen: could not write %s\n", qPrintable(outputPath));
+        return 1;
+    }
+    std::printf("%s\t%d workouts\n", qPrintable(outputPath), int(store.getAllWorkoutDates().size()));
+
+    if (parser.isSet(traceOption)) {
+        TraceConfig trace;
+        trace.operations = qMax(0, parser.value(opsOption).toInt());
+        trace.to = history.lastDay;
+        trace.from = trace.to.addDays(-qMax(1, parser.value(traceDaysOption).toInt()));
+        trace.vocabulary = history.vocabulary;
+        trace.seed = history.seed + 1;
+
+        QFile traceFile(parser.value(traceOption));
+        if (!traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "workout-gen: could not write %s\n", qPrintable(traceFile.fileName()));
+            return 1;
+        }
+        writeTrace(generateTrace(trace), traceFile);
+        std::printf("%s\t%d operations\n", qPrintable(traceFile.fileName()), trace.operations);
+    }
+
+    return 0;
+}
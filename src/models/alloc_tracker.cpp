@@ -0,0 +1,223 @@
+// alloc_tracker.cpp
+#include "alloc_tracker.h"
+
+#ifdef WORKOUT_ALLOC_TRACKING
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+
+// Counting happens inside the allocator, so nothing here may allocate:
+// tags live in a fixed table and the per-thread scope stack is plain data.
+constexpr int MaxTags = 64;
+constexpr int MaxDepth = 16;
+
+struct Slot {
+    std::atomic<const char*> tag{nullptr};
+    std::atomic<quint64> scopes{0};
+    std::atomic<quint64> allocations{0};
+    std::atomic<quint64> bytes{0};
+};
+
+Slot slots[MaxTags];
+
+thread_local int scopeStack[MaxDepth];
+thread_local int scopeDepth = 0;
+
+int slotFor(const char* tag)
+{
+    for (int i = 0; i < MaxTags; ++i) {
+        const char* current = slots[i].tag.load(std::memory_order_acquire);
+        if (current == nullptr) {
+            const char* expected = nullptr;
+            if (slots[i].tag.compare_exchange_strong(expected, tag)) {
+                return i;
+            }
+            current = expected;
+        }
+        if (current == tag || std::strcmp(current, tag) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+inline void countAllocation(std::size_t size)
+{
+    for (int i = 0; i < scopeDepth; ++i) {
+        Slot& slot = slots[scopeStack[i]];
+        slot.allocations.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+namespace AllocTracker {
+
+Scope::Scope(const char* tag)
+    : active(false)
+{
+    int slot = slotFor(tag);
+    if (slot >= 0 && scopeDepth < MaxDepth) {
+        slots[slot].scopes.fetch_add(1, std::memory_order_relaxed);
+        scopeStack[scopeDepth++] = slot;
+        active = true;
+    }
+}
+
+Scope::~Scope()
+{
+    if (active) {
+        --scopeDepth;
+    }
+}
+
+bool isEnabled()
+{
+    return true;
+}
+
+QList<TagCounters> report()
+{
+    QList<TagCounters> counters;
+    for (const Slot& slot : slots) {
+        const char* tag = slot.tag.load(std::memory_order_acquire);
+        if (tag == nullptr) break;
+
+        TagCounters entry;
+        entry.tag = QString::fromLatin1(tag);
+        entry.scopes = slot.scopes.load(std::memory_order_relaxed);
+        entry.allocations = slot.allocations.load(std::memory_order_relaxed);
+        entry.bytes = slot.bytes.load(std::memory_order_relaxed);
+        counters << entry;
+    }
+    return counters;
+}
+
+void reset()
+{
+    for (Slot& slot : slots) {
+        slot.scopes.store(0, std::memory_order_relaxed);
+        slot.allocations.store(0, std::memory_order_relaxed);
+        slot.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace AllocTracker
+
+// Qt containers allocate through malloc, so on glibc the C allocator is
+// wrapped as well; elsewhere only operator new is counted.
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size)
+{
+    countAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* ptr = __libc_malloc(size ? size : 1)) {
+        countAllocation(size);
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+#else
+void* operator new(std::size_t size)
+{
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        countAllocation(size);
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+#endif
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#else // WORKOUT_ALLOC_TRACKING
+
+namespace AllocTracker {
+
+bool isEnabled()
+{
+    return false;
+}
+
+QList<TagCounters> report()
+{
+    return {};
+}
+
+void reset()
+{
+}
+
+} // namespace AllocTracker
+
+#endif // WORKOUT_ALLOC_TRACKING
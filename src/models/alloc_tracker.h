@@ -0,0 +1,55 @@
+// alloc_tracker.h
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <QList>
+#include <QString>
+
+// Heap allocation counting per tagged operation. Only active in builds
+// configured with -DWORKOUT_ALLOC_TRACKING=ON; otherwise WT_ALLOC_SCOPE
+// compiles to nothing and report() is empty.
+//
+//     void StorageManager::saveWorkout(...)
+//     {
+//         WT_ALLOC_SCOPE("save");
+//         ...
+//     }
+//
+// Scopes nest; an allocation is counted against every scope active on the
+// allocating thread.
+namespace AllocTracker {
+
+struct TagCounters {
+    QString tag;
+    quint64 scopes = 0;       // times the scope was entered
+    quint64 allocations = 0;
+    quint64 bytes = 0;
+};
+
+bool isEnabled();
+QList<TagCounters> report();
+void reset();
+
+#ifdef WORKOUT_ALLOC_TRACKING
+class Scope {
+public:
+    explicit Scope(const char* tag);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool active;
+};
+#endif
+
+} // namespace AllocTracker
+
+#ifdef WORKOUT_ALLOC_TRACKING
+#define WT_ALLOC_SCOPE(tag) AllocTracker::Scope wtAllocScope(tag)
+#else
+#define WT_ALLOC_SCOPE(tag)
+#endif
+
+#endif // ALLOC_TRACKER_H
@@ -0,0 +1,248 @@
+// analytics.cpp
+#include "analytics.h"
+#include "record_table.h"
+#include "set_log.h"
+#include <algorithm>
+
+namespace Analytics {
+
+namespace {
+
+// Calls `visit(name, date, estimates, count)` for every exercise with logged
+// sets in [from, to], with the estimated one-rep max of each of its sets
+template <typename Visit>
+void forEachLoggedExercise(const RecordTable& records, const SetLog& sets,
+                           OneRepMaxFormula formula, const QDate& from, const QDate& to,
+                           Visit visit)
+{
+    const SetColumns window = sets.columns(from, to);
+    if (window.size == 0) {
+        return;
+    }
+
+    // One pass over the contiguous slice, then per-exercise maxima
+    QVector<float> estimates(window.size);
+    estimateOneRepMax(window.weight, window.reps, estimates.data(), window.size, formula);
+    const qsizetype base = window.weight - sets.columns().weight;
+
+    const QVector<SetLog::Range>& index = sets.index();
+    auto range = std::lower_bound(index.cbegin(), index.cend(), from,
+                                  [](const SetLog::Range& r, const QDate& date) { return r.date < date; });
+    for (; range != index.cend() && range->date <= to; ++range) {
+        const WorkoutRecord* workout = records.find(range->date);
+        if (!workout || range->exercise >= workout->exercises().size()) {
+            continue;
+        }
+        visit(workout->exercises()[range->exercise].name, range->date,
+              estimates.constData() + (range->first - base), range->count);
+    }
+}
+
+float maximum(const float* values, qsizetype count)
+{
+    float best = 0;
+    for (qsizetype i = 0; i < count; ++i) {
+        best = std::max(best, values[i]);
+    }
+    return best;
+}
+
+} // namespace
+
+void rollingSum(const float* values, float* out, qsizetype count, int window)
+{
+    if (count <= 0 || window <= 0) {
+        std::fill(out, out + std::max<qsizetype>(count, 0), 0.0f);
+        return;
+    }
+
+    // Prefix sums turn every window into one subtraction, which unlike a
+    // running sum has no dependency between iterations. Doubles keep the
+    // difference exact over years of history.
+    QVector<double> prefix(count + 1);
+    prefix[0] = 0;
+    for (qsizetype i = 0; i < count; ++i) {
+        prefix[i + 1] = prefix[i] + values[i];
+    }
+
+    const qsizetype head = std::min<qsizetype>(window, count);
+    const double* p = prefix.constData();
+    for (qsizetype i = 0; i < head; ++i) {
+        out[i] = float(p[i + 1]);
+    }
+    for (qsizetype i = head; i < count; ++i) {
+        out[i] = float(p[i + 1] - p[i + 1 - window]);
+    }
+}
+
+void acuteChronicRatio(const float* values, float* out, qsizetype count, int acuteDays, int chronicDays)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    QVector<float> chronic(count);
+    rollingSum(values, out, count, acuteDays);
+    rollingSum(values, chronic.data(), count, chronicDays);
+
+    const float scale = float(chronicDays) / float(std::max(acuteDays, 1));
+    const float* c = chronic.constData();
+    for (qsizetype i = 0; i < count; ++i) {
+        // Select instead of branching so the loop stays vectorizable
+        const float denominator = c[i] > 0 ? c[i] : 1.0f;
+        out[i] = c[i] > 0 ? out[i] * scale / denominator : 0.0f;
+    }
+}
+
+void estimateOneRepMax(const float* weight, const qint32* reps, float* out,
+                       qsizetype count, OneRepMaxFormula formula)
+{
+    if (formula == OneRepMaxFormula::Epley) {
+        for (qsizetype i = 0; i < count; ++i) {
+            const float r = float(reps[i]);
+            const float estimate = r > 1 ? weight[i] * (1.0f + r / 30.0f) : weight[i];
+            out[i] = r > 0 ? estimate : 0.0f;
+        }
+    } else {
+        for (qsizetype i = 0; i < count; ++i) {
+            // The formula diverges at 37 reps; beyond 36 it is meaningless anyway
+            const float r = std::min(float(reps[i]), 36.0f);
+            out[i] = r > 0 ? weight[i] * 36.0f / (37.0f - r) : 0.0f;
+        }
+    }
+}
+
+DailyLoad dailyLoad(const RecordTable& records, const SetLog& sets,
+                    const QDate& from, const QDate& to)
+{
+    DailyLoad load;
+    load.start = from;
+    const qsizetype days = from.daysTo(to) + 1;
+    if (days <= 0) {
+        return load;
+    }
+    load.volume.fill(0.0f, days);
+    load.tonnage.fill(0.0f, days);
+
+    // Records and set ranges are both in date order: merge them
+    const SetColumns all = sets.columns();
+    const QVector<SetLog::Range>& index = sets.index();
+    auto range = std::lower_bound(index.cbegin(), index.cend(), from,
+                                  [](const SetLog::Range& r, const QDate& date) { return r.date < date; });
+
+    for (auto entry = records.lowerBound(from); entry != records.end() && entry->date <= to; ++entry) {
+        // Planned and missed sessions were not trained; their set rows are
+        // skipped by the next entry's catch-up
+        if (entry->record.status != WorkoutStatus::Completed) {
+            continue;
+        }
+        const qsizetype day = from.daysTo(entry->date);
+        const ExerciseList& exercises = entry->record.exercises();
+        while (range != index.cend() && range->date < entry->date) {
+            ++range;
+        }
+
+        float volume = 0;
+        float tonnage = 0;
+        for (qsizetype exercise = 0; exercise < exercises.size(); ++exercise) {
+            if (range != index.cend() && range->date == entry->date && range->exercise == exercise) {
+                const qsizetype end = range->first + range->count;
+                for (qsizetype row = range->first; row < end; ++row) {
+                    volume += float(all.reps[row]);
+                    tonnage += all.weight[row] * float(all.reps[row]);
+                }
+                ++range;
+            } else {
+                volume += float(exercises[exercise].sets) * float(exercises[exercise].reps);
+            }
+        }
+        load.volume[day] = volume;
+        load.tonnage[day] = tonnage;
+    }
+    return load;
+}
+
+QVector<WeeklyTotal> weeklyTotals(const DailyLoad& load)
+{
+    QVector<WeeklyTotal> weeks;
+    for (qsizetype day = 0; day < load.size(); ++day) {
+        const QDate date = load.dateAt(day);
+        const QDate weekStart = date.addDays(1 - date.dayOfWeek());
+        if (weeks.isEmpty() || weeks.last().weekStart != weekStart) {
+            weeks.append(WeeklyTotal{weekStart, 0, 0});
+        }
+        weeks.last().volume += load.volume[day];
+        weeks.last().tonnage += load.tonnage[day];
+    }
+    return weeks;
+}
+
+AthleteSummary athleteSummary(const RecordTable& records, const SetLog& sets,
+                              const QDate& today, int weeks)
+{
+    AthleteSummary summary;
+    const QDate monday = today.addDays(1 - today.dayOfWeek());
+    for (auto entry = records.lowerBound(monday); entry != records.end() && entry->date <= today; ++entry) {
+        if (entry->record.status == WorkoutStatus::Completed) {
+            ++summary.completed;
+        } else if (entry->record.status == WorkoutStatus::Missed) {
+            ++summary.missed;
+        }
+    }
+    const int sessions = summary.completed + summary.missed;
+    summary.adherence = sessions > 0 ? float(summary.completed) / float(sessions) : 0.0f;
+
+    const QDate from = monday.addDays(-7 * qint64(std::max(weeks - 1, 0)));
+    for (const WeeklyTotal& week : weeklyTotals(dailyLoad(records, sets, from, today))) {
+        summary.weeklyVolume.append(week.volume);
+    }
+
+    // The current week is partial, so the trend starts from the one before
+    const qsizetype full = summary.weeklyVolume.size() - 1;
+    if (full >= 2) {
+        float before = 0;
+        for (qsizetype i = 0; i < full - 1; ++i) {
+            before += summary.weeklyVolume[i];
+        }
+        before /= float(full - 1);
+        if (before > 0) {
+            summary.volumeTrend = (summary.weeklyVolume[full - 1] - before) / before;
+        }
+    }
+    return summary;
+}
+
+QVector<TrendPoint> oneRepMaxTrend(const RecordTable& records, const SetLog& sets,
+                                   const QString& exercise, OneRepMaxFormula formula,
+                                   const QDate& from, const QDate& to)
+{
+    QVector<TrendPoint> trend;
+    forEachLoggedExercise(records, sets, formula, from, to,
+        [&](const QString& name, const QDate& date, const float* estimates, qsizetype count) {
+            if (name != exercise) {
+                return;
+            }
+            const float best = maximum(estimates, count);
+            if (!trend.isEmpty() && trend.last().date == date) {
+                trend.last().value = std::max(trend.last().value, best);
+            } else {
+                trend.append(TrendPoint{date, best});
+            }
+        });
+    return trend;
+}
+
+QHash<QString, float> bestOneRepMax(const RecordTable& records, const SetLog& sets,
+                                    OneRepMaxFormula formula,
+                                    const QDate& from, const QDate& to)
+{
+    QHash<QString, float> best;
+    forEachLoggedExercise(records, sets, formula, from, to,
+        [&](const QString& name, const QDate&, const float* estimates, qsizetype count) {
+            float& value = best[name];
+            value = std::max(value, maximum(estimates, count));
+        });
+    return best;
+}
+
+} // namespace Analytics
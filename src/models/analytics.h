@@ -0,0 +1,86 @@
+// analytics.h
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include <QDate>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class RecordTable;
+class SetLog;
+
+// Training-load statistics over whole histories. The kernels work on plain
+// arrays with branch-free loops so the compiler can vectorize them; the
+// helpers gather those arrays from the store.
+namespace Analytics {
+
+enum class OneRepMaxFormula {
+    Epley,    // w * (1 + reps / 30)
+    Brzycki   // w * 36 / (37 - reps)
+};
+
+// One value per calendar day from `start`, zero on days without a
+// completed workout
+struct DailyLoad {
+    QDate start;
+    QVector<float> volume;   // repetitions: set rows where logged, else sets x reps
+    QVector<float> tonnage;  // weight x reps of logged sets
+
+    qsizetype size() const { return volume.size(); }
+    QDate dateAt(qsizetype index) const { return start.addDays(index); }
+};
+
+struct WeeklyTotal {
+    QDate weekStart;  // Monday
+    float volume = 0;
+    float tonnage = 0;
+};
+
+// One athlete's current week and recent volume, for the team dashboard
+struct AthleteSummary {
+    int completed = 0;      // sessions completed this week so far
+    int missed = 0;         // sessions missed this week so far
+    float adherence = 0;    // completed / (completed + missed); 0 without sessions
+    QVector<float> weeklyVolume;  // oldest first, this (partial) week last
+    float volumeTrend = 0;  // last full week against the mean of the weeks before, as a fraction
+};
+
+struct TrendPoint {
+    QDate date;
+    float value;
+};
+
+// Sum of the last `window` values ending at each index; the first
+// window - 1 sums cover fewer days
+void rollingSum(const float* values, float* out, qsizetype count, int window);
+// Mean daily load over the acute window divided by that over the chronic
+// window, per day; zero where the chronic load is zero
+void acuteChronicRatio(const float* values, float* out, qsizetype count,
+                       int acuteDays = 7, int chronicDays = 28);
+// Estimated one-rep max of each set; zero for sets without reps
+void estimateOneRepMax(const float* weight, const qint32* reps, float* out,
+                       qsizetype count, OneRepMaxFormula formula);
+
+DailyLoad dailyLoad(const RecordTable& records, const SetLog& sets,
+                    const QDate& from, const QDate& to);
+// Totals per Monday-to-Sunday week overlapping the load's days
+QVector<WeeklyTotal> weeklyTotals(const DailyLoad& load);
+
+// Week-to-date adherence and the volume of the last `weeks` weeks up to
+// `today`, weeks starting on Monday
+AthleteSummary athleteSummary(const RecordTable& records, const SetLog& sets,
+                              const QDate& today, int weeks = 6);
+
+// Best estimated one-rep max per day on which `exercise` has logged sets
+QVector<TrendPoint> oneRepMaxTrend(const RecordTable& records, const SetLog& sets,
+                                   const QString& exercise, OneRepMaxFormula formula,
+                                   const QDate& from, const QDate& to);
+// Best estimated one-rep max in [from, to] for every exercise with logged sets
+QHash<QString, float> bestOneRepMax(const RecordTable& records, const SetLog& sets,
+                                    OneRepMaxFormula formula,
+                                    const QDate& from, const QDate& to);
+
+} // namespace Analytics
+
+#endif // ANALYTICS_H
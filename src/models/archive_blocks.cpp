@@ -0,0 +1,89 @@
+// archive_blocks.cpp
+#include "archive_blocks.h"
+#include "checksum.h"
+#include <QtEndian>
+
+namespace {
+
+const QByteArray ArchiveMagic = QByteArrayLiteral("WTARCHV1");
+const QByteArray BlockMarker = QByteArrayLiteral("WTBK");
+// Marker, size and checksum
+constexpr qsizetype BlockHeaderSize = 12;
+
+} // namespace
+
+QByteArray archiveHeader()
+{
+    return ArchiveMagic;
+}
+
+void appendArchiveBlock(QByteArray& archive, const QByteArray& json)
+{
+    const QByteArray compressed = qCompress(json, 9);
+    uchar header[8];
+    qToBigEndian(quint32(compressed.size()), header);
+    qToBigEndian(crc32c(compressed), header + 4);
+    archive += BlockMarker;
+    archive.append(reinterpret_cast<const char*>(header), sizeof(header));
+    archive += compressed;
+}
+
+QVector<ArchiveBlock> readArchiveBlocks(const QByteArray& archive)
+{
+    QVector<ArchiveBlock> blocks;
+    if (!archive.startsWith(ArchiveMagic)) {
+        ArchiveBlock block;
+        block.end = archive.size();
+        block.json = qUncompress(archive);
+        if (block.json.isEmpty()) {
+            block.error = QStringLiteral("not a compressed archive");
+        }
+        blocks.append(block);
+        return blocks;
+    }
+
+    qsizetype pos = ArchiveMagic.size();
+    while (pos < archive.size()) {
+        ArchiveBlock block;
+        block.begin = pos;
+        const qsizetype marker = archive.indexOf(BlockMarker, pos);
+        if (marker != pos) {
+            // Garbage up to the next marker, or to the end of the file
+            block.end = marker < 0 ? archive.size() : marker;
+            block.error = QStringLiteral("no block marker");
+            blocks.append(block);
+            pos = block.end;
+            continue;
+        }
+
+        const auto* header = reinterpret_cast<const uchar*>(archive.constData() + pos + BlockMarker.size());
+        const qsizetype size = pos + BlockHeaderSize <= archive.size() ? qFromBigEndian<quint32>(header) : -1;
+        const qsizetype payload = pos + BlockHeaderSize;
+        if (size < 0 || payload + size > archive.size()) {
+            // The size is wrong or the file is cut short: resume at the next marker
+            const qsizetype next = archive.indexOf(BlockMarker, pos + BlockMarker.size());
+            block.end = next < 0 ? archive.size() : next;
+            block.error = QStringLiteral("block size out of range");
+            blocks.append(block);
+            pos = block.end;
+            continue;
+        }
+
+        block.end = payload + size;
+        const QByteArrayView compressed(archive.constData() + payload, size);
+        if (crc32c(compressed) != qFromBigEndian<quint32>(header + 4)) {
+            // The size may be the damaged part, so it is not trusted either
+            const qsizetype next = archive.indexOf(BlockMarker, pos + BlockMarker.size());
+            block.end = next < 0 ? archive.size() : next;
+            block.error = QStringLiteral("block checksum mismatch");
+        } else {
+            block.json = qUncompress(reinterpret_cast<const uchar*>(compressed.data()), size);
+            if (block.json.isEmpty()) {
+                block.error = QStringLiteral("block does not decompress");
+            }
+        }
+        blocks.append(block);
+        pos = block.end;
+    }
+    return blocks;
+}
@@ -0,0 +1,48 @@
+// archive_blocks.h
+#ifndef ARCHIVE_BLOCKS_H
+#define ARCHIVE_BLOCKS_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QVector>
+
+// Year archives are split into blocks of up to ArchiveBlockDays days. Each
+// block is a complete data document, compressed on its own and preceded by
+// a marker, its size and a CRC-32C of its compressed bytes:
+//
+//   "WTARCHV1" { "WTBK" size:u32 crc:u32 qCompress(json) }...
+//
+// Damage then costs only the blocks it touches: a bad checksum skips one
+// block, and a mangled size is stepped over by searching for the next
+// marker. Archives written before blocks are one compressed document and
+// read as a single block.
+constexpr int ArchiveBlockDays = 128;
+
+struct ArchiveBlock {
+    // Byte range in the archive file
+    qsizetype begin = 0;
+    qsizetype end = 0;
+    // Uncompressed document; empty when the block is damaged
+    QByteArray json;
+    QString error;
+
+    bool isIntact() const { return error.isEmpty(); }
+};
+
+// What the data file records of each of its archives, so a lost, stale or
+// swapped archive is noticed instead of silently changing the history
+struct ArchiveStamp {
+    quint32 crc = 0;  // CRC-32C of the whole file
+    qint64 size = 0;  // 0 when not recorded (data files from before stamps)
+    // When this process last read or wrote the file; not saved, only spares
+    // re-reading an archive nothing has touched
+    QDateTime modified;
+};
+
+QByteArray archiveHeader();
+void appendArchiveBlock(QByteArray& archive, const QByteArray& json);
+// Every block in file order, intact or not
+QVector<ArchiveBlock> readArchiveBlocks(const QByteArray& archive);
+
+#endif // ARCHIVE_BLOCKS_H
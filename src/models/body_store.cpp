@@ -0,0 +1,79 @@
+// body_store.cpp
+#include "body_store.h"
+#include "string_pool.h"
+
+WorkoutBodyPtr BodyStore::find(const WorkoutBody& body, size_t hash) const
+{
+    const auto candidates = bodies.equal_range(hash);
+    for (auto it = candidates.first; it != candidates.second; ++it) {
+        if (**it == body) {
+            return *it;
+        }
+    }
+    return nullptr;
+}
+
+WorkoutBodyPtr BodyStore::intern(const WorkoutBody& body, StringPool& strings)
+{
+    if (body.isEmpty()) {
+        return nullptr;
+    }
+    const size_t hash = qHash(body);
+    if (WorkoutBodyPtr existing = find(body, hash)) {
+        return existing;
+    }
+    return insert(WorkoutBody(body), hash, strings);
+}
+
+WorkoutBodyPtr BodyStore::intern(WorkoutBody&& body, StringPool& strings)
+{
+    if (body.isEmpty()) {
+        return nullptr;
+    }
+    const size_t hash = qHash(body);
+    if (WorkoutBodyPtr existing = find(body, hash)) {
+        return existing;
+    }
+    return insert(std::move(body), hash, strings);
+}
+
+WorkoutBodyPtr BodyStore::insert(WorkoutBody&& body, size_t hash, StringPool& strings)
+{
+    // The body keeps its own lists; only its strings are swapped for the
+    // pooled copies
+    body.name = strings.intern(body.name);
+    body.description = strings.intern(body.description);
+    for (Exercise& exercise : body.exercises) {
+        exercise.name = strings.intern(exercise.name);
+    }
+
+    WorkoutBodyPtr result = std::make_shared<const WorkoutBody>(std::move(body));
+    bodies.insert(hash, result);
+    return result;
+}
+
+WorkoutBodyPtr BodyStore::intern(const WorkoutBodyPtr& body, StringPool& strings)
+{
+    return body ? intern(*body, strings) : nullptr;
+}
+
+void BodyStore::prune()
+{
+    bodies.removeIf([](QMultiHash<size_t, WorkoutBodyPtr>::iterator it) {
+        return it.value().use_count() == 1;
+    });
+}
+
+qsizetype BodyStore::memoryUsage() const
+{
+    // make_shared puts the reference counts in the body's own block
+    constexpr qsizetype ControlBlockBytes = 2 * qsizetype(sizeof(long));
+    qsizetype bytes = bodies.capacity() * qsizetype(sizeof(size_t) + sizeof(WorkoutBodyPtr));
+    for (const WorkoutBodyPtr& body : bodies) {
+        bytes += ContainerNodeBytes + qsizetype(sizeof(WorkoutBody)) + ControlBlockBytes;
+        if (body->exercises.capacity() > InlineExerciseCount) {
+            bytes += body->exercises.capacity() * qsizetype(sizeof(Exercise));
+        }
+    }
+    return bytes;
+}
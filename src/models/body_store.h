@@ -0,0 +1,36 @@
+// body_store.h
+#ifndef BODY_STORE_H
+#define BODY_STORE_H
+
+#include <QMultiHash>
+#include "types.h"
+
+class StringPool;
+
+// Content-addressed set of workout bodies: each distinct body is stored once
+// and found again by hashing its name, description and exercises.
+class BodyStore {
+public:
+    // The stored body equal to `body`, adding it if new. Empty bodies map to
+    // null. Strings of new bodies are interned in `strings`.
+    WorkoutBodyPtr intern(const WorkoutBody& body, StringPool& strings);
+    // Moves a new body into the store instead of copying it
+    WorkoutBodyPtr intern(WorkoutBody&& body, StringPool& strings);
+    WorkoutBodyPtr intern(const WorkoutBodyPtr& body, StringPool& strings);
+
+    // Forgets bodies that no record refers to any more
+    void prune();
+    void clear() { bodies.clear(); }
+    qsizetype size() const { return bodies.size(); }
+    // Heap bytes of the bodies and their exercise lists; their strings are
+    // counted by the pool
+    qsizetype memoryUsage() const;
+
+private:
+    WorkoutBodyPtr find(const WorkoutBody& body, size_t hash) const;
+    WorkoutBodyPtr insert(WorkoutBody&& body, size_t hash, StringPool& strings);
+
+    QMultiHash<size_t, WorkoutBodyPtr> bodies;
+};
+
+#endif // BODY_STORE_H
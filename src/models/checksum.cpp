@@ -0,0 +1,110 @@
+// checksum.cpp
+#include "checksum.h"
+#include <QByteArray>
+#include <QtEndian>
+#if defined(__SSE4_2__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace {
+
+#if !(defined(__SSE4_2__) && defined(__x86_64__))
+// Table k advances the CRC by one byte followed by k zero bytes, so eight
+// lookups consume eight bytes with no dependency between them
+struct SliceTables {
+    quint32 table[8][256];
+
+    SliceTables()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+            }
+            table[0][i] = crc;
+        }
+        for (int i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+const SliceTables& sliceTables()
+{
+    static const SliceTables tables;
+    return tables;
+}
+#endif
+
+void appendText(QByteArray& bytes, const QString& text)
+{
+    bytes += text.toUtf8();
+    bytes += '\0';
+}
+
+void appendInt(QByteArray& bytes, qint32 value)
+{
+    char buffer[4];
+    qToLittleEndian(value, buffer);
+    bytes.append(buffer, 4);
+}
+
+} // namespace
+
+quint32 crc32c(QByteArrayView data, quint32 crc)
+{
+    const uchar* p = reinterpret_cast<const uchar*>(data.data());
+    qsizetype n = data.size();
+#if defined(__SSE4_2__) && defined(__x86_64__)
+    quint64 wide = ~crc;
+    for (; n >= 8; p += 8, n -= 8) {
+        wide = _mm_crc32_u64(wide, qFromUnaligned<quint64>(p));
+    }
+    quint32 value = quint32(wide);
+    while (n-- > 0) {
+        value = _mm_crc32_u8(value, *p++);
+    }
+    return ~value;
+#else
+    const auto& t = sliceTables().table;
+    quint32 value = ~crc;
+    for (; n >= 8; p += 8, n -= 8) {
+        const quint32 low = qFromLittleEndian<quint32>(p) ^ value;
+        const quint32 high = qFromLittleEndian<quint32>(p + 4);
+        value = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+              ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    while (n-- > 0) {
+        value = (value >> 8) ^ t[0][(value ^ *p++) & 0xFF];
+    }
+    return ~value;
+#endif
+}
+
+quint32 bodyChecksum(const WorkoutBody* body)
+{
+    static const WorkoutBody empty;
+    const WorkoutBody& content = body ? *body : empty;
+
+    QByteArray bytes;
+    appendText(bytes, content.name);
+    appendText(bytes, content.description);
+    appendInt(bytes, qint32(content.exercises.size()));
+    for (const Exercise& exercise : content.exercises) {
+        appendText(bytes, exercise.name);
+        appendInt(bytes, exercise.sets);
+        appendInt(bytes, exercise.reps);
+    }
+    return crc32c(bytes);
+}
+
+quint32 recordChecksum(const QDate& date, WorkoutStatus status, quint32 bodySum)
+{
+    char bytes[16];
+    qToLittleEndian<qint64>(date.toJulianDay(), bytes);
+    qToLittleEndian<qint32>(static_cast<int>(status), bytes + 8);
+    qToLittleEndian<quint32>(bodySum, bytes + 12);
+    return crc32c(QByteArrayView(bytes, sizeof(bytes)));
+}
@@ -0,0 +1,20 @@
+// checksum.h
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <QByteArrayView>
+#include <QDate>
+#include "types.h"
+#include "workout_status.h"
+
+// CRC-32C (Castagnoli). Uses the SSE4.2 instruction when the build targets
+// it and slice-by-8 tables otherwise. Pass a previous result as `crc` to
+// continue it over more data.
+quint32 crc32c(QByteArrayView data, quint32 crc = 0);
+
+// Checksums of what a record holds rather than how a file spells it, so
+// they survive reformatting. A null body counts as empty.
+quint32 bodyChecksum(const WorkoutBody* body);
+quint32 recordChecksum(const QDate& date, WorkoutStatus status, quint32 bodySum);
+
+#endif // CHECKSUM_H
@@ -0,0 +1,193 @@
+// exercise_name_index.cpp
+#include "exercise_name_index.h"
+#include "types.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Names kept per node; completions beyond this are not offered
+constexpr int TopCount = 16;
+
+QString keyOf(const QString& name)
+{
+    return name.simplified().toCaseFolded();
+}
+
+} // namespace
+
+void ExerciseNameIndex::clear()
+{
+    nodes.clear();
+    entries.clear();
+}
+
+int ExerciseNameIndex::child(int node, char16_t c) const
+{
+    const auto& children = nodes[node].children;
+    auto it = std::lower_bound(children.cbegin(), children.cend(), c,
+                               [](const QPair<char16_t, int>& item, char16_t value) { return item.first < value; });
+    return it != children.cend() && it->first == c ? it->second : -1;
+}
+
+int ExerciseNameIndex::findNode(const QString& key) const
+{
+    if (nodes.isEmpty()) {
+        return -1;
+    }
+    int node = 0;
+    for (QChar c : key) {
+        node = child(node, c.unicode());
+        if (node < 0) {
+            return -1;
+        }
+    }
+    return node;
+}
+
+void ExerciseNameIndex::updateEntry(Entry& entry)
+{
+    // Doubling the use count is worth as much as being used 90 days later.
+    // The score depends on dates only, so the order does not drift with the
+    // clock and cached rankings stay valid.
+    entry.score = entry.count > 0
+        ? std::log2(1.0 + entry.count) + double(entry.lastUsed.toJulianDay()) / 90.0
+        : 0;
+
+    entry.display.clear();
+    int best = 0;
+    for (auto it = entry.spellings.cbegin(); it != entry.spellings.cend(); ++it) {
+        if (it.value() > best || (it.value() == best && it.key() < entry.display)) {
+            best = it.value();
+            entry.display = it.key();
+        }
+    }
+}
+
+void ExerciseNameIndex::add(const QString& name, const QDate& date)
+{
+    const QString key = keyOf(name);
+    if (key.isEmpty()) {
+        return;
+    }
+
+    if (nodes.isEmpty()) {
+        nodes.append(Node());
+    }
+    int node = 0;
+    nodes[node].stale = true;
+    for (QChar c : key) {
+        int next = child(node, c.unicode());
+        if (next < 0) {
+            next = int(nodes.size());
+            nodes.append(Node());
+            auto& children = nodes[node].children;
+            auto it = std::lower_bound(children.begin(), children.end(), c.unicode(),
+                                       [](const QPair<char16_t, int>& item, char16_t value) { return item.first < value; });
+            children.insert(it, qMakePair(char16_t(c.unicode()), next));
+        }
+        node = next;
+        nodes[node].stale = true;
+    }
+
+    if (nodes[node].entry < 0) {
+        nodes[node].entry = int(entries.size());
+        entries.append(Entry());
+    }
+    Entry& entry = entries[nodes[node].entry];
+    ++entry.spellings[name.simplified()];
+    ++entry.count;
+    if (!entry.lastUsed.isValid() || date > entry.lastUsed) {
+        entry.lastUsed = date;
+    }
+    updateEntry(entry);
+}
+
+void ExerciseNameIndex::remove(const QString& name)
+{
+    const QString key = keyOf(name);
+    const int node = findNode(key);
+    if (key.isEmpty() || node < 0 || nodes[node].entry < 0) {
+        return;
+    }
+
+    Entry& entry = entries[nodes[node].entry];
+    auto spelling = entry.spellings.find(name.simplified());
+    if (spelling == entry.spellings.end()) {
+        return;
+    }
+    if (--spelling.value() == 0) {
+        entry.spellings.erase(spelling);
+    }
+    --entry.count;
+    updateEntry(entry);
+
+    // Mark the path stale; the last use date is kept, as it is only a hint
+    int current = 0;
+    nodes[current].stale = true;
+    for (QChar c : key) {
+        current = child(current, c.unicode());
+        nodes[current].stale = true;
+    }
+}
+
+const QVector<int>& ExerciseNameIndex::topOf(int node) const
+{
+    Node& current = nodes[node];
+    if (!current.stale) {
+        return current.top;
+    }
+
+    // The best names below a node are among its own entry and the best
+    // names of each child
+    QVector<int> candidates;
+    if (current.entry >= 0 && entries[current.entry].count > 0) {
+        candidates.append(current.entry);
+    }
+    for (const auto& item : nodes[node].children) {
+        candidates += topOf(item.second);
+    }
+    auto better = [this](int a, int b) {
+        const Entry& x = entries[a];
+        const Entry& y = entries[b];
+        return x.score != y.score ? x.score > y.score : x.display < y.display;
+    };
+    const qsizetype keep = std::min<qsizetype>(TopCount, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), better);
+    candidates.resize(keep);
+
+    current.top = std::move(candidates);
+    current.stale = false;
+    return current.top;
+}
+
+QStringList ExerciseNameIndex::complete(const QString& prefix, int limit) const
+{
+    QStringList names;
+    const int node = findNode(keyOf(prefix));
+    if (node < 0) {
+        return names;
+    }
+
+    const QVector<int>& top = topOf(node);
+    for (qsizetype i = 0; i < top.size() && names.size() < limit; ++i) {
+        names.append(entries[top[i]].display);
+    }
+    return names;
+}
+
+qsizetype ExerciseNameIndex::memoryUsage() const
+{
+    qsizetype bytes = nodes.capacity() * qsizetype(sizeof(Node)) + entries.capacity() * qsizetype(sizeof(Entry));
+    for (const Node& node : nodes) {
+        bytes += node.top.capacity() * qsizetype(sizeof(int));
+        if (node.children.capacity() > 4) {
+            bytes += node.children.capacity() * qsizetype(sizeof(QPair<char16_t, int>));
+        }
+    }
+    for (const Entry& entry : entries) {
+        bytes += entry.spellings.capacity() * qsizetype(sizeof(QString) + sizeof(int))
+               + entry.spellings.size() * ContainerNodeBytes;
+    }
+    return bytes;
+}
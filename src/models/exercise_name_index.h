@@ -0,0 +1,60 @@
+// exercise_name_index.h
+#ifndef EXERCISE_NAME_INDEX_H
+#define EXERCISE_NAME_INDEX_H
+
+#include <QDate>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVarLengthArray>
+#include <QVector>
+
+// Prefix completion for exercise names. Names are matched case-insensitively
+// in a trie and offered in their most common spelling, so "bench Press"
+// completes to the "Bench press" used everywhere else.
+//
+// Each trie node caches its best-ranked names, so a lookup walks the prefix
+// and returns that cache. Changes only mark the nodes on their path stale;
+// a stale node is rebuilt from its children's caches on the next lookup.
+class ExerciseNameIndex {
+public:
+    // One more (or one fewer) day on which `name` was used
+    void add(const QString& name, const QDate& date);
+    void remove(const QString& name);
+    void clear();
+
+    // Up to `limit` names starting with `prefix`, best first. Ranking favours
+    // names used often and recently.
+    QStringList complete(const QString& prefix, int limit = 10) const;
+    qsizetype size() const { return entries.size(); }
+    // Trie, caches and entries; names are counted by the string pool
+    qsizetype memoryUsage() const;
+
+private:
+    struct Entry {
+        QHash<QString, int> spellings;
+        QString display;
+        int count = 0;
+        QDate lastUsed;
+        double score = 0;
+    };
+
+    struct Node {
+        QVarLengthArray<QPair<char16_t, int>, 4> children;  // Sorted by character
+        int entry = -1;
+        QVector<int> top;  // Best entries below this node
+        bool stale = true;
+    };
+
+    int child(int node, char16_t c) const;
+    int findNode(const QString& key) const;
+    void updateEntry(Entry& entry);
+    const QVector<int>& topOf(int node) const;
+
+    // The caches are filled in lazily by const lookups
+    mutable QVector<Node> nodes;
+    QVector<Entry> entries;
+};
+
+#endif // EXERCISE_NAME_INDEX_H
@@ -0,0 +1,165 @@
+// personal_records.cpp
+#include "personal_records.h"
+#include "set_log.h"
+#include <algorithm>
+
+QVector<PersonalRecordIndex::DayBest> PersonalRecordIndex::dayBests(const QDate& date,
+                                                                    const WorkoutRecord& workout,
+                                                                    const SetLog& sets)
+{
+    QVector<DayBest> bests;
+    if (workout.status == WorkoutStatus::Missed) {
+        return bests;
+    }
+
+    const ExerciseList& exercises = workout.exercises();
+    for (qsizetype i = 0; i < exercises.size(); ++i) {
+        const Exercise& exercise = exercises[i];
+        if (exercise.name.isEmpty()) {
+            continue;
+        }
+
+        DayBest best;
+        best.exercise = exercise.name;
+        const QVector<SetEntry> rows = sets.sets(date, int(i));
+        if (rows.isEmpty()) {
+            best.values[int(RecordMetric::Reps)] = float(exercise.reps);
+            best.values[int(RecordMetric::Volume)] = float(exercise.sets) * float(exercise.reps);
+        } else {
+            for (const SetEntry& row : rows) {
+                float& reps = best.values[int(RecordMetric::Reps)];
+                float& weight = best.values[int(RecordMetric::Weight)];
+                reps = std::max(reps, float(row.reps));
+                weight = std::max(weight, row.weight);
+                best.values[int(RecordMetric::Volume)] += float(row.reps);
+            }
+        }
+
+        // The same exercise twice in a day counts once, with its best values
+        auto same = std::find_if(bests.begin(), bests.end(), [&](const DayBest& other) {
+            return other.exercise == best.exercise;
+        });
+        if (same == bests.end()) {
+            bests.append(best);
+        } else {
+            for (int m = 0; m < RecordMetricCount; ++m) {
+                same->values[m] = std::max(same->values[m], best.values[m]);
+            }
+        }
+    }
+    return bests;
+}
+
+void PersonalRecordIndex::add(const QDate& date, const QVector<DayBest>& bests,
+                              QVector<PersonalRecord>* newRecords,
+                              const QVector<DayBest>& replaced)
+{
+    for (const DayBest& best : bests) {
+        auto before = std::find_if(replaced.cbegin(), replaced.cend(), [&](const DayBest& old) {
+            return old.exercise == best.exercise;
+        });
+        auto& exerciseSeries = series[best.exercise];
+        for (int m = 0; m < RecordMetricCount; ++m) {
+            const float value = best.values[m];
+            if (value <= 0) {
+                continue;
+            }
+            Series& metric = exerciseSeries[m];
+            const float previous = metric.byValue.empty() ? 0 : metric.byValue.rbegin()->first;
+            // Saving a record day again does not set the record again
+            const float held = before == replaced.cend() ? 0 : before->values[m];
+            if (newRecords && previous > 0 && value > previous && value > held) {
+                newRecords->append(PersonalRecord{best.exercise, RecordMetric(m), value, date, previous});
+            }
+            metric.byValue.emplace(value, date);
+            metric.byDate.insert(date, value);
+        }
+    }
+}
+
+void PersonalRecordIndex::remove(const QDate& date, const QVector<DayBest>& bests)
+{
+    for (const DayBest& best : bests) {
+        auto it = series.find(best.exercise);
+        if (it == series.end()) {
+            continue;
+        }
+        for (int m = 0; m < RecordMetricCount; ++m) {
+            const float value = best.values[m];
+            if (value <= 0) {
+                continue;
+            }
+            Series& metric = (*it)[m];
+            auto range = metric.byValue.equal_range(value);
+            auto entry = std::find_if(range.first, range.second, [&](const auto& item) {
+                return item.second == date;
+            });
+            if (entry != range.second) {
+                metric.byValue.erase(entry);
+            }
+            metric.byDate.remove(date);
+        }
+
+        const bool empty = std::all_of(it->cbegin(), it->cend(), [](const Series& metric) {
+            return metric.byValue.empty();
+        });
+        if (empty) {
+            series.erase(it);
+        }
+    }
+}
+
+float PersonalRecordIndex::best(const QString& exercise, RecordMetric metric) const
+{
+    auto it = series.constFind(exercise);
+    if (it == series.cend()) {
+        return 0;
+    }
+    const Series& values = (*it)[int(metric)];
+    return values.byValue.empty() ? 0 : values.byValue.rbegin()->first;
+}
+
+QStringList PersonalRecordIndex::exercises() const
+{
+    QStringList names = series.keys();
+    names.sort(Qt::CaseInsensitive);
+    return names;
+}
+
+QVector<PersonalRecord> PersonalRecordIndex::history(const QString& exercise) const
+{
+    QVector<PersonalRecord> records;
+    auto it = series.constFind(exercise);
+    if (it == series.cend()) {
+        return records;
+    }
+
+    for (int m = 0; m < RecordMetricCount; ++m) {
+        const Series& metric = (*it)[m];
+        float best = 0;
+        for (auto day = metric.byDate.cbegin(); day != metric.byDate.cend(); ++day) {
+            if (day.value() > best) {
+                records.append(PersonalRecord{exercise, RecordMetric(m), day.value(), day.key(), best});
+                best = day.value();
+            }
+        }
+    }
+    std::stable_sort(records.begin(), records.end(), [](const PersonalRecord& a, const PersonalRecord& b) {
+        return a.date < b.date;
+    });
+    return records;
+}
+
+qsizetype PersonalRecordIndex::memoryUsage() const
+{
+    using Metrics = std::array<Series, RecordMetricCount>;
+    qsizetype bytes = series.capacity() * qsizetype(sizeof(QString) + sizeof(Metrics));
+    for (const Metrics& metrics : series) {
+        bytes += ContainerNodeBytes;
+        for (const Series& metric : metrics) {
+            bytes += qsizetype(metric.byValue.size()) * (ContainerNodeBytes + qsizetype(sizeof(float) + sizeof(QDate)))
+                   + metric.byDate.size() * (ContainerNodeBytes + qsizetype(sizeof(QDate) + sizeof(float)));
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,85 @@
+// personal_records.h
+#ifndef PERSONAL_RECORDS_H
+#define PERSONAL_RECORDS_H
+
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <array>
+#include <map>
+#include "types.h"
+
+class SetLog;
+
+enum class RecordMetric {
+    Reps,    // most reps in one set
+    Volume,  // sets x reps, or the reps of all logged sets
+    Weight   // heaviest logged set
+};
+constexpr int RecordMetricCount = 3;
+
+inline QString recordMetricName(RecordMetric metric)
+{
+    switch (metric) {
+        case RecordMetric::Reps:
+            return QStringLiteral("reps");
+        case RecordMetric::Volume:
+            return QStringLiteral("volume");
+        default:
+            return QStringLiteral("weight");
+    }
+}
+
+struct PersonalRecord {
+    QString exercise;
+    RecordMetric metric;
+    float value;
+    QDate date;
+    float previous;  // Best before this one; 0 for the first entry
+};
+
+// Best values per exercise and metric, maintained as days are added and
+// removed so that checking a save for new records never rescans history.
+// Every exercise keeps its values ordered by size (for the current best,
+// including after a past record is edited away) and by date (for the
+// record history).
+class PersonalRecordIndex {
+public:
+    // What one day contributes for one exercise
+    struct DayBest {
+        QString exercise;
+        std::array<float, RecordMetricCount> values{};
+    };
+    // Contributions of a stored day; missed workouts contribute nothing
+    static QVector<DayBest> dayBests(const QDate& date, const WorkoutRecord& workout, const SetLog& sets);
+
+    // Adds a day's contributions. Values that beat an earlier best of the
+    // same exercise are appended to `newRecords`, unless the day already
+    // held at least that value before the change (`replaced`, as returned
+    // by the remove() that preceded this call).
+    void add(const QDate& date, const QVector<DayBest>& bests,
+             QVector<PersonalRecord>* newRecords = nullptr,
+             const QVector<DayBest>& replaced = {});
+    // Removes exactly what add() added for the day
+    void remove(const QDate& date, const QVector<DayBest>& bests);
+    void clear() { series.clear(); }
+    qsizetype memoryUsage() const;
+
+    // 0 if the exercise has no value for the metric
+    float best(const QString& exercise, RecordMetric metric) const;
+    QStringList exercises() const;
+    // Days that set a new best, in date order
+    QVector<PersonalRecord> history(const QString& exercise) const;
+
+private:
+    struct Series {
+        std::multimap<float, QDate> byValue;
+        QMap<QDate, float> byDate;
+    };
+    QHash<QString, std::array<Series, RecordMetricCount>> series;
+};
+
+#endif // PERSONAL_RECORDS_H
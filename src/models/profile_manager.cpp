@@ -0,0 +1,126 @@
+// profile_manager.cpp
+#include "profile_manager.h"
+#include "storage_manager.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+
+const QString ProfileManager::DefaultProfile = QStringLiteral("Default");
+
+ProfileManager::ProfileManager(StorageManager& active, QObject* parent)
+    : QObject(parent)
+    , active(active)
+    , defaultFilePath(active.filePath())
+{
+}
+
+QString ProfileManager::profilesDirectory() const
+{
+    return QFileInfo(defaultFilePath).absoluteDir().filePath(QStringLiteral("profiles"));
+}
+
+QString ProfileManager::filePathFor(const QString& name) const
+{
+    if (name == DefaultProfile) {
+        return defaultFilePath;
+    }
+    return QDir(profilesDirectory()).filePath(name + QStringLiteral("/workouts.json"));
+}
+
+QStringList ProfileManager::profiles() const
+{
+    QStringList names = QDir(profilesDirectory()).entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    names.removeAll(DefaultProfile);
+    names.prepend(DefaultProfile);
+    return names;
+}
+
+bool ProfileManager::isValidName(const QString& name)
+{
+    static const QString forbidden = QStringLiteral("/\\:*?\"<>|");
+    return !name.trimmed().isEmpty() && name == name.trimmed() && !name.startsWith(QLatin1Char('.'))
+        && std::none_of(name.cbegin(), name.cend(), [](QChar c) { return forbidden.contains(c); });
+}
+
+bool ProfileManager::isCached(const QString& name) const
+{
+    return std::any_of(parked.cbegin(), parked.cend(), [&](const Parked& entry) { return entry.name == name; });
+}
+
+bool ProfileManager::createProfile(const QString& name)
+{
+    if (!isValidName(name) || profiles().contains(name)) {
+        return false;
+    }
+    return QDir().mkpath(QFileInfo(filePathFor(name)).absolutePath());
+}
+
+bool ProfileManager::switchTo(const QString& name)
+{
+    if (name == current) {
+        return true;
+    }
+    if (active.isInTransaction() || !profiles().contains(name)) {
+        return false;
+    }
+
+    std::unique_ptr<StorageManager> store;
+    auto hot = std::find_if(parked.begin(), parked.end(), [&](const Parked& entry) { return entry.name == name; });
+    if (hot != parked.end()) {
+        store = std::move(hot->store);
+        parked.erase(hot);
+    } else {
+        store = std::make_unique<StorageManager>();
+        store->setSalvageDamaged(active.isSalvagingDamaged());
+        if (!store->loadFromFile(filePathFor(name))) {
+            qWarning() << "Could not load profile" << name;
+            return false;
+        }
+    }
+
+    // Unsaved edits of the outgoing profile travel with it into the cache
+    // and are saved if it is evicted
+    active.swapContents(*store);
+    const qsizetype bytes = store->memoryUsage();
+    parked.push_front(Parked{current, std::move(store), bytes});
+    current = name;
+    evict();
+
+    emit profileChanged(current);
+    return true;
+}
+
+void ProfileManager::setCacheBudget(qsizetype bytes)
+{
+    budget = bytes;
+    evict();
+}
+
+qsizetype ProfileManager::cachedBytes() const
+{
+    qsizetype total = 0;
+    for (const Parked& entry : parked) {
+        total += entry.bytes;
+    }
+    return total;
+}
+
+void ProfileManager::evict()
+{
+    // The most recent profile stays even over budget, so switching back
+    // and forth between two large ones never re-parses
+    qsizetype total = cachedBytes();
+    while (parked.size() > 1 && total > budget) {
+        Parked& oldest = parked.back();
+        // Unsaved edits are never dropped: a profile that fails to save
+        // stays parked, over budget, until a later eviction saves it
+        if (oldest.store->isModified() && !oldest.store->saveToFile()) {
+            qWarning() << "Could not save profile" << oldest.name << "- keeping it in memory";
+            emit saveFailed(oldest.name);
+            return;
+        }
+        total -= oldest.bytes;
+        parked.pop_back();
+    }
+}
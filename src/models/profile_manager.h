@@ -0,0 +1,69 @@
+// profile_manager.h
+#ifndef PROFILE_MANAGER_H
+#define PROFILE_MANAGER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <list>
+#include <memory>
+
+class StorageManager;
+
+// Named profiles, one data file each, for coaches tracking several
+// athletes. The active profile lives in the application store, so every
+// view keeps working against StorageManager::instance(). Profiles switched
+// away from are parked, still parsed and indexed, in a least-recently-used
+// cache bounded by memory; switching back swaps them in without reading
+// the file. Profiles outside the cache are loaded when first opened.
+//
+// The default profile is the store's own file; others are kept in
+// "profiles/<name>/workouts.json" next to it.
+class ProfileManager : public QObject {
+    Q_OBJECT
+public:
+    static const QString DefaultProfile;
+
+    explicit ProfileManager(StorageManager& active, QObject* parent = nullptr);
+
+    QStringList profiles() const;
+    QString currentProfile() const { return current; }
+    bool isCached(const QString& name) const;
+    // Data file of a profile, whether or not it exists yet
+    QString filePathFor(const QString& name) const;
+    static bool isValidName(const QString& name);
+
+    // Creates an empty profile; false if the name is taken or invalid
+    bool createProfile(const QString& name);
+    // Makes `name` the active profile; false if it cannot be loaded
+    bool switchTo(const QString& name);
+
+    void setCacheBudget(qsizetype bytes);
+    qsizetype cacheBudget() const { return budget; }
+    qsizetype cachedBytes() const;
+
+signals:
+    // The application store now holds `name`; views should reload
+    void profileChanged(const QString& name);
+    // A parked profile with unsaved edits could not be saved on eviction;
+    // it stays in the cache
+    void saveFailed(const QString& name);
+
+private:
+    struct Parked {
+        QString name;
+        std::unique_ptr<StorageManager> store;
+        qsizetype bytes;
+    };
+
+    QString profilesDirectory() const;
+    void evict();
+
+    StorageManager& active;
+    QString defaultFilePath;
+    QString current = DefaultProfile;
+    std::list<Parked> parked;  // Most recently used first
+    qsizetype budget = 64 * 1024 * 1024;
+};
+
+#endif // PROFILE_MANAGER_H
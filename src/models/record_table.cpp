@@ -0,0 +1,142 @@
+// record_table.cpp
+#include "record_table.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+bool earlierThan(const DatedRecord& entry, const QDate& date)
+{
+    return entry.date < date;
+}
+
+} // namespace
+
+RecordTable::RecordTable()
+    : snapshot(std::make_unique<Snapshot>())
+{
+}
+
+RecordTable::RecordTable(RecordTable&& other)
+    : RecordTable()
+{
+    swap(other);
+}
+
+RecordTable& RecordTable::operator=(RecordTable&& other) noexcept
+{
+    // `other` keeps this table's old records until it is cleared or dies
+    swap(other);
+    return *this;
+}
+
+void RecordTable::clear()
+{
+    // Drops the records and the arena holding them in one step
+    snapshot = std::make_unique<Snapshot>();
+}
+
+RecordTable::const_iterator RecordTable::lowerBound(const QDate& date) const
+{
+    return std::lower_bound(begin(), end(), date, earlierThan);
+}
+
+std::pmr::vector<DatedRecord>::iterator RecordTable::mutableLowerBound(const QDate& date)
+{
+    auto& records = snapshot->records;
+    return std::lower_bound(records.begin(), records.end(), date, earlierThan);
+}
+
+const WorkoutRecord* RecordTable::find(const QDate& date) const
+{
+    auto it = lowerBound(date);
+    return it != end() && it->date == date ? &it->record : nullptr;
+}
+
+WorkoutRecord* RecordTable::find(const QDate& date)
+{
+    auto it = mutableLowerBound(date);
+    return it != snapshot->records.end() && it->date == date ? &it->record : nullptr;
+}
+
+WorkoutRecord& RecordTable::operator[](const QDate& date)
+{
+    auto& records = snapshot->records;
+    if (records.empty() || records.back().date < date) {
+        return records.emplace_back(DatedRecord{date, WorkoutRecord()}).record;
+    }
+
+    auto it = mutableLowerBound(date);
+    if (it == records.end() || it->date != date) {
+        it = records.insert(it, DatedRecord{date, WorkoutRecord()});
+    }
+    return it->record;
+}
+
+void RecordTable::insert(const QDate& date, WorkoutRecord&& record)
+{
+    (*this)[date] = std::move(record);
+}
+
+bool RecordTable::remove(const QDate& date)
+{
+    auto& records = snapshot->records;
+    auto it = mutableLowerBound(date);
+    if (it == records.end() || it->date != date) {
+        return false;
+    }
+    records.erase(it);
+    return true;
+}
+
+QVector<QDate> RecordTable::dates() const
+{
+    QVector<QDate> result;
+    result.reserve(size());
+    for (const DatedRecord& entry : *this) {
+        result.append(entry.date);
+    }
+    return result;
+}
+
+void RecordTable::removeEntries(const QVector<qsizetype>& indices)
+{
+    if (indices.isEmpty()) {
+        return;
+    }
+    auto& records = snapshot->records;
+    auto out = records.begin() + indices.first();
+    qsizetype next = 0;
+    for (auto it = out; it != records.end(); ++it) {
+        if (next < indices.size() && it - records.begin() == indices[next]) {
+            ++next;
+            continue;
+        }
+        *out++ = std::move(*it);
+    }
+    records.erase(out, records.end());
+}
+
+void RecordTable::sortAndDeduplicate()
+{
+    auto& records = snapshot->records;
+    auto notAfter = [](const DatedRecord& a, const DatedRecord& b) { return !(a.date < b.date); };
+    if (std::adjacent_find(records.begin(), records.end(), notAfter) == records.end()) {
+        return; // already strictly increasing, the common case for saved files
+    }
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const DatedRecord& a, const DatedRecord& b) { return a.date < b.date; });
+    auto out = records.begin();
+    for (auto it = records.begin(); it != records.end(); ++it) {
+        auto next = it + 1;
+        if (next != records.end() && next->date == it->date) {
+            continue;
+        }
+        if (out != it) {
+            *out = std::move(*it);
+        }
+        ++out;
+    }
+    records.erase(out, records.end());
+}
@@ -0,0 +1,86 @@
+// record_table.h
+#ifndef RECORD_TABLE_H
+#define RECORD_TABLE_H
+
+#include <QDate>
+#include <QVector>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "types.h"
+
+struct DatedRecord {
+    QDate date;
+    WorkoutRecord record;
+};
+
+// Workout records kept in one contiguous array sorted by date. Lookups are
+// binary searches; appending a day after the last one (the usual case when
+// loading or logging today's session) is amortized O(1). Pointers and
+// iterators are invalidated by any insertion or removal.
+//
+// The array of a snapshot is allocated from a resource of its own that is
+// released as a unit by clear() or when the table is replaced, so a reload
+// does not leave a history's worth of freed blocks behind. The resource
+// returns each old array as the table grows, so a table edited all session
+// holds no more than its current array.
+//
+// Only the record array is pooled. Records hold shared pointers to bodies
+// owned by the BodyStore, which outlive any one snapshot (undo steps,
+// parked profiles and merge results keep them), so bodies, their strings
+// and exercise lists stay on the global heap; interning already makes
+// each distinct one a single allocation.
+class RecordTable {
+public:
+    using const_iterator = std::pmr::vector<DatedRecord>::const_iterator;
+
+    RecordTable();
+    // A moved-from table is empty and usable
+    RecordTable(RecordTable&& other);
+    RecordTable& operator=(RecordTable&& other) noexcept;
+    void swap(RecordTable& other) noexcept { snapshot.swap(other.snapshot); }
+
+    const WorkoutRecord* find(const QDate& date) const;
+    WorkoutRecord* find(const QDate& date);
+    bool contains(const QDate& date) const { return find(date) != nullptr; }
+
+    // Returns the record for `date`, inserting an empty one if needed
+    WorkoutRecord& operator[](const QDate& date);
+    void insert(const QDate& date, WorkoutRecord&& record);
+    bool remove(const QDate& date);
+
+    // Bulk loading: append records in file order, filling them in place,
+    // then call sortAndDeduplicate() once. Later duplicates of a date win.
+    DatedRecord& emplaceBack() { return snapshot->records.emplace_back(); }
+    void removeLast() { snapshot->records.pop_back(); }
+    DatedRecord& entryAt(qsizetype index) { return snapshot->records[size_t(index)]; }
+    // Drops the entries at `indices` (increasing) and keeps the rest in
+    // file order, which sortAndDeduplicate() relies on
+    void removeEntries(const QVector<qsizetype>& indices);
+    void sortAndDeduplicate();
+
+    void clear();
+    void reserve(qsizetype size) { snapshot->records.reserve(size_t(size)); }
+    qsizetype size() const { return qsizetype(snapshot->records.size()); }
+    // The record array; bodies are owned by the BodyStore
+    qsizetype memoryUsage() const { return qsizetype(snapshot->records.capacity() * sizeof(DatedRecord)); }
+    bool isEmpty() const { return snapshot->records.empty(); }
+    QVector<QDate> dates() const;
+
+    const_iterator begin() const { return snapshot->records.cbegin(); }
+    const_iterator end() const { return snapshot->records.cend(); }
+    // First record on or after `date`
+    const_iterator lowerBound(const QDate& date) const;
+
+private:
+    struct Snapshot {
+        std::pmr::unsynchronized_pool_resource arena;
+        std::pmr::vector<DatedRecord> records{&arena};
+    };
+
+    std::pmr::vector<DatedRecord>::iterator mutableLowerBound(const QDate& date);
+
+    std::unique_ptr<Snapshot> snapshot;
+};
+
+#endif // RECORD_TABLE_H
@@ -0,0 +1,166 @@
+// schedule.cpp
+#include "schedule.h"
+#include <QDebug>
+#include <QJsonValue>
+#include <utility>
+
+bool RecurrenceRule::occursOn(const QDate& date) const
+{
+    return date >= start && date <= end && (weekdays & weekdayBit(date.dayOfWeek()));
+}
+
+const WorkoutTemplate* Schedule::findTemplate(const QString& name) const
+{
+    auto it = templateMap.constFind(name);
+    return it != templateMap.cend() ? &it.value() : nullptr;
+}
+
+void Schedule::setTemplate(WorkoutTemplate workout)
+{
+    QString name = workout.name;
+    templateMap.insert(name, std::move(workout));
+}
+
+bool Schedule::removeTemplate(const QString& name)
+{
+    if (!templateMap.remove(name)) {
+        return false;
+    }
+    ruleList.removeIf([&name](const RecurrenceRule& rule) { return rule.templateName == name; });
+    return true;
+}
+
+bool Schedule::addRule(const RecurrenceRule& rule)
+{
+    if (!rule.start.isValid() || !rule.end.isValid() || rule.end < rule.start
+        || rule.weekdays == 0 || !templateMap.contains(rule.templateName)) {
+        return false;
+    }
+    ruleList.append(rule);
+    return true;
+}
+
+bool Schedule::removeRule(int index)
+{
+    if (index < 0 || index >= ruleList.size()) {
+        return false;
+    }
+    ruleList.removeAt(index);
+    return true;
+}
+
+const WorkoutTemplate* Schedule::plannedOn(const QDate& date) const
+{
+    for (auto it = ruleList.crbegin(); it != ruleList.crend(); ++it) {
+        if (it->occursOn(date)) {
+            return findTemplate(it->templateName);
+        }
+    }
+    return nullptr;
+}
+
+QVector<PlannedWorkout> Schedule::plannedBetween(const QDate& from, const QDate& to) const
+{
+    QVector<PlannedWorkout> planned;
+    if (ruleList.isEmpty() || !from.isValid() || !to.isValid()) {
+        return planned;
+    }
+
+    // Rules are few and ranges are a month at most, so walking the days
+    // and asking each rule is cheaper than merging per-rule expansions
+    for (QDate date = from; date <= to; date = date.addDays(1)) {
+        if (const WorkoutTemplate* workout = plannedOn(date)) {
+            planned.append(PlannedWorkout{date, workout});
+        }
+    }
+    return planned;
+}
+
+void Schedule::clear()
+{
+    templateMap.clear();
+    ruleList.clear();
+}
+
+QJsonArray Schedule::templatesToJson() const
+{
+    QJsonArray array;
+    for (const WorkoutTemplate& workout : templateMap) {
+        QJsonObject json;
+        json["name"] = workout.name;
+        json["description"] = workout.description;
+
+        QJsonArray exercisesArray;
+        for (const Exercise& exercise : workout.exercises) {
+            QJsonObject exerciseObj;
+            exerciseObj["name"] = exercise.name;
+            exerciseObj["sets"] = exercise.sets;
+            exerciseObj["reps"] = exercise.reps;
+            exercisesArray.append(exerciseObj);
+        }
+        json["exercises"] = exercisesArray;
+        array.append(json);
+    }
+    return array;
+}
+
+QJsonArray Schedule::rulesToJson() const
+{
+    QJsonArray array;
+    for (const RecurrenceRule& rule : ruleList) {
+        QJsonArray days;
+        for (int day = 1; day <= 7; ++day) {
+            if (rule.weekdays & RecurrenceRule::weekdayBit(day)) {
+                days.append(day);
+            }
+        }
+
+        QJsonObject json;
+        json["template"] = rule.templateName;
+        json["start"] = rule.start.toString(Qt::ISODate);
+        json["end"] = rule.end.toString(Qt::ISODate);
+        json["days"] = days;
+        array.append(json);
+    }
+    return array;
+}
+
+void Schedule::loadTemplates(const QJsonArray& array)
+{
+    for (const QJsonValue& value : array) {
+        QJsonObject json = value.toObject();
+        WorkoutTemplate workout;
+        workout.name = json["name"].toString();
+        if (workout.name.isEmpty()) continue;
+        workout.description = json["description"].toString();
+
+        for (const QJsonValue& exerciseValue : json["exercises"].toArray()) {
+            QJsonObject exerciseObj = exerciseValue.toObject();
+            workout.exercises.append(Exercise{exerciseObj["name"].toString(),
+                                              exerciseObj["sets"].toInt(),
+                                              exerciseObj["reps"].toInt()});
+        }
+        setTemplate(std::move(workout));
+    }
+}
+
+void Schedule::loadRules(const QJsonArray& array)
+{
+    for (const QJsonValue& value : array) {
+        QJsonObject json = value.toObject();
+        RecurrenceRule rule;
+        rule.templateName = json["template"].toString();
+        rule.start = QDate::fromString(json["start"].toString(), Qt::ISODate);
+        rule.end = QDate::fromString(json["end"].toString(), Qt::ISODate);
+        for (const QJsonValue& day : json["days"].toArray()) {
+            int dayOfWeek = day.toInt();
+            if (dayOfWeek >= 1 && dayOfWeek <= 7) {
+                rule.weekdays |= RecurrenceRule::weekdayBit(dayOfWeek);
+            }
+        }
+
+        if (!addRule(rule)) {
+            qWarning() << "Ignoring invalid schedule for template" << rule.templateName;
+        }
+    }
+}
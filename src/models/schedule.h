@@ -0,0 +1,68 @@
+// schedule.h
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <QDate>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include "types.h"
+
+// A reusable workout ("Push day A") that recurrence rules refer to by name
+struct WorkoutTemplate {
+    QString name;
+    QString description;
+    ExerciseList exercises;
+};
+
+// Repeats a template on some weekdays between two dates, inclusive
+struct RecurrenceRule {
+    QString templateName;
+    QDate start;
+    QDate end;
+    quint8 weekdays = 0;  // bit 0 = Monday ... bit 6 = Sunday
+
+    static quint8 weekdayBit(int dayOfWeek) { return quint8(1u << (dayOfWeek - 1)); }
+    bool occursOn(const QDate& date) const;
+};
+
+struct PlannedWorkout {
+    QDate date;
+    const WorkoutTemplate* workout;
+};
+
+// Templates and recurrence rules. Occurrences are never stored; they are
+// computed on demand for the range a view shows.
+class Schedule {
+public:
+    const WorkoutTemplate* findTemplate(const QString& name) const;
+    const QMap<QString, WorkoutTemplate>& templates() const { return templateMap; }
+    void setTemplate(WorkoutTemplate workout);
+    // Also drops the rules that use the template
+    bool removeTemplate(const QString& name);
+
+    const QVector<RecurrenceRule>& rules() const { return ruleList; }
+    bool addRule(const RecurrenceRule& rule);
+    bool removeRule(int index);
+
+    // Template planned on `date`; with overlapping rules the one added last wins
+    const WorkoutTemplate* plannedOn(const QDate& date) const;
+    // Planned days in [from, to] in date order
+    QVector<PlannedWorkout> plannedBetween(const QDate& from, const QDate& to) const;
+
+    bool isEmpty() const { return templateMap.isEmpty() && ruleList.isEmpty(); }
+    void clear();
+
+    QJsonArray templatesToJson() const;
+    QJsonArray rulesToJson() const;
+    void loadTemplates(const QJsonArray& array);
+    void loadRules(const QJsonArray& array);
+
+private:
+    QMap<QString, WorkoutTemplate> templateMap;
+    QVector<RecurrenceRule> ruleList;
+};
+
+#endif // SCHEDULE_H
@@ -0,0 +1,303 @@
+// set_log.cpp
+#include "set_log.h"
+#include <QJsonArray>
+#include <QDebug>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+bool rangeBefore(const SetLog::Range& range, const QPair<QDate, int>& key)
+{
+    return range.date < key.first || (range.date == key.first && range.exercise < key.second);
+}
+
+template <typename Column>
+void resizeAt(Column& column, qsizetype at, qsizetype delta)
+{
+    if (delta > 0) {
+        column.insert(at, delta, typename Column::value_type());
+    } else if (delta < 0) {
+        column.remove(at, -delta);
+    }
+}
+
+} // namespace
+
+QVector<SetLog::Range>::const_iterator SetLog::lowerBound(const QDate& date, int exercise) const
+{
+    return std::lower_bound(ranges.cbegin(), ranges.cend(), qMakePair(date, exercise), rangeBefore);
+}
+
+QVector<SetEntry> SetLog::sets(const QDate& date, int exercise) const
+{
+    QVector<SetEntry> rows;
+    auto it = lowerBound(date, exercise);
+    if (it == ranges.cend() || it->date != date || it->exercise != exercise) {
+        return rows;
+    }
+
+    rows.reserve(it->count);
+    for (qsizetype row = it->first; row < it->first + it->count; ++row) {
+        rows.append(SetEntry{weights[row], repCounts[row], rpes[row], rests[row]});
+    }
+    return rows;
+}
+
+QVector<QVector<SetEntry>> SetLog::daySets(const QDate& date, int exerciseCount) const
+{
+    QVector<QVector<SetEntry>> result(exerciseCount);
+    for (auto it = lowerBound(date, 0); it != ranges.cend() && it->date == date; ++it) {
+        if (it->exercise < exerciseCount) {
+            result[it->exercise] = sets(date, it->exercise);
+        }
+    }
+    return result;
+}
+
+bool SetLog::hasSets(const QDate& date) const
+{
+    auto it = lowerBound(date, std::numeric_limits<int>::min());
+    return it != ranges.cend() && it->date == date;
+}
+
+void SetLog::spliceRows(qsizetype at, qsizetype removeCount, const QVector<SetEntry>& rows)
+{
+    const qsizetype delta = rows.size() - removeCount;
+    resizeAt(weights, at, delta);
+    resizeAt(repCounts, at, delta);
+    resizeAt(rpes, at, delta);
+    resizeAt(rests, at, delta);
+
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        weights[at + i] = rows[i].weight;
+        repCounts[at + i] = rows[i].reps;
+        rpes[at + i] = rows[i].rpe;
+        rests[at + i] = rows[i].restSeconds;
+    }
+}
+
+void SetLog::setSets(const QDate& date, int exercise, const QVector<SetEntry>& rows)
+{
+    auto it = lowerBound(date, exercise);
+    const qsizetype position = it - ranges.cbegin();
+    const bool exists = it != ranges.cend() && it->date == date && it->exercise == exercise;
+    if (!exists && rows.isEmpty()) {
+        return;
+    }
+
+    const qsizetype at = it != ranges.cend() ? it->first : size();
+    const qsizetype removeCount = exists ? it->count : 0;
+    spliceRows(at, removeCount, rows);
+
+    // Later ranges move by the change in row count
+    const qsizetype delta = rows.size() - removeCount;
+    for (qsizetype i = position + (exists ? 1 : 0); i < ranges.size(); ++i) {
+        ranges[i].first += delta;
+    }
+
+    if (!exists) {
+        ranges.insert(position, Range{date, exercise, at, rows.size()});
+    } else if (rows.isEmpty()) {
+        ranges.remove(position);
+    } else {
+        ranges[position].count = rows.size();
+    }
+}
+
+bool SetLog::removeDay(const QDate& date)
+{
+    const qsizetype firstRange = lowerBound(date, std::numeric_limits<int>::min()) - ranges.cbegin();
+    qsizetype lastRange = firstRange;
+    while (lastRange < ranges.size() && ranges[lastRange].date == date) {
+        ++lastRange;
+    }
+    if (firstRange == lastRange) {
+        return false;
+    }
+
+    const qsizetype at = ranges[firstRange].first;
+    const qsizetype removeCount = ranges[lastRange - 1].first + ranges[lastRange - 1].count - at;
+    spliceRows(at, removeCount, {});
+    ranges.remove(firstRange, lastRange - firstRange);
+    for (qsizetype i = firstRange; i < ranges.size(); ++i) {
+        ranges[i].first -= removeCount;
+    }
+    return true;
+}
+
+void SetLog::clear()
+{
+    ranges.clear();
+    weights.clear();
+    repCounts.clear();
+    rpes.clear();
+    rests.clear();
+}
+
+SetColumns SetLog::slice(qsizetype first, qsizetype last) const
+{
+    SetColumns columns;
+    if (first < last) {
+        columns.weight = weights.constData() + first;
+        columns.reps = repCounts.constData() + first;
+        columns.rpe = rpes.constData() + first;
+        columns.restSeconds = rests.constData() + first;
+        columns.size = last - first;
+    }
+    return columns;
+}
+
+SetColumns SetLog::columns() const
+{
+    return slice(0, size());
+}
+
+SetColumns SetLog::columns(const QDate& from, const QDate& to) const
+{
+    auto first = lowerBound(from, std::numeric_limits<int>::min());
+    auto last = std::upper_bound(first, ranges.cend(), to, [](const QDate& date, const Range& range) {
+        return date < range.date;
+    });
+    if (first == last) {
+        return SetColumns();
+    }
+    return slice(first->first, (last - 1)->first + (last - 1)->count);
+}
+
+void SetLog::appendRange(const SetLog& source, const Range& range)
+{
+    ranges.append(Range{range.date, range.exercise, size(), range.count});
+    const qsizetype end = range.first + range.count;
+    for (qsizetype row = range.first; row < end; ++row) {
+        weights.append(source.weights[row]);
+        repCounts.append(source.repCounts[row]);
+        rpes.append(source.rpes[row]);
+        rests.append(source.rests[row]);
+    }
+}
+
+void SetLog::merge(const SetLog& other, const std::function<bool(const QDate&)>& take)
+{
+    SetLog merged;
+    merged.ranges.reserve(ranges.size() + other.ranges.size());
+    auto ours = ranges.cbegin();
+    auto theirs = other.ranges.cbegin();
+    while (ours != ranges.cend() || theirs != other.ranges.cend()) {
+        const bool oursFirst = theirs == other.ranges.cend()
+            || (ours != ranges.cend() && !rangeBefore(*theirs, qMakePair(ours->date, ours->exercise)));
+        if (oursFirst) {
+            // Equal keys too: this log wins
+            if (theirs != other.ranges.cend() && theirs->date == ours->date) {
+                const QDate day = ours->date;
+                while (theirs != other.ranges.cend() && theirs->date == day) {
+                    ++theirs;
+                }
+            }
+            merged.appendRange(*this, *ours++);
+        } else {
+            const QDate day = theirs->date;
+            const bool ourDay = ours != ranges.cend() && ours->date == day;
+            const bool taken = !ourDay && take(day);
+            for (; theirs != other.ranges.cend() && theirs->date == day; ++theirs) {
+                if (taken) {
+                    merged.appendRange(other, *theirs);
+                }
+            }
+        }
+    }
+    std::swap(*this, merged);
+}
+
+template <typename Ranges>
+QJsonObject SetLog::rangesToJson(const Ranges& selected) const
+{
+    QJsonArray days;
+    QJsonArray weightArray;
+    QJsonArray repsArray;
+    QJsonArray rpeArray;
+    QJsonArray restArray;
+    for (const Range& range : selected) {
+        days.append(QJsonArray{range.date.toString(Qt::ISODate), range.exercise, int(range.count)});
+        for (qsizetype row = range.first; row < range.first + range.count; ++row) {
+            weightArray.append(double(weights[row]));
+            repsArray.append(repCounts[row]);
+            rpeArray.append(double(rpes[row]));
+            restArray.append(rests[row]);
+        }
+    }
+
+    QJsonObject json;
+    json["days"] = days;
+    json["weight"] = weightArray;
+    json["reps"] = repsArray;
+    json["rpe"] = rpeArray;
+    json["rest"] = restArray;
+    return json;
+}
+
+QJsonObject SetLog::toJson() const
+{
+    return rangesToJson(ranges);
+}
+
+QJsonObject SetLog::toJson(const QVector<QDate>& days) const
+{
+    QVector<Range> selected;
+    for (const QDate& date : days) {
+        for (auto it = lowerBound(date, std::numeric_limits<int>::min()); it != ranges.cend() && it->date == date; ++it) {
+            selected.append(*it);
+        }
+    }
+    return rangesToJson(selected);
+}
+
+bool SetLog::loadJson(const QJsonObject& json)
+{
+    clear();
+    const QJsonArray days = json["days"].toArray();
+    const QJsonArray weightArray = json["weight"].toArray();
+    const QJsonArray repsArray = json["reps"].toArray();
+    const QJsonArray rpeArray = json["rpe"].toArray();
+    const QJsonArray restArray = json["rest"].toArray();
+
+    const qsizetype rows = weightArray.size();
+    if (repsArray.size() != rows || rpeArray.size() != rows || restArray.size() != rows) {
+        qWarning() << "Set detail columns have different lengths; ignoring set detail";
+        return false;
+    }
+
+    QVector<Range> loaded;
+    loaded.reserve(days.size());
+    qsizetype first = 0;
+    for (const QJsonValue& value : days) {
+        const QJsonArray day = value.toArray();
+        const QDate date = QDate::fromString(day.at(0).toString(), Qt::ISODate);
+        const int exercise = day.at(1).toInt(-1);
+        const qsizetype count = day.at(2).toInt();
+        const bool ordered = loaded.isEmpty() || rangeBefore(loaded.last(), qMakePair(date, exercise));
+        if (!date.isValid() || exercise < 0 || count <= 0 || first + count > rows || !ordered) {
+            qWarning() << "Invalid set detail entry; ignoring set detail";
+            return false;
+        }
+        loaded.append(Range{date, exercise, first, count});
+        first += count;
+    }
+    if (first != rows) {
+        qWarning() << "Set detail index does not cover all rows; ignoring set detail";
+        return false;
+    }
+
+    weights.reserve(rows);
+    repCounts.reserve(rows);
+    rpes.reserve(rows);
+    rests.reserve(rows);
+    for (qsizetype row = 0; row < rows; ++row) {
+        weights.append(float(weightArray[row].toDouble()));
+        repCounts.append(repsArray[row].toInt());
+        rpes.append(float(rpeArray[row].toDouble()));
+        rests.append(restArray[row].toInt());
+    }
+    ranges = std::move(loaded);
+    return true;
+}
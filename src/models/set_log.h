@@ -0,0 +1,99 @@
+// set_log.h
+#ifndef SET_LOG_H
+#define SET_LOG_H
+
+#include <QDate>
+#include <QJsonObject>
+#include <QVector>
+#include <functional>
+
+// One performed set. Zero means "not recorded" for RPE and rest.
+struct SetEntry {
+    float weight = 0;
+    int reps = 0;
+    float rpe = 0;
+    int restSeconds = 0;
+};
+Q_DECLARE_TYPEINFO(SetEntry, Q_PRIMITIVE_TYPE);
+
+inline bool operator==(const SetEntry& a, const SetEntry& b)
+{
+    return a.weight == b.weight && a.reps == b.reps && a.rpe == b.rpe && a.restSeconds == b.restSeconds;
+}
+
+// Read-only view of contiguous set rows, one array per field
+struct SetColumns {
+    const float* weight = nullptr;
+    const qint32* reps = nullptr;
+    const float* rpe = nullptr;
+    const qint32* restSeconds = nullptr;
+    qsizetype size = 0;
+};
+
+// Per-set detail for the days that have it, kept apart from the workout
+// records. Rows are stored column by column and ordered by (date, exercise
+// index), so any date range is one contiguous slice of each column. Days
+// without set detail take no space.
+class SetLog {
+public:
+    // The rows of one exercise of one day
+    struct Range {
+        QDate date;
+        int exercise;
+        qsizetype first;
+        qsizetype count;
+    };
+
+    bool isEmpty() const { return ranges.isEmpty(); }
+    qsizetype size() const { return weights.size(); }
+    const QVector<Range>& index() const { return ranges; }
+    qsizetype memoryUsage() const
+    {
+        return ranges.capacity() * qsizetype(sizeof(Range))
+             + (weights.capacity() + rpes.capacity()) * qsizetype(sizeof(float))
+             + (repCounts.capacity() + rests.capacity()) * qsizetype(sizeof(qint32));
+    }
+
+    QVector<SetEntry> sets(const QDate& date, int exercise) const;
+    // One list per exercise, `exerciseCount` long; exercises without detail
+    // get an empty list
+    QVector<QVector<SetEntry>> daySets(const QDate& date, int exerciseCount) const;
+    bool hasSets(const QDate& date) const;
+
+    // Replaces the rows of one exercise; an empty list removes them
+    void setSets(const QDate& date, int exercise, const QVector<SetEntry>& rows);
+    // Returns false if the day had no rows
+    bool removeDay(const QDate& date);
+    void clear();
+
+    SetColumns columns() const;
+    // Rows of the days in [from, to]
+    SetColumns columns(const QDate& from, const QDate& to) const;
+
+    // Adds the rows of the days in `other` for which `take` is true; days
+    // this log already has are kept. One pass over both logs.
+    void merge(const SetLog& other, const std::function<bool(const QDate&)>& take);
+
+    // Stored columnar as well: an index of (day, exercise, count) entries
+    // and one array per field
+    QJsonObject toJson() const;
+    // Only the rows of `days`, which must be in date order
+    QJsonObject toJson(const QVector<QDate>& days) const;
+    bool loadJson(const QJsonObject& json);
+
+private:
+    QVector<Range>::const_iterator lowerBound(const QDate& date, int exercise) const;
+    SetColumns slice(qsizetype first, qsizetype last) const;
+    void spliceRows(qsizetype at, qsizetype removeCount, const QVector<SetEntry>& rows);
+    void appendRange(const SetLog& source, const Range& range);
+    template <typename Ranges>
+    QJsonObject rangesToJson(const Ranges& selected) const;
+
+    QVector<Range> ranges;
+    QVector<float> weights;
+    QVector<qint32> repCounts;
+    QVector<float> rpes;
+    QVector<qint32> rests;
+};
+
+#endif // SET_LOG_H
@@ -1,12 +1,284 @@
 // storage_manager.cpp
 #include "storage_manager.h"
+#include "alloc_tracker.h"
+#include "archive_blocks.h"
+#include "workout_json_reader.h"
+#include "checksum.h"
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QHash>
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace {
+
+// Closed years are archived this many overridden days after their archive
+// was written, which folds the overrides back in
+constexpr int ArchiveCompactionDays = 64;
+
+QString archivePath(const QString& dataFile, int year)
+{
+    const QFileInfo info(dataFile);
+    return info.dir().filePath(QString("%1-%2.archive").arg(info.completeBaseName()).arg(year));
+}
+
+// Years archived next to `dataFile`, oldest first
+QVector<int> archivedYearsOf(const QString& dataFile)
+{
+    const QFileInfo info(dataFile);
+    const QString prefix = info.completeBaseName() + '-';
+    QVector<int> years;
+    const QStringList names = info.dir().entryList({prefix + "????.archive"}, QDir::Files, QDir::Name);
+    for (const QString& name : names) {
+        bool ok = false;
+        const int year = name.mid(prefix.size(), 4).toInt(&ok);
+        if (ok) {
+            years.append(year);
+        }
+    }
+    return years;
+}
+
+} // namespace
+
+// Everything read from one data file and its archives, built apart from the
+// live store so a damaged file leaves the store untouched
+struct FileSnapshot {
+    RecordTable records;
+    StringPool strings;
+    BodyStore bodies;
+    SetLog sets;
+    Schedule schedule;
+    int recordCount = 0;
+    size_t hash = 0;
+    bool valid = false;
+    QString error;
+    QMap<int, ArchiveStamp> archivedYears;
+    // Days of archived years the data file itself has or removes
+    QSet<QDate> overrides;
+    // When set, files that do not parse are salvaged and records failing
+    // their checksum are skipped; otherwise either fails the snapshot
+    bool salvageDamaged = false;
+    // Files that had damaged parts skipped
+    QStringList damagedFiles;
+
+    bool read(const QString& path);
+
+private:
+    bool parse(const QByteArray& data, const QString& source);
+    bool readArchive(const QString& path, ArchiveStamp& stamp, QVector<DatedRecord>& cold);
+    bool readRecords(WorkoutJsonReader& reader, RecordTable& table, const QString& source);
+    QSet<QDate> removed;
+    // Archives the data file lists; files from before the list have none
+    // and take whatever archives lie beside them
+    QMap<int, ArchiveStamp> listedArchives;
+    bool hasArchiveList = false;
+};
+
+bool FileSnapshot::readRecords(WorkoutJsonReader& reader, RecordTable& table, const QString& source)
+{
+    bool ok = reader.read(table);
+    if (!ok && salvageDamaged) {
+        qWarning() << "Salvaging" << source << "after:" << reader.errorString();
+        table.clear();
+        ok = reader.salvage(table);
+    }
+    if (!ok) {
+        error = reader.errorString();
+        return false;
+    }
+    if (!reader.damaged().isEmpty()) {
+        if (!salvageDamaged) {
+            error = QString("%1 damaged records").arg(reader.damaged().size());
+            return false;
+        }
+        for (const DamagedRange& range : reader.damaged()) {
+            qWarning() << "Skipped damaged data in" << source << "at bytes" << range.begin << "to" << range.end
+                       << range.date << range.reason;
+        }
+        if (!damagedFiles.contains(source)) {
+            damagedFiles.append(source);
+        }
+    }
+    return true;
+}
+
+bool FileSnapshot::parse(const QByteArray& data, const QString& source)
+{
+    // Sizing the table from the number of "date" keys gives the whole
+    // snapshot a single array allocation in the table's arena
+    hash = qHash(data);
+    records.reserve(data.count("\"date\""));
+    WorkoutJsonReader reader(data, strings, bodies);
+    if (!readRecords(reader, records, source)) {
+        return false;
+    }
+    recordCount = reader.recordCount();
+
+    const QByteArrayView setsSection = reader.section("sets");
+    if (!setsSection.isEmpty()) {
+        sets.loadJson(QJsonDocument::fromJson(setsSection.toByteArray()).object());
+    }
+
+    // Templates and schedules are small; the generic parser is fine there
+    schedule.loadTemplates(QJsonDocument::fromJson(reader.section("templates").toByteArray()).array());
+    schedule.loadRules(QJsonDocument::fromJson(reader.section("schedules").toByteArray()).array());
+    const QJsonArray removedDays = QJsonDocument::fromJson(reader.section("removed").toByteArray()).array();
+    for (const QJsonValue& value : removedDays) {
+        removed.insert(QDate::fromString(value.toString(), Qt::ISODate));
+    }
+    const QByteArrayView archivesSection = reader.section("archives");
+    hasArchiveList = !archivesSection.isEmpty();
+    const QJsonArray archives = QJsonDocument::fromJson(archivesSection.toByteArray()).array();
+    for (const QJsonValue& value : archives) {
+        const QJsonObject archive = value.toObject();
+        listedArchives.insert(archive["year"].toInt(),
+                              ArchiveStamp{quint32(archive["crc"].toInteger()), archive["size"].toInteger()});
+    }
+    valid = true;
+    return true;
+}
+
+bool FileSnapshot::read(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    if (!parse(file.readAll(), path)) {
+        return false;
+    }
+
+    // Archived days the data file repeats or removes were changed after
+    // archiving, and the file's version wins. The table stays sorted while
+    // archives are read, so their days are appended once at the end.
+    QVector<DatedRecord> cold;
+    if (!hasArchiveList) {
+        for (int year : archivedYearsOf(path)) {
+            listedArchives.insert(year, ArchiveStamp());
+        }
+    }
+    for (auto it = listedArchives.cbegin(); it != listedArchives.cend(); ++it) {
+        const int year = it.key();
+        const QString archive = archivePath(path, year);
+        // Without the archive its year would be dropped by the next save
+        if (!QFileInfo::exists(archive)) {
+            error = archive + ": listed in the data file but missing";
+            valid = false;
+            return false;
+        }
+        ArchiveStamp stamp = it.value();
+        const qsizetype damagedBefore = damagedFiles.size();
+        if (!readArchive(archive, stamp, cold)) {
+            if (!salvageDamaged) {
+                valid = false;
+                return false;
+            }
+            qWarning() << "Skipped unreadable archive:" << error;
+            if (!damagedFiles.contains(archive)) {
+                damagedFiles.append(archive);
+            }
+            continue;
+        }
+        // A damaged archive is left out so the next save writes it anew
+        if (damagedFiles.size() == damagedBefore) {
+            archivedYears.insert(year, stamp);
+        }
+    }
+    for (const DatedRecord& entry : records) {
+        if (archivedYears.contains(entry.date.year())) {
+            overrides.insert(entry.date);
+        }
+    }
+    for (const QDate& date : std::as_const(removed)) {
+        if (archivedYears.contains(date.year())) {
+            overrides.insert(date);
+        }
+    }
+
+    if (!cold.isEmpty()) {
+        records.reserve(records.size() + cold.size());
+        for (DatedRecord& entry : cold) {
+            records.emplaceBack() = std::move(entry);
+        }
+        records.sortAndDeduplicate();
+        recordCount += int(cold.size());
+    }
+    return true;
+}
+
+// `stamp` holds what the data file lists, and is set to what was read
+bool FileSnapshot::readArchive(const QString& path, ArchiveStamp& stamp, QVector<DatedRecord>& cold)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = path + ": " + file.errorString();
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    const ArchiveStamp listed = stamp;
+    stamp = ArchiveStamp{crc32c(data), data.size(), QFileInfo(path).lastModified()};
+    if (listed.size > 0 && (listed.size != stamp.size || listed.crc != stamp.crc)) {
+        // Damaged, or replaced by an archive the data file does not know
+        if (!salvageDamaged) {
+            error = path + ": does not match the data file's archive list";
+            return false;
+        }
+        qWarning() << "Archive does not match the data file's list:" << path;
+        damagedFiles.append(path);
+    }
+
+    auto current = [this](const QDate& date) {
+        return !records.contains(date) && !removed.contains(date);
+    };
+    const QVector<ArchiveBlock> blocks = readArchiveBlocks(data);
+    for (const ArchiveBlock& block : blocks) {
+        if (!block.isIntact()) {
+            if (!salvageDamaged) {
+                error = QString("%1: %2 at bytes %3 to %4").arg(path, block.error).arg(block.begin).arg(block.end);
+                return false;
+            }
+            qWarning() << "Skipped damaged block of" << path << "at bytes" << block.begin << "to" << block.end
+                       << block.error;
+            if (!damagedFiles.contains(path)) {
+                damagedFiles.append(path);
+            }
+            continue;
+        }
+
+        RecordTable archived;
+        WorkoutJsonReader reader(block.json, strings, bodies);
+        if (!readRecords(reader, archived, path)) {
+            error = path + ": " + error;
+            return false;
+        }
+        for (const DatedRecord& entry : archived) {
+            if (current(entry.date)) {
+                cold.append(entry);
+            }
+        }
+
+        const QByteArrayView setsSection = reader.section("sets");
+        if (!setsSection.isEmpty()) {
+            SetLog archivedSets;
+            archivedSets.loadJson(QJsonDocument::fromJson(setsSection.toByteArray()).object());
+            sets.merge(archivedSets, current);
+        }
+    }
+    return true;
+}
 
 StorageManager& StorageManager::instance()
 {
@@ -14,10 +286,52 @@ StorageManager& StorageManager::instance()
     return instance;
 }
 
+StorageManager::StorageManager(QObject* parent)
+    : QObject(parent)
+{
+}
+
+StorageManager::~StorageManager()
+{
+    // The worker is a child: it must have stopped before QObject deletes
+    // it, and its queued finished() is dropped along with this object
+    if (reloadWorker) {
+        reloadWorker->wait();
+    }
+}
+
+void StorageManager::beginTransaction()
+{
+    ++transactionDepth;
+}
+
+bool StorageManager::commitTransaction()
+{
+    Q_ASSERT(transactionDepth > 0);
+    if (transactionDepth == 0 || --transactionDepth > 0) {
+        return true;
+    }
+
+    bool saved = autoSave && needsSaving ? saveToFile() : true;
+    if (!pendingChanges.isEmpty()) {
+        QVector<QDate> changed;
+        changed.swap(pendingChanges);
+        std::sort(changed.begin(), changed.end());
+        changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+        emit workoutsChanged(changed);
+    }
+    flushPersonalRecords();
+    finishUndoStep();
+    return saved;
+}
+
 bool StorageManager::loadFromFile(const QString& filename)
 {
+    WT_ALLOC_SCOPE("load-file");
     QString filePath = filename.isEmpty() ? getWorkoutFilePath() : filename;
     qDebug() << "Loading workouts from:" << filePath;
+    dataFilePath = filePath;
+    watchCurrentFile();
     
     QFile file(filePath);
     
@@ -31,39 +345,38 @@ bool StorageManager::loadFromFile(const QString& filename)
         return false;
     }
     
-    QByteArray saveData = file.readAll();
-    QJsonDocument doc(QJsonDocument::fromJson(saveData));
-    
-    if (!doc.isObject()) {
-        qWarning() << "Invalid JSON format in file:" << filePath;
+    file.close();
+
+    FileSnapshot loaded;
+    loaded.salvageDamaged = salvageDamaged;
+    if (!loaded.read(filePath)) {
+        qWarning() << "Invalid JSON format in file:" << filePath << loaded.error;
         return false;
     }
-    
-    QJsonObject root = doc.object();
-    QJsonArray workoutsArray = root["workouts"].toArray();
-    
-    workouts.clear();
-    int loadedWorkouts = 0;
-    
-    for (const QJsonValue& value : workoutsArray) {
-        if (!value.isObject()) continue;
-        
-        QJsonObject workoutObj = value.toObject();
-        QString dateStr = workoutObj["date"].toString();
-        if (dateStr.isEmpty()) continue;
-        
-        QDate date = QDate::fromString(dateStr, Qt::ISODate);
-        if (!date.isValid()) {
-            qWarning() << "Invalid date in workout data:" << dateStr;
-            continue;
+    // Saving drops what was skipped, so the damaged originals are kept
+    for (const QString& damaged : std::as_const(loaded.damagedFiles)) {
+        const QString backup = damaged + ".damaged";
+        QFile::remove(backup);
+        if (QFile::copy(damaged, backup)) {
+            qWarning() << "Loaded what was intact of" << damaged << "- original kept as" << backup;
         }
-        
-        WorkoutData workout = workoutFromJson(workoutObj);
-        workouts[date] = workout;
-        loadedWorkouts++;
     }
+
+    // The previous snapshot and its arena are released with `loaded`
+    workouts.swap(loaded.records);
+    std::swap(strings, loaded.strings);
+    std::swap(bodies, loaded.bodies);
+    std::swap(setLog, loaded.sets);
+    streaks.reset(workouts);
+    rebuildIndexes();
+    std::swap(workoutSchedule, loaded.schedule);
+    std::swap(archivedYears, loaded.archivedYears);
+    std::swap(coldChanges, loaded.overrides);
+    needsSaving = !loaded.damagedFiles.isEmpty();
+    knownFileHash = loaded.hash;
+    clearHistory();
     
-    qDebug() << "Successfully loaded" << loadedWorkouts << "workouts";
+    qDebug() << "Successfully loaded" << loaded.recordCount << "workouts";
     return true;
 }
 
@@ -79,7 +392,11 @@ QString StorageManager::getWorkoutFilePath()
 
 bool StorageManager::saveToFile(const QString& filename)
 {
-    QString filePath = filename.isEmpty() ? getWorkoutFilePath() : filename;
+    WT_ALLOC_SCOPE("save-file");
+    QString filePath = filename;
+    if (filePath.isEmpty()) {
+        filePath = dataFilePath.isEmpty() ? getWorkoutFilePath() : dataFilePath;
+    }
     qDebug() << "Saving workouts to:" << filePath;
     
     // Ensure directory exists
@@ -89,35 +406,248 @@ bool StorageManager::saveToFile(const QString& filename)
         dir.mkpath(".");
     }
     
-    QFile file(filePath);
+    // Closed years go to their archives first: should the data file then
+    // fail to save, the old one still has their days and overrides them
+    bodies.prune();
+    const bool tiered = archiving && filePath == dataFilePath;
+    if (tiered) {
+        archiveClosedYears();
+    }
+
+    // Written beside the old file and renamed over it on commit, so a crash
+    // or full disk mid-save leaves the previous file whole
+    QSaveFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         qWarning() << "Could not open file for writing:" << filePath;
         return false;
     }
+
+    QJsonObject root = daysToJson(tiered ? hotDates() : workouts.dates());
+    if (tiered) {
+        QVector<QDate> removed;
+        for (const QDate& date : std::as_const(coldChanges)) {
+            if (!workouts.contains(date)) {
+                removed.append(date);
+            }
+        }
+        std::sort(removed.begin(), removed.end());
+        QJsonArray removedArray;
+        for (const QDate& date : std::as_const(removed)) {
+            removedArray.append(date.toString(Qt::ISODate));
+        }
+        if (!removedArray.isEmpty()) {
+            root["removed"] = removedArray;
+        }
+    }
+    // Always present, so the file never picks up archives it did not write
+    QJsonArray archivesArray;
+    if (tiered) {
+        for (auto it = archivedYears.cbegin(); it != archivedYears.cend(); ++it) {
+            QJsonObject archive;
+            archive["year"] = it.key();
+            archive["crc"] = qint64(it->crc);
+            archive["size"] = it->size;
+            archivesArray.append(archive);
+        }
+    }
+    root["archives"] = archivesArray;
+    if (!workoutSchedule.isEmpty()) {
+        root["templates"] = workoutSchedule.templatesToJson();
+        root["schedules"] = workoutSchedule.rulesToJson();
+    }
+    
+    const QByteArray data = QJsonDocument(root).toJson();
+    if (file.write(data) == -1 || !file.commit()) {
+        qWarning() << "Failed to write data to file:" << filePath << file.errorString();
+        return false;
+    }
+    if (filePath == dataFilePath) {
+        knownFileHash = qHash(data);
+    }
     
+    needsSaving = false;
+    return true;
+}
+
+QJsonObject StorageManager::daysToJson(const QVector<QDate>& dates) const
+{
     QJsonObject root;
+    QJsonArray bodiesArray;
     QJsonArray workoutsArray;
-    
-    for (auto it = workouts.begin(); it != workouts.end(); ++it) {
-        QJsonObject workoutObj = workoutToJson(it.value());
-        workoutObj["date"] = it.key().toString(Qt::ISODate);
+
+    // Each distinct body is written once; records refer to it by its
+    // position in "bodies", numbered in order of first use. Every record
+    // carries a checksum of its content, body included, so damage to the
+    // file shows up record by record.
+    QHash<const WorkoutBody*, QPair<int, quint32>> bodyIds;
+    bodyIds.reserve(bodies.size());
+    const quint32 emptySum = bodyChecksum(nullptr);
+
+    for (const QDate& date : dates) {
+        const WorkoutRecord* record = workouts.find(date);
+        if (!record) {
+            continue;
+        }
+        QJsonObject workoutObj;
+        workoutObj["date"] = date.toString(Qt::ISODate);
+        workoutObj["status"] = static_cast<int>(record->status);
+        quint32 bodySum = emptySum;
+        if (const WorkoutBody* body = record->body.get()) {
+            auto it = bodyIds.constFind(body);
+            if (it == bodyIds.cend()) {
+                it = bodyIds.insert(body, {int(bodiesArray.size()), bodyChecksum(body)});
+                bodiesArray.append(bodyToJson(*body));
+            }
+            workoutObj["body"] = it->first;
+            bodySum = it->second;
+        }
+        workoutObj["crc"] = qint64(recordChecksum(date, record->status, bodySum));
         workoutsArray.append(workoutObj);
     }
-    
+
+    root["bodies"] = bodiesArray;
     root["workouts"] = workoutsArray;
-    
-    QJsonDocument doc(root);
-    if (file.write(doc.toJson()) == -1) {
-        qWarning() << "Failed to write data to file:" << filePath;
+    if (!setLog.isEmpty()) {
+        root["sets"] = setLog.toJson(dates);
+    }
+    return root;
+}
+
+QVector<QDate> StorageManager::hotDates() const
+{
+    QVector<QDate> dates;
+    auto it = workouts.begin();
+    while (it != workouts.end()) {
+        const int year = it->date.year();
+        if (archivedYears.contains(year)) {
+            it = workouts.lowerBound(QDate(year + 1, 1, 1));
+            continue;
+        }
+        dates.append(it->date);
+        ++it;
+    }
+
+    const qsizetype unarchived = dates.size();
+    for (const QDate& date : std::as_const(coldChanges)) {
+        if (workouts.contains(date)) {
+            dates.append(date);
+        }
+    }
+    if (dates.size() > unarchived) {
+        std::sort(dates.begin(), dates.end());
+    }
+    return dates;
+}
+
+void StorageManager::archiveClosedYears()
+{
+    const int currentYear = QDate::currentDate().year();
+    QSet<int> years;
+    for (auto it = archivedYears.keyBegin(); it != archivedYears.keyEnd(); ++it) {
+        years.insert(*it);
+    }
+    for (auto it = workouts.begin(); it != workouts.end() && it->date.year() < currentYear;
+         it = workouts.lowerBound(QDate(it->date.year() + 1, 1, 1))) {
+        years.insert(it->date.year());
+    }
+
+    QHash<int, int> overridden;
+    for (const QDate& date : std::as_const(coldChanges)) {
+        ++overridden[date.year()];
+    }
+    for (int year : std::as_const(years)) {
+        if (year >= currentYear) {
+            continue;
+        }
+        // An archive that is gone or changed on disk is written again from
+        // the store, which has all its days, before the list names it
+        const bool archived = archivedYears.contains(year);
+        const bool intact = archived && isArchiveIntact(year);
+        if (archived && !intact) {
+            qWarning() << "Archive changed on disk, writing it again:" << archivePath(dataFilePath, year);
+        }
+        if (intact && overridden.value(year) < ArchiveCompactionDays) {
+            continue;
+        }
+        if (!writeArchive(year) && archived && !intact) {
+            // The list must not name an archive that is not there: the
+            // year's days go to the data file until a save can archive them
+            archivedYears.remove(year);
+            for (auto it = coldChanges.begin(); it != coldChanges.end();) {
+                it = it->year() == year ? coldChanges.erase(it) : std::next(it);
+            }
+        }
+    }
+}
+
+bool StorageManager::isArchiveIntact(int year)
+{
+    auto archived = archivedYears.find(year);
+    if (archived == archivedYears.end()) {
         return false;
     }
-    
+    const QString path = archivePath(dataFilePath, year);
+    const QFileInfo info(path);
+    if (!info.exists() || info.size() != archived->size) {
+        return false;
+    }
+    if (info.lastModified() == archived->modified) {
+        return true;
+    }
+    // Touched since we last saw it: only the content can tell
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || crc32c(file.readAll()) != archived->crc) {
+        return false;
+    }
+    archived->modified = info.lastModified();
+    return true;
+}
+
+bool StorageManager::writeArchive(int year)
+{
+    const QString path = archivePath(dataFilePath, year);
+    QVector<QDate> dates;
+    for (auto it = workouts.lowerBound(QDate(year, 1, 1)); it != workouts.end() && it->date.year() == year; ++it) {
+        dates.append(it->date);
+    }
+
+    if (dates.isEmpty()) {
+        // Every day of the year was removed
+        // Unlisted even if it cannot be removed, so its days stay removed
+        archivedYears.remove(year);
+        if (QFile::exists(path) && !QFile::remove(path)) {
+            qWarning() << "Could not remove archive:" << path;
+            return false;
+        }
+    } else {
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Could not open archive for writing:" << path;
+            return false;
+        }
+        QByteArray archive = archiveHeader();
+        for (qsizetype first = 0; first < dates.size(); first += ArchiveBlockDays) {
+            const QJsonObject block = daysToJson(dates.mid(first, ArchiveBlockDays));
+            appendArchiveBlock(archive, QJsonDocument(block).toJson(QJsonDocument::Compact));
+        }
+        file.write(archive);
+        if (!file.commit()) {
+            qWarning() << "Failed to write archive:" << path << file.errorString();
+            return false;
+        }
+        archivedYears.insert(year, ArchiveStamp{crc32c(archive), archive.size(), QFileInfo(path).lastModified()});
+        qInfo() << "Archived" << dates.size() << "days of" << year << "to" << path;
+    }
+
+    for (auto it = coldChanges.begin(); it != coldChanges.end();) {
+        it = it->year() == year ? coldChanges.erase(it) : std::next(it);
+    }
     return true;
 }
 
 QVector<QDate> StorageManager::getAllWorkoutDates() const
 {
-    return QVector<QDate>(workouts.keys().begin(), workouts.keys().end());
+    return workouts.dates();
 }
 
 bool StorageManager::hasWorkout(const QDate& date) const
@@ -125,10 +655,70 @@ bool StorageManager::hasWorkout(const QDate& date) const
     return workouts.contains(date);
 }
 
+void StorageManager::swapContents(StorageManager& other)
+{
+    Q_ASSERT(transactionDepth == 0 && other.transactionDepth == 0);
+    workouts.swap(other.workouts);
+    std::swap(strings, other.strings);
+    std::swap(bodies, other.bodies);
+    std::swap(setLog, other.setLog);
+    std::swap(streaks, other.streaks);
+    std::swap(recordIndex, other.recordIndex);
+    std::swap(exerciseNames, other.exerciseNames);
+    std::swap(workoutSchedule, other.workoutSchedule);
+    std::swap(history, other.history);
+    std::swap(dataFilePath, other.dataFilePath);
+    std::swap(needsSaving, other.needsSaving);
+    std::swap(knownFileHash, other.knownFileHash);
+    std::swap(archivedYears, other.archivedYears);
+    std::swap(coldChanges, other.coldChanges);
+    watchCurrentFile();
+    other.watchCurrentFile();
+    emit scheduleChanged();
+    emit undoStateChanged();
+}
+
+qsizetype StorageManager::memoryUsage() const
+{
+    // Each part counts its own containers by capacity; shared strings are
+    // counted once, by the pool that holds them
+    return workouts.memoryUsage() + strings.memoryUsage() + bodies.memoryUsage()
+         + setLog.memoryUsage() + streaks.memoryUsage() + recordIndex.memoryUsage()
+         + exerciseNames.memoryUsage();
+}
+
 void StorageManager::clearAllData()
 {
+    const QVector<QDate> removed = workouts.dates();
     workouts.clear();
+    strings.clear();
+    bodies.clear();
+    setLog.clear();
+    streaks.clear();
+    recordIndex.clear();
+    exerciseNames.clear();
+    if (!workoutSchedule.isEmpty()) {
+        workoutSchedule.clear();
+        emit scheduleChanged();
+    }
+    clearHistory();
+    if (!dataFilePath.isEmpty()) {
+        for (auto it = archivedYears.keyBegin(); it != archivedYears.keyEnd(); ++it) {
+            QFile::remove(archivePath(dataFilePath, *it));
+        }
+    }
+    archivedYears.clear();
+    coldChanges.clear();
+    if (transactionDepth > 0) {
+        needsSaving = true;
+        pendingChanges += removed;
+        return;
+    }
+
     saveToFile();
+    if (!removed.isEmpty()) {
+        emit workoutsChanged(removed);
+    }
 }
 
 bool StorageManager::saveWorkout(const QDate& date,
@@ -137,14 +727,563 @@ bool StorageManager::saveWorkout(const QDate& date,
                                const QVector<Exercise>& exercises,
                                WorkoutStatus status)
 {
-    WorkoutData workout;
-    workout.name = name;
-    workout.description = description;
-    workout.exercises = exercises;
+    WT_ALLOC_SCOPE("save");
+    WorkoutBody body;
+    body.name = name;
+    body.description = description;
+    body.exercises = toExerciseList(exercises);
+    return storeBody(date, std::move(body), status);
+}
+
+bool StorageManager::saveWorkout(const QDate& date,
+                               QString&& name,
+                               QString&& description,
+                               QVector<Exercise>&& exercises,
+                               WorkoutStatus status)
+{
+    WT_ALLOC_SCOPE("save");
+    WorkoutBody body;
+    body.name = std::move(name);
+    body.description = std::move(description);
+    // Names are interned when the body is stored. A list still shared with
+    // the caller is read, not written, so it is never detached and copied.
+    body.exercises.reserve(exercises.size());
+    if (exercises.isDetached()) {
+        for (Exercise& exercise : exercises) {
+            body.exercises.append(std::move(exercise));
+        }
+    } else {
+        for (const Exercise& exercise : std::as_const(exercises)) {
+            body.exercises.append(exercise);
+        }
+    }
+    return storeBody(date, std::move(body), status);
+}
+
+bool StorageManager::saveWorkout(const QDate& date, const WorkoutRecord& record)
+{
+    WT_ALLOC_SCOPE("save");
+    // Copy first: `record` may point into the table, which can reallocate.
+    // Records are a body pointer and a status, so this is cheap.
+    return storeRecord(date, WorkoutRecord(record));
+}
+
+bool StorageManager::saveWorkout(const QDate& date, WorkoutRecord&& record)
+{
+    WT_ALLOC_SCOPE("save");
+    return storeRecord(date, std::move(record));
+}
+
+bool StorageManager::storeBody(const QDate& date, WorkoutBody&& body, WorkoutStatus status)
+{
+    // A body not stored yet is moved in, not copied
+    WorkoutRecord workout;
+    workout.body = bodies.intern(std::move(body), strings);
     workout.status = status;
-    
-    workouts[date] = workout;
-    return saveToFile();
+    replaceRecord(date, std::move(workout));
+    return markModified(date);
+}
+
+bool StorageManager::storeRecord(const QDate& date, WorkoutRecord&& workout)
+{
+    // Bodies from elsewhere are swapped for the stored copy with equal content
+    workout.body = bodies.intern(workout.body, strings);
+    replaceRecord(date, std::move(workout));
+    return markModified(date);
+}
+
+void StorageManager::replaceRecord(const QDate& date, WorkoutRecord&& workout)
+{
+    recordUndo(date);
+    const QVector<PersonalRecordIndex::DayBest> replaced = unindexDay(date);
+    const WorkoutRecord* existing = workouts.find(date);
+    streaks.update(date, existing ? existing->status : WorkoutStatus::NoWorkout, workout.status);
+    // Set rows refer to exercises by position, so they only stay valid while
+    // the day keeps the same body
+    if (!existing || existing->body != workout.body) {
+        setLog.removeDay(date);
+    }
+    workouts.insert(date, std::move(workout));
+    indexDay(date, replaced);
+}
+
+bool StorageManager::saveSets(const QDate& date, const QVector<QVector<SetEntry>>& exerciseSets)
+{
+    WT_ALLOC_SCOPE("save-sets");
+    const WorkoutRecord* workout = workouts.find(date);
+    const qsizetype exerciseCount = workout ? workout->exercises().size() : 0;
+
+    recordUndo(date);
+    const QVector<PersonalRecordIndex::DayBest> replaced = unindexDay(date);
+    bool changed = setLog.removeDay(date);
+    for (qsizetype exercise = 0; exercise < qMin(exerciseCount, exerciseSets.size()); ++exercise) {
+        if (!exerciseSets[exercise].isEmpty()) {
+            setLog.setSets(date, int(exercise), exerciseSets[exercise]);
+            changed = true;
+        }
+    }
+    indexDay(date, replaced);
+    return changed ? markModified(date) : true;
+}
+
+bool StorageManager::setStatus(const QDate& date, WorkoutStatus status)
+{
+    WT_ALLOC_SCOPE("status-change");
+    WorkoutRecord* workout = workouts.find(date);
+    if (workout && workout->status == status) {
+        return true;
+    }
+    recordUndo(date);
+    // Missed days do not count towards records
+    const QVector<PersonalRecordIndex::DayBest> replaced = unindexDay(date);
+    if (!workout) {
+        // A planned day becomes a real record the first time it changes
+        WorkoutBodyPtr planned = bodies.intern(recordFromPlan(date).body, strings);
+        workout = &workouts[date];
+        workout->body = std::move(planned);
+    }
+    streaks.update(date, workout->status, status);
+    workout->status = status;
+    indexDay(date, replaced);
+    return markModified(date);
+}
+
+bool StorageManager::setStatus(const QVector<QDate>& dates, WorkoutStatus status)
+{
+    Transaction transaction(*this);
+    for (const QDate& date : dates) {
+        setStatus(date, status);
+    }
+    return transaction.commit();
+}
+
+bool StorageManager::saveTemplate(WorkoutTemplate workout)
+{
+    if (workout.name.isEmpty()) {
+        return false;
+    }
+    workout.name = strings.intern(workout.name);
+    workout.description = strings.intern(workout.description);
+    for (Exercise& exercise : workout.exercises) {
+        exercise.name = strings.intern(exercise.name);
+    }
+    workoutSchedule.setTemplate(std::move(workout));
+    return markScheduleModified();
+}
+
+bool StorageManager::removeTemplate(const QString& name)
+{
+    return workoutSchedule.removeTemplate(name) && markScheduleModified();
+}
+
+bool StorageManager::addRecurrence(const RecurrenceRule& rule)
+{
+    return workoutSchedule.addRule(rule) && markScheduleModified();
+}
+
+bool StorageManager::removeRecurrence(int index)
+{
+    return workoutSchedule.removeRule(index) && markScheduleModified();
+}
+
+const WorkoutTemplate* StorageManager::plannedWorkout(const QDate& date) const
+{
+    return workouts.contains(date) ? nullptr : workoutSchedule.plannedOn(date);
+}
+
+WorkoutRecord StorageManager::recordFromPlan(const QDate& date) const
+{
+    if (const WorkoutTemplate* planned = plannedWorkout(date)) {
+        return WorkoutRecord(WorkoutBody{planned->name, planned->description, planned->exercises});
+    }
+    return WorkoutRecord();
+}
+
+bool StorageManager::markScheduleModified()
+{
+    needsSaving = true;
+    emit scheduleChanged();
+    if (transactionDepth > 0) {
+        return true;
+    }
+    return autoSave ? saveToFile() : true;
+}
+
+bool StorageManager::markModified(const QDate& date)
+{
+    needsSaving = true;
+    if (archivedYears.contains(date.year())) {
+        coldChanges.insert(date);
+    }
+    if (transactionDepth > 0) {
+        pendingChanges.append(date);
+        return true;
+    }
+
+    bool saved = autoSave ? saveToFile() : true;
+    emit workoutsChanged({date});
+    flushPersonalRecords();
+    finishUndoStep();
+    return saved;
+}
+
+DayState StorageManager::dayState(const QDate& date) const
+{
+    DayState state;
+    state.date = date;
+    if (const WorkoutRecord* workout = workouts.find(date)) {
+        state.exists = true;
+        state.record = *workout;
+        if (setLog.hasSets(date)) {
+            state.sets = setLog.daySets(date, int(workout->exercises().size()));
+        }
+    }
+    return state;
+}
+
+void StorageManager::recordUndo(const QDate& date)
+{
+    // Only the first state of a day within a step matters
+    if (restoring || pendingStepDays.contains(date)) {
+        return;
+    }
+    pendingStepDays.insert(date);
+    pendingStep.before.append(dayState(date));
+}
+
+void StorageManager::finishUndoStep()
+{
+    if (pendingStep.before.isEmpty()) {
+        return;
+    }
+
+    UndoStep step;
+    step.text = pendingStep.before.size() == 1
+        ? pendingStep.before.first().date.toString("dd.MM.yyyy")
+        : tr("%n days", "", int(pendingStep.before.size()));
+    // Days that ended up as they started are left out
+    for (const DayState& before : std::as_const(pendingStep.before)) {
+        DayState after = dayState(before.date);
+        if (!(after == before)) {
+            step.before.append(before);
+            step.after.append(std::move(after));
+        }
+    }
+    pendingStep = UndoStep();
+    pendingStepDays.clear();
+
+    if (!step.before.isEmpty()) {
+        history.push(std::move(step));
+        emit undoStateChanged();
+    }
+}
+
+bool StorageManager::undo()
+{
+    if (transactionDepth > 0 || !history.canUndo()) {
+        return false;
+    }
+    restoreDays(history.undo().before);
+    return true;
+}
+
+bool StorageManager::redo()
+{
+    if (transactionDepth > 0 || !history.canRedo()) {
+        return false;
+    }
+    restoreDays(history.redo().after);
+    return true;
+}
+
+bool StorageManager::replaceDays(const QVector<DayState>& states)
+{
+    Transaction transaction(*this);
+    for (DayState state : states) {
+        state.record.body = bodies.intern(state.record.body, strings);
+        recordUndo(state.date);
+        restoreDay(state);
+        markModified(state.date);
+    }
+    return transaction.commit();
+}
+
+void StorageManager::restoreDays(const QVector<DayState>& states)
+{
+    restoring = true;
+    {
+        Transaction transaction(*this);
+        for (const DayState& state : states) {
+            restoreDay(state);
+            markModified(state.date);
+        }
+        // Restoring an old best is not a new record
+        pendingRecords.clear();
+    }
+    restoring = false;
+    emit undoStateChanged();
+}
+
+void StorageManager::restoreDay(const DayState& state)
+{
+    const QDate& date = state.date;
+    const QVector<PersonalRecordIndex::DayBest> replaced = unindexDay(date);
+    const WorkoutRecord* existing = workouts.find(date);
+    streaks.update(date, existing ? existing->status : WorkoutStatus::NoWorkout,
+                   state.exists ? state.record.status : WorkoutStatus::NoWorkout);
+    setLog.removeDay(date);
+    if (state.exists) {
+        workouts.insert(date, WorkoutRecord(state.record));
+        for (qsizetype exercise = 0; exercise < state.sets.size(); ++exercise) {
+            setLog.setSets(date, int(exercise), state.sets[exercise]);
+        }
+    } else {
+        workouts.remove(date);
+    }
+    indexDay(date, replaced);
+}
+
+void StorageManager::clearHistory()
+{
+    pendingStep = UndoStep();
+    pendingStepDays.clear();
+    history.clear();
+    emit undoStateChanged();
+}
+
+QVector<PersonalRecordIndex::DayBest> StorageManager::dayBests(const QDate& date) const
+{
+    const WorkoutRecord* workout = workouts.find(date);
+    return workout ? PersonalRecordIndex::dayBests(date, *workout, setLog)
+                   : QVector<PersonalRecordIndex::DayBest>();
+}
+
+QVector<PersonalRecordIndex::DayBest> StorageManager::unindexDay(const QDate& date)
+{
+    QVector<PersonalRecordIndex::DayBest> bests = dayBests(date);
+    recordIndex.remove(date, bests);
+    if (const WorkoutRecord* workout = workouts.find(date)) {
+        for (const Exercise& exercise : workout->exercises()) {
+            exerciseNames.remove(exercise.name);
+        }
+    }
+    return bests;
+}
+
+void StorageManager::indexDay(const QDate& date, const QVector<PersonalRecordIndex::DayBest>& replaced)
+{
+    recordIndex.add(date, dayBests(date), &pendingRecords, replaced);
+    if (const WorkoutRecord* workout = workouts.find(date)) {
+        for (const Exercise& exercise : workout->exercises()) {
+            exerciseNames.add(exercise.name, date);
+        }
+    }
+}
+
+void StorageManager::rebuildIndexes()
+{
+    recordIndex.clear();
+    exerciseNames.clear();
+    for (const DatedRecord& entry : workouts) {
+        recordIndex.add(entry.date, PersonalRecordIndex::dayBests(entry.date, entry.record, setLog));
+        for (const Exercise& exercise : entry.record.exercises()) {
+            exerciseNames.add(exercise.name, entry.date);
+        }
+    }
+}
+
+void StorageManager::flushPersonalRecords()
+{
+    if (pendingRecords.isEmpty()) {
+        return;
+    }
+
+    // A day saved twice in one transaction (workout, then its sets) may
+    // report the same record twice; keep the last value of each
+    QVector<PersonalRecord> found;
+    found.swap(pendingRecords);
+    QVector<PersonalRecord> unique;
+    for (auto it = found.crbegin(); it != found.crend(); ++it) {
+        const bool seen = std::any_of(unique.cbegin(), unique.cend(), [&](const PersonalRecord& record) {
+            return record.exercise == it->exercise && record.metric == it->metric && record.date == it->date;
+        });
+        // Only records that still stand after the whole change
+        if (!seen && recordIndex.best(it->exercise, it->metric) == it->value) {
+            unique.prepend(*it);
+        }
+    }
+    if (!unique.isEmpty()) {
+        emit personalRecordsSet(unique);
+    }
+}
+
+void StorageManager::setWatchingFile(bool enabled)
+{
+    if (enabled == isWatchingFile()) {
+        return;
+    }
+    if (!enabled) {
+        delete fileWatcher;
+        delete reloadTimer;
+        fileWatcher = nullptr;
+        reloadTimer = nullptr;
+        return;
+    }
+
+    // Sync tools write in pieces; wait for the file to settle
+    reloadTimer = new QTimer(this);
+    reloadTimer->setSingleShot(true);
+    reloadTimer->setInterval(300);
+    connect(reloadTimer, &QTimer::timeout, this, &StorageManager::reloadChangedFile);
+
+    fileWatcher = new QFileSystemWatcher(this);
+    connect(fileWatcher, &QFileSystemWatcher::fileChanged, this, [this] {
+        watchCurrentFile();
+        reloadTimer->start();
+    });
+    // Replacing the file by rename drops it from the watcher; its directory
+    // sees it come back
+    connect(fileWatcher, &QFileSystemWatcher::directoryChanged, this, [this] {
+        if (!fileWatcher->files().contains(dataFilePath) && QFileInfo::exists(dataFilePath)) {
+            watchCurrentFile();
+            reloadTimer->start();
+        }
+    });
+    watchCurrentFile();
+}
+
+void StorageManager::watchCurrentFile()
+{
+    if (!fileWatcher || dataFilePath.isEmpty()) {
+        return;
+    }
+    const QString directory = QFileInfo(dataFilePath).absolutePath();
+    for (const QString& path : fileWatcher->files()) {
+        if (path != dataFilePath) {
+            fileWatcher->removePath(path);
+        }
+    }
+    for (const QString& path : fileWatcher->directories()) {
+        if (path != directory) {
+            fileWatcher->removePath(path);
+        }
+    }
+    if (!fileWatcher->directories().contains(directory)) {
+        fileWatcher->addPath(directory);
+    }
+    if (!fileWatcher->files().contains(dataFilePath) && QFileInfo::exists(dataFilePath)) {
+        fileWatcher->addPath(dataFilePath);
+    }
+}
+
+void StorageManager::reloadChangedFile()
+{
+    // One reload at a time, and none in the middle of a transaction
+    if (reloadWorker || transactionDepth > 0) {
+        reloadTimer->start();
+        return;
+    }
+
+    const QString path = dataFilePath;
+    auto snapshot = std::make_shared<FileSnapshot>();
+    reloadWorker = QThread::create([snapshot, path] { snapshot->read(path); });
+    reloadWorker->setParent(this);
+    connect(reloadWorker, &QThread::finished, this, [this, snapshot, path] {
+        reloadWorker->deleteLater();
+        reloadWorker = nullptr;
+        if (isWatchingFile() && path == dataFilePath) {
+            applyFileChange(*snapshot);
+        }
+    });
+    reloadWorker->start();
+}
+
+void StorageManager::applyFileChange(FileSnapshot& snapshot)
+{
+    // A half-written file fails to parse; the write that completes it
+    // triggers another reload. Our own saves match the known hash.
+    if (!snapshot.valid || snapshot.hash == knownFileHash) {
+        return;
+    }
+    if (transactionDepth > 0) {
+        reloadTimer->start();
+        return;
+    }
+    knownFileHash = snapshot.hash;
+
+    // Both tables are in date order: merge them, collecting the file's
+    // state of every day that differs
+    auto theirState = [&snapshot](const DatedRecord& entry) {
+        DayState state;
+        state.date = entry.date;
+        state.exists = true;
+        state.record = entry.record;
+        if (snapshot.sets.hasSets(entry.date)) {
+            state.sets = snapshot.sets.daySets(entry.date, int(entry.record.exercises().size()));
+        }
+        return state;
+    };
+    auto sameBody = [](const WorkoutBodyPtr& a, const WorkoutBodyPtr& b) {
+        return a == b || (a && b && *a == *b);
+    };
+
+    QVector<DayState> changed;
+    auto ours = workouts.begin();
+    auto theirs = snapshot.records.begin();
+    while (ours != workouts.end() || theirs != snapshot.records.end()) {
+        if (theirs == snapshot.records.end() || (ours != workouts.end() && ours->date < theirs->date)) {
+            DayState removed;
+            removed.date = ours->date;
+            changed.append(removed);
+            ++ours;
+        } else if (ours == workouts.end() || theirs->date < ours->date) {
+            changed.append(theirState(*theirs));
+            ++theirs;
+        } else {
+            DayState state = theirState(*theirs);
+            const DayState current = dayState(ours->date);
+            if (state.record.status != current.record.status
+                || !sameBody(state.record.body, current.record.body) || state.sets != current.sets) {
+                changed.append(std::move(state));
+            }
+            ++ours;
+            ++theirs;
+        }
+    }
+
+    restoring = true;
+    for (DayState& state : changed) {
+        state.record.body = bodies.intern(state.record.body, strings);
+        restoreDay(state);
+    }
+    restoring = false;
+    // Bests set elsewhere were announced there
+    pendingRecords.clear();
+    // The store now matches the file and its archives
+    std::swap(archivedYears, snapshot.archivedYears);
+    std::swap(coldChanges, snapshot.overrides);
+
+    if (workoutSchedule.templatesToJson() != snapshot.schedule.templatesToJson()
+        || workoutSchedule.rulesToJson() != snapshot.schedule.rulesToJson()) {
+        std::swap(workoutSchedule, snapshot.schedule);
+        emit scheduleChanged();
+    }
+
+    if (!changed.isEmpty()) {
+        qInfo() << "Applied" << changed.size() << "changed days from" << dataFilePath;
+        clearHistory();
+        QVector<QDate> dates;
+        dates.reserve(changed.size());
+        for (const DayState& state : std::as_const(changed)) {
+            dates.append(state.date);
+        }
+        emit workoutsChanged(dates);
+    }
+}
+
+const WorkoutRecord* StorageManager::find(const QDate& date) const
+{
+    return workouts.find(date);
 }
 
 bool StorageManager::loadWorkout(const QDate& date,
@@ -153,27 +1292,27 @@ bool StorageManager::loadWorkout(const QDate& date,
                                QVector<Exercise>& exercises,
                                WorkoutStatus& status)
 {
-    if (!workouts.contains(date)) {
+    WT_ALLOC_SCOPE("load");
+    const WorkoutRecord* workout = find(date);
+    if (!workout) {
         return false;
     }
     
-    const WorkoutData& workout = workouts[date];
-    name = workout.name;
-    description = workout.description;
-    exercises = workout.exercises;
-    status = workout.status;
+    name = workout->name();
+    description = workout->description();
+    exercises = toVector(workout->exercises());
+    status = workout->status;
     return true;
 }
 
-QJsonObject StorageManager::workoutToJson(const WorkoutData& workout) const
+QJsonObject StorageManager::bodyToJson(const WorkoutBody& body) const
 {
     QJsonObject json;
-    json["name"] = workout.name;
-    json["description"] = workout.description;
-    json["status"] = static_cast<int>(workout.status);
+    json["name"] = body.name;
+    json["description"] = body.description;
     
     QJsonArray exercisesArray;
-    for (const Exercise& exercise : workout.exercises) {
+    for (const Exercise& exercise : body.exercises) {
         QJsonObject exerciseObj;
         exerciseObj["name"] = exercise.name;
         exerciseObj["sets"] = exercise.sets;
@@ -184,23 +1323,3 @@ QJsonObject StorageManager::workoutToJson(const WorkoutData& workout) const
     json["exercises"] = exercisesArray;
     return json;
 }
-
-StorageManager::WorkoutData StorageManager::workoutFromJson(const QJsonObject& json) const
-{
-    WorkoutData workout;
-    workout.name = json["name"].toString();
-    workout.description = json["description"].toString();
-    workout.status = static_cast<WorkoutStatus>(json["status"].toInt(0));
-    
-    QJsonArray exercisesArray = json["exercises"].toArray();
-    for (const QJsonValue& value : exercisesArray) {
-        QJsonObject exerciseObj = value.toObject();
-        Exercise exercise;
-        exercise.name = exerciseObj["name"].toString();
-        exercise.sets = exerciseObj["sets"].toInt();
-        exercise.reps = exerciseObj["reps"].toInt();
-        workout.exercises.append(exercise);
-    }
-    
-    return workout;
-}
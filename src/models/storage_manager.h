@@ -2,58 +2,272 @@
 #ifndef STORAGE_MANAGER_H
 #define STORAGE_MANAGER_H
 
+#include <QObject>
 #include <QString>
 #include <QDate>
 #include <QJsonObject>
-#include <QJsonArray>
-#include <QMap>
-#include <QDebug>
+#include <QVector>
 #include "types.h"
 #include "workout_status.h"
+#include "record_table.h"
+#include "string_pool.h"
+#include "body_store.h"
+#include "schedule.h"
+#include "set_log.h"
+#include "streak_tracker.h"
+#include "personal_records.h"
+#include "exercise_name_index.h"
+#include "undo_history.h"
+#include "archive_blocks.h"
+#include <QMap>
+#include <QSet>
+
+class QFileSystemWatcher;
+class QThread;
+class QTimer;
+struct FileSnapshot;
 
-class StorageManager {
+class StorageManager : public QObject {
+    Q_OBJECT
 public:
+    // Application-wide store backed by the file in AppDataLocation
     static StorageManager& instance();
+
+    // Standalone stores for tools that work on several files at once
+    explicit StorageManager(QObject* parent = nullptr);
+    // Waits for a reload that is still reading the file
+    ~StorageManager() override;
+
+    // Groups changes: inside a transaction they are only recorded, and the
+    // outermost commitTransaction() saves once and emits workoutsChanged()
+    // once for all touched days. Transactions nest.
+    void beginTransaction();
+    bool commitTransaction();
+    bool isInTransaction() const { return transactionDepth > 0; }
+
+    // Commits on destruction unless commit() was called
+    class Transaction {
+    public:
+        explicit Transaction(StorageManager& store) : store(store) { store.beginTransaction(); }
+        ~Transaction() { if (!committed) store.commitTransaction(); }
+        Transaction(const Transaction&) = delete;
+        Transaction& operator=(const Transaction&) = delete;
+        bool commit() { committed = true; return store.commitTransaction(); }
+
+    private:
+        StorageManager& store;
+        bool committed = false;
+    };
+
+    // When disabled, saveWorkout() only marks the store modified and the
+    // caller is responsible for calling saveToFile()
+    void setAutoSave(bool enabled) { autoSave = enabled; }
+    bool isAutoSave() const { return autoSave; }
+    bool isModified() const { return needsSaving; }
     
     bool saveWorkout(const QDate& date,
                     const QString& name,
                     const QString& description,
                     const QVector<Exercise>& exercises,
                     WorkoutStatus status);
+    bool saveWorkout(const QDate& date,
+                    QString&& name,
+                    QString&& description,
+                    QVector<Exercise>&& exercises,
+                    WorkoutStatus status);
+    bool saveWorkout(const QDate& date, const WorkoutRecord& record);
+    bool saveWorkout(const QDate& date, WorkoutRecord&& record);
+
+    // Changes only the status, creating an empty record if the day has none
+    bool setStatus(const QDate& date, WorkoutStatus status);
+    // The same for several days, as one transaction
+    bool setStatus(const QVector<QDate>& dates, WorkoutStatus status);
+
+    // Optional per-set detail, by exercise position in the day's workout.
+    // Replaces the day's rows; lists past the last exercise are ignored.
+    // Saving a different workout over the day drops its rows.
+    bool saveSets(const QDate& date, const QVector<QVector<SetEntry>>& exerciseSets);
+    const SetLog& sets() const { return setLog; }
+
+    // Completed-session streaks and adherence, kept current on every change
+    const StreakTracker& streakTracker() const { return streaks; }
+    // Per-exercise bests, kept current on every change
+    const PersonalRecordIndex& personalRecords() const { return recordIndex; }
+    // Exercise names in use, for completion; kept current on every change
+    const ExerciseNameIndex& exerciseNameIndex() const { return exerciseNames; }
+
+    // Reverts or reapplies the last change to workouts or set detail: one
+    // save, status change or transaction per step. Schedule edits are not
+    // recorded. Loading a file or clearing the store forgets the history.
+    bool undo();
+    bool redo();
+    bool canUndo() const { return history.canUndo(); }
+    bool canRedo() const { return history.canRedo(); }
+    QString undoText() const { return history.undoText(); }
+    QString redoText() const { return history.redoText(); }
+
+    // A day's record and set detail, as undo, merges and sync exchange them
+    DayState dayState(const QDate& date) const;
+    // Stores each state over its day as one undoable change. States may
+    // come from another store, as merge results do.
+    bool replaceDays(const QVector<DayState>& states);
+
+    // Templates and recurring plans. A planned day has no record until it
+    // is edited or given a status, so a long program costs one rule.
+    const Schedule& schedule() const { return workoutSchedule; }
+    bool saveTemplate(WorkoutTemplate workout);
+    bool removeTemplate(const QString& name);
+    bool addRecurrence(const RecurrenceRule& rule);
+    bool removeRecurrence(int index);
+    // Template planned for `date`, or null if the day has a record of its
+    // own or nothing is planned
+    const WorkoutTemplate* plannedWorkout(const QDate& date) const;
+    // A record for `date` built from its planned template, not yet stored
+    WorkoutRecord recordFromPlan(const QDate& date) const;
                     
     bool loadWorkout(const QDate& date,
                     QString& name,
                     QString& description,
                     QVector<Exercise>& exercises,
                     WorkoutStatus& status);
+
+    // Read-only access without copying. The pointer is null when the day has
+    // no workout and is invalidated by the next change to the store.
+    const WorkoutRecord* find(const QDate& date) const;
+    // All records in date order
+    const RecordTable& records() const { return workouts; }
     
+    // Without a filename, saveToFile() writes back to the file last loaded
+    // and loadFromFile() reads the default location.
+    //
+    // The file last loaded holds only the hot tier: the current year and
+    // any later changes to closed years. Each closed year is written once
+    // to a compressed, read-only archive next to it (workouts-2023.archive
+    // beside workouts.json) by the first save after the year ends, and is
+    // rewritten only when many of its days have changed since. Loading
+    // reads the archives as well, so every day stays reachable through the
+    // usual calls. Saving to any other file writes everything.
+    //
+    // The data file lists its archives with their size and checksum.
+    // Loading fails when a listed archive is missing, and when one does not
+    // match unless salvaging; archives it does not list are ignored. A save
+    // first rewrites any listed archive whose size or checksum changed on
+    // disk (the checksum is only re-read when the modification time moved);
+    // if that fails, the year's days are saved in the data file instead.
+    //
+    // Every record is saved with a checksum, and a damaged file or archive
+    // fails the load. With salvaging enabled, loading instead keeps what is
+    // intact, leaves the original beside it as FILE.damaged and marks the
+    // store modified, so the next save writes the repaired data; it fails
+    // only if nothing could be recovered. Salvaging is off by default so
+    // read-only users never rewrite files; the application's store and
+    // `workout-cli repair` turn it on.
     bool saveToFile(const QString& filename = QString());
     bool loadFromFile(const QString& filename = QString());
+    // With archiving off, saving to the file last loaded writes everything
+    // to it as well and lists no archives; on by default
+    void setArchiving(bool enabled) { archiving = enabled; }
+    bool isArchiving() const { return archiving; }
+    void setSalvageDamaged(bool enabled) { salvageDamaged = enabled; }
+    bool isSalvagingDamaged() const { return salvageDamaged; }
+    QString filePath() const { return dataFilePath; }
+
+    // Follows changes other programs (or other machines, through a synced
+    // folder) make to the data file. New content is parsed on a worker
+    // thread and only the days that differ from the store are replaced,
+    // each reported through workoutsChanged(); the file wins for those
+    // days. Applying a change forgets the undo history. Off by default.
+    void setWatchingFile(bool enabled);
+    bool isWatchingFile() const { return fileWatcher != nullptr; }
     
+    // Exchanges everything stored with `other`, which takes over this
+    // store's data and file. Nothing is parsed or copied, so it is instant.
+    // Neither store may be in a transaction. Emits no workoutsChanged():
+    // views must reload everything.
+    void swapContents(StorageManager& other);
+    // Approximate heap use of the stored data, for caches of stores
+    qsizetype memoryUsage() const;
+
     void clearAllData();
     QVector<QDate> getAllWorkoutDates() const;
     bool hasWorkout(const QDate& date) const;
 
-private:
-    StorageManager() = default;
-    StorageManager(const StorageManager&) = delete;
-    StorageManager& operator=(const StorageManager&) = delete;
-
-    struct WorkoutData {
-        QString name;
-        QString description;
-        QVector<Exercise> exercises;
-        WorkoutStatus status;
-    };
+signals:
+    // Days whose record was saved, changed or removed through this store,
+    // in date order, including days changed in the watched file. Not
+    // emitted by loadFromFile().
+    void workoutsChanged(const QVector<QDate>& dates);
+    // Templates or recurrence rules changed; planned days may differ anywhere
+    void scheduleChanged();
+    // A save set new personal bests. Emitted with workoutsChanged(), after
+    // the outermost transaction commits.
+    void personalRecordsSet(const QVector<PersonalRecord>& records);
+    // canUndo(), canRedo() or their texts may have changed
+    void undoStateChanged();
 
-    QMap<QDate, WorkoutData> workouts;
+private:
+    RecordTable workouts;
+    StringPool strings;
+    BodyStore bodies;
+    SetLog setLog;
+    StreakTracker streaks;
+    PersonalRecordIndex recordIndex;
+    ExerciseNameIndex exerciseNames;
+    Schedule workoutSchedule;
+    UndoHistory history;
+    QString dataFilePath;
     
     QString getWorkoutFilePath();
-    QJsonObject workoutToJson(const WorkoutData& workout) const;
-    WorkoutData workoutFromJson(const QJsonObject& json) const;
+    QJsonObject bodyToJson(const WorkoutBody& body) const;
+    QJsonObject daysToJson(const QVector<QDate>& dates) const;
+    QVector<QDate> hotDates() const;
+    void archiveClosedYears();
+    bool isArchiveIntact(int year);
+    bool writeArchive(int year);
+    bool storeBody(const QDate& date, WorkoutBody&& body, WorkoutStatus status);
+    bool storeRecord(const QDate& date, WorkoutRecord&& workout);
+    void replaceRecord(const QDate& date, WorkoutRecord&& workout);
+    QVector<PersonalRecordIndex::DayBest> dayBests(const QDate& date) const;
+    // unindexDay() returns what the day contributed, for indexDay() to tell
+    // a new record from one the day already held
+    QVector<PersonalRecordIndex::DayBest> unindexDay(const QDate& date);
+    void indexDay(const QDate& date, const QVector<PersonalRecordIndex::DayBest>& replaced);
+    void rebuildIndexes();
+    void flushPersonalRecords();
+    bool markModified(const QDate& date);
+    bool markScheduleModified();
+    void recordUndo(const QDate& date);
+    void finishUndoStep();
+    void restoreDays(const QVector<DayState>& states);
+    void restoreDay(const DayState& state);
+    void clearHistory();
+    void watchCurrentFile();
+    void reloadChangedFile();
+    void applyFileChange(FileSnapshot& snapshot);
 
     bool needsSaving = false;
     bool isSaving = false;
+    bool autoSave = true;
+    bool salvageDamaged = false;
+    bool archiving = true;
+    int transactionDepth = 0;
+    QVector<QDate> pendingChanges;
+    QVector<PersonalRecord> pendingRecords;
+    // Days changed since the last undo step, as they were before
+    UndoStep pendingStep;
+    QSet<QDate> pendingStepDays;
+    bool restoring = false;
+    QFileSystemWatcher* fileWatcher = nullptr;
+    QTimer* reloadTimer = nullptr;
+    // Reads the changed file off the GUI thread; null when no reload runs
+    QThread* reloadWorker = nullptr;
+    // Of the file content last loaded or saved, to tell our own writes apart
+    size_t knownFileHash = 0;
+    // Closed years with an archive, and their days changed since it was
+    // written; the data file carries those days or their removal, and
+    // lists every archive with its stamp
+    QMap<int, ArchiveStamp> archivedYears;
+    QSet<QDate> coldChanges;
 };
 
 #endif // STORAGE_MANAGER_H
\ No newline at end of file
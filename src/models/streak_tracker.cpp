@@ -0,0 +1,252 @@
+// streak_tracker.cpp
+#include "streak_tracker.h"
+#include "record_table.h"
+#include <algorithm>
+
+namespace {
+
+// Room added around the covered days when the counters grow, so logging
+// day after day only rebuilds them now and then
+constexpr qsizetype GrowthMargin = 366;
+
+} // namespace
+
+void StreakTracker::DayCounter::add(qsizetype index, int delta)
+{
+    counts[index] += delta;
+    for (qsizetype i = index; i < tree.size(); i |= i + 1) {
+        tree[i] += delta;
+    }
+}
+
+int StreakTracker::DayCounter::prefix(qsizetype count) const
+{
+    int sum = 0;
+    for (qsizetype i = std::min(count, tree.size()) - 1; i >= 0; i = (i & (i + 1)) - 1) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+void StreakTracker::DayCounter::rebuild(qsizetype shift, qsizetype size)
+{
+    QVector<int> moved(size, 0);
+    for (qsizetype i = 0; i < counts.size(); ++i) {
+        moved[i + shift] = counts[i];
+    }
+    assign(std::move(moved));
+}
+
+void StreakTracker::DayCounter::assign(QVector<int> values)
+{
+    counts = std::move(values);
+
+    // Linear-time construction: each node passes its sum to its parent
+    const qsizetype size = counts.size();
+    tree = counts;
+    for (qsizetype i = 0; i < size; ++i) {
+        const qsizetype parent = i | (i + 1);
+        if (parent < size) {
+            tree[parent] += tree[i];
+        }
+    }
+}
+
+void StreakTracker::clear()
+{
+    baseDay = 0;
+    completed = DayCounter();
+    missed = DayCounter();
+    segments.clear();
+    lengths.clear();
+    segments.insert(FirstSegment, 0);
+    lengths.insert(0);
+}
+
+void StreakTracker::reset(const RecordTable& records)
+{
+    clear();
+    if (records.isEmpty()) {
+        return;
+    }
+
+    const QDate first = records.begin()->date;
+    const QDate last = (records.end() - 1)->date;
+    baseDay = first.toJulianDay() - GrowthMargin;
+    const qsizetype size = indexOf(last) + 1 + GrowthMargin;
+
+    // One pass in date order; the trees are built once at the end
+    QVector<int> completedDays(size, 0);
+    QVector<int> missedDays(size, 0);
+    auto segment = segments.begin();
+    int length = 0;
+    for (const DatedRecord& entry : records) {
+        if (entry.record.status == WorkoutStatus::Completed) {
+            ++completedDays[indexOf(entry.date)];
+            ++length;
+        } else if (entry.record.status == WorkoutStatus::Missed) {
+            ++missedDays[indexOf(entry.date)];
+            setSegmentLength(segment, length);
+            segment = segments.insert(entry.date.toJulianDay(), 0);
+            lengths.insert(0);
+            length = 0;
+        }
+    }
+    setSegmentLength(segment, length);
+
+    completed.assign(std::move(completedDays));
+    missed.assign(std::move(missedDays));
+}
+
+void StreakTracker::update(const QDate& date, WorkoutStatus before, WorkoutStatus after)
+{
+    if (before == after || !date.isValid()) {
+        return;
+    }
+    if (segments.isEmpty()) {
+        clear();
+    }
+    ensureCovers(date);
+
+    if (before == WorkoutStatus::Completed) {
+        addCompleted(date, -1);
+    } else if (before == WorkoutStatus::Missed) {
+        removeMissed(date);
+    }
+
+    if (after == WorkoutStatus::Completed) {
+        addCompleted(date, 1);
+    } else if (after == WorkoutStatus::Missed) {
+        addMissed(date);
+    }
+}
+
+int StreakTracker::currentStreak() const
+{
+    return segments.isEmpty() ? 0 : segments.last();
+}
+
+int StreakTracker::longestStreak() const
+{
+    return lengths.empty() ? 0 : *lengths.rbegin();
+}
+
+int StreakTracker::countBetween(const DayCounter& counter, const QDate& from, const QDate& to) const
+{
+    if (counter.size() == 0 || to < from) {
+        return 0;
+    }
+    const qsizetype first = std::max<qsizetype>(indexOf(from), 0);
+    const qsizetype last = std::min<qsizetype>(indexOf(to), counter.size() - 1);
+    return last < first ? 0 : counter.prefix(last + 1) - counter.prefix(first);
+}
+
+int StreakTracker::completedBetween(const QDate& from, const QDate& to) const
+{
+    return countBetween(completed, from, to);
+}
+
+int StreakTracker::missedBetween(const QDate& from, const QDate& to) const
+{
+    return countBetween(missed, from, to);
+}
+
+double StreakTracker::adherence(const QDate& last, int days) const
+{
+    const QDate from = last.addDays(1 - days);
+    const int done = completedBetween(from, last);
+    const int sessions = done + missedBetween(from, last);
+    return sessions > 0 ? double(done) / sessions : -1.0;
+}
+
+void StreakTracker::ensureCovers(const QDate& date)
+{
+    qsizetype index = indexOf(date);
+    if (completed.size() > 0 && index >= 0 && index < completed.size()) {
+        return;
+    }
+
+    if (completed.size() == 0) {
+        baseDay = date.toJulianDay() - GrowthMargin;
+        completed.rebuild(0, 2 * GrowthMargin + 1);
+        missed.rebuild(0, 2 * GrowthMargin + 1);
+        return;
+    }
+
+    // Grow by at least the current size so rebuilds stay amortized O(1)
+    qsizetype shift = 0;
+    qsizetype size = completed.size();
+    if (index < 0) {
+        shift = -index + std::max(GrowthMargin, size);
+    } else {
+        size = std::max(index + 1 + GrowthMargin, 2 * size);
+    }
+    size += shift;
+    baseDay -= shift;
+    completed.rebuild(shift, size);
+    missed.rebuild(shift, size);
+}
+
+QMap<qint64, int>::iterator StreakTracker::segmentOf(qint64 day)
+{
+    // The segment opened by the last missed day at or before `day`
+    auto it = segments.upperBound(day);
+    return --it;
+}
+
+void StreakTracker::setSegmentLength(QMap<qint64, int>::iterator segment, int length)
+{
+    lengths.erase(lengths.find(segment.value()));
+    lengths.insert(length);
+    segment.value() = length;
+}
+
+void StreakTracker::addCompleted(const QDate& date, int delta)
+{
+    completed.add(indexOf(date), delta);
+    auto segment = segmentOf(date.toJulianDay());
+    setSegmentLength(segment, segment.value() + delta);
+}
+
+void StreakTracker::addMissed(const QDate& date)
+{
+    const qint64 day = date.toJulianDay();
+    missed.add(indexOf(date), 1);
+    if (segments.contains(day)) {
+        return;  // Already a segment boundary
+    }
+
+    // Split: the completed days after `date` move to the new segment
+    auto segment = segmentOf(day);
+    auto next = std::next(segment);
+    const QDate end = next == segments.end() ? QDate::fromJulianDay(baseDay + completed.size() - 1)
+                                             : QDate::fromJulianDay(next.key() - 1);
+    const int moved = completedBetween(date.addDays(1), end);
+    setSegmentLength(segment, segment.value() - moved);
+    segments.insert(day, moved);
+    lengths.insert(moved);
+}
+
+void StreakTracker::removeMissed(const QDate& date)
+{
+    const qint64 day = date.toJulianDay();
+    missed.add(indexOf(date), -1);
+    auto segment = segments.find(day);
+    if (segment == segments.end() || missedBetween(date, date) > 0) {
+        return;
+    }
+
+    // Join with the segment before it
+    const int length = segment.value();
+    lengths.erase(lengths.find(length));
+    segment = segments.erase(segment);
+    auto previous = std::prev(segment);
+    setSegmentLength(previous, previous.value() + length);
+}
+
+qsizetype StreakTracker::memoryUsage() const
+{
+    return completed.memoryUsage() + missed.memoryUsage()
+         + segments.size() * (ContainerNodeBytes + qsizetype(sizeof(qint64) + sizeof(int)))
+         + qsizetype(lengths.size()) * (ContainerNodeBytes + qsizetype(sizeof(int)));
+}
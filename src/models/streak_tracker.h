@@ -0,0 +1,78 @@
+// streak_tracker.h
+#ifndef STREAK_TRACKER_H
+#define STREAK_TRACKER_H
+
+#include <QDate>
+#include <QMap>
+#include <QVector>
+#include <limits>
+#include <set>
+#include "workout_status.h"
+
+class RecordTable;
+
+// Streaks and adherence over the per-day status stream, kept up to date as
+// single days change instead of rescanning the history.
+//
+// A streak is a run of completed sessions with no missed session between
+// them; rest days and days without a status neither extend nor break it.
+// Missed days cut the history into segments; each segment's completed
+// count is one streak. Changing a day adjusts one segment, or splits or
+// joins two when a missed day appears or goes away, in O(log n).
+class StreakTracker {
+public:
+    void reset(const RecordTable& records);
+    void clear();
+    qsizetype memoryUsage() const;
+    void update(const QDate& date, WorkoutStatus before, WorkoutStatus after);
+
+    // Completed sessions since the last missed one
+    int currentStreak() const;
+    int longestStreak() const;
+
+    int completedBetween(const QDate& from, const QDate& to) const;
+    int missedBetween(const QDate& from, const QDate& to) const;
+    // Share of sessions completed, of those completed or missed, in the
+    // `days` days ending on `last`; negative if there were none
+    double adherence(const QDate& last, int days) const;
+
+private:
+    // Per-day counts with prefix sums in O(log n) (a Fenwick tree)
+    class DayCounter {
+    public:
+        qsizetype size() const { return counts.size(); }
+        qsizetype memoryUsage() const { return (counts.capacity() + tree.capacity()) * qsizetype(sizeof(int)); }
+        void add(qsizetype index, int delta);
+        int prefix(qsizetype count) const;  // Sum over [0, count)
+        void assign(QVector<int> values);
+        // Moves the counts up by `shift` days and makes room for `size`
+        void rebuild(qsizetype shift, qsizetype size);
+
+    private:
+        QVector<int> counts;
+        QVector<int> tree;
+    };
+
+    qsizetype indexOf(const QDate& date) const { return qsizetype(date.toJulianDay() - baseDay); }
+    void ensureCovers(const QDate& date);
+    int countBetween(const DayCounter& counter, const QDate& from, const QDate& to) const;
+
+    void addCompleted(const QDate& date, int delta);
+    void addMissed(const QDate& date);
+    void removeMissed(const QDate& date);
+    QMap<qint64, int>::iterator segmentOf(qint64 day);
+    void setSegmentLength(QMap<qint64, int>::iterator segment, int length);
+
+    static constexpr qint64 FirstSegment = std::numeric_limits<qint64>::min();
+
+    qint64 baseDay = 0;  // Julian day of counter index 0
+    DayCounter completed;
+    DayCounter missed;
+    // Completed count per segment, keyed by the Julian day of the missed
+    // day that opens it; the segment before the first missed day has
+    // FirstSegment as its key
+    QMap<qint64, int> segments;
+    std::multiset<int> lengths;
+};
+
+#endif // STREAK_TRACKER_H
@@ -0,0 +1,26 @@
+// string_pool.cpp
+#include "string_pool.h"
+#include "types.h"
+
+QString StringPool::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return QString();
+    }
+
+    auto it = strings.constFind(value);
+    if (it != strings.cend()) {
+        return *it;
+    }
+    strings.insert(value);
+    return value;
+}
+
+qsizetype StringPool::memoryUsage() const
+{
+    qsizetype bytes = strings.capacity() * qsizetype(sizeof(QString));
+    for (const QString& value : strings) {
+        bytes += ContainerNodeBytes + stringHeapBytes(value);
+    }
+    return bytes;
+}
@@ -0,0 +1,23 @@
+// string_pool.h
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <QSet>
+#include <QString>
+
+// Interns strings so that equal names share one implicitly shared buffer.
+// Workout and exercise names repeat across thousands of records; with the
+// pool each distinct name costs a single heap block.
+class StringPool {
+public:
+    QString intern(const QString& value);
+    void clear() { strings.clear(); }
+    qsizetype size() const { return strings.size(); }
+    // Heap bytes of the set and of every pooled buffer
+    qsizetype memoryUsage() const;
+
+private:
+    QSet<QString> strings;
+};
+
+#endif // STRING_POOL_H
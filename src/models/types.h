@@ -1,13 +1,98 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <QHashFunctions>
 #include <QString>
+#include <QVarLengthArray>
 #include <QVector>
+#include <memory>
+#include <utility>
+#include "workout_status.h"
 
 struct Exercise {
     QString name;
     int sets;
     int reps;
 };
+Q_DECLARE_TYPEINFO(Exercise, Q_RELOCATABLE_TYPE);
 
-#endif // TYPES_H
\ No newline at end of file
+// For memory estimates: the bookkeeping of one entry of a node-based
+// container (map node links, hash span slot) beyond the entry itself, and
+// the heap block of a string (counted by whoever owns the shared copy)
+constexpr qsizetype ContainerNodeBytes = 4 * qsizetype(sizeof(void*));
+inline qsizetype stringHeapBytes(const QString& value)
+{
+    return value.capacity() > 0 ? 16 + (value.capacity() + 1) * qsizetype(sizeof(QChar)) : 0;
+}
+
+// Typical workouts have 3-10 exercises; up to this many are stored inside
+// the record itself instead of in a separate heap block
+constexpr int InlineExerciseCount = 8;
+using ExerciseList = QVarLengthArray<Exercise, InlineExerciseCount>;
+
+inline QVector<Exercise> toVector(const ExerciseList& exercises)
+{
+    return QVector<Exercise>(exercises.cbegin(), exercises.cend());
+}
+
+inline ExerciseList toExerciseList(const QVector<Exercise>& exercises)
+{
+    return ExerciseList(exercises.cbegin(), exercises.cend());
+}
+
+inline bool operator==(const Exercise& a, const Exercise& b)
+{
+    return a.sets == b.sets && a.reps == b.reps && a.name == b.name;
+}
+
+// What a day's workout consists of. The same few bodies repeat across a
+// history, so StorageManager keeps each distinct body once and records
+// share it.
+struct WorkoutBody {
+    QString name;
+    QString description;
+    ExerciseList exercises;
+
+    bool isEmpty() const { return name.isEmpty() && description.isEmpty() && exercises.isEmpty(); }
+};
+
+inline bool operator==(const WorkoutBody& a, const WorkoutBody& b)
+{
+    return a.name == b.name && a.description == b.description && a.exercises == b.exercises;
+}
+
+inline size_t qHash(const WorkoutBody& body, size_t seed = 0)
+{
+    size_t hash = qHashMulti(seed, body.name, body.description);
+    for (const Exercise& exercise : body.exercises) {
+        hash = qHashMulti(hash, exercise.name, exercise.sets, exercise.reps);
+    }
+    return hash;
+}
+
+using WorkoutBodyPtr = std::shared_ptr<const WorkoutBody>;
+
+// One day's stored workout: a shared, immutable body plus the day's status.
+// Days with only a status have no body.
+struct WorkoutRecord {
+    WorkoutBodyPtr body;
+    WorkoutStatus status = WorkoutStatus::NoWorkout;
+
+    WorkoutRecord() = default;
+    explicit WorkoutRecord(WorkoutBody content, WorkoutStatus status = WorkoutStatus::NoWorkout)
+        : body(content.isEmpty() ? nullptr : std::make_shared<const WorkoutBody>(std::move(content)))
+        , status(status)
+    {
+    }
+
+    const QString& name() const { return content().name; }
+    const QString& description() const { return content().description; }
+    const ExerciseList& exercises() const { return content().exercises; }
+    const WorkoutBody& content() const
+    {
+        static const WorkoutBody empty;
+        return body ? *body : empty;
+    }
+};
+
+#endif // TYPES_H
@@ -0,0 +1,19 @@
+// undo_history.cpp
+#include "undo_history.h"
+
+void UndoHistory::push(UndoStep step)
+{
+    // A new change discards whatever could have been redone
+    steps.resize(position);
+    steps.append(std::move(step));
+    if (steps.size() > limit) {
+        steps.removeFirst();
+    }
+    position = steps.size();
+}
+
+void UndoHistory::clear()
+{
+    steps.clear();
+    position = 0;
+}
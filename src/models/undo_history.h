@@ -0,0 +1,58 @@
+// undo_history.h
+#ifndef UNDO_HISTORY_H
+#define UNDO_HISTORY_H
+
+#include <QDate>
+#include <QString>
+#include <QVector>
+#include "types.h"
+#include "set_log.h"
+
+// One day as it was before or after a change
+struct DayState {
+    QDate date;
+    bool exists = false;
+    WorkoutRecord record;
+    QVector<QVector<SetEntry>> sets;  // Per exercise, as in SetLog::daySets()
+};
+
+inline bool operator==(const DayState& a, const DayState& b)
+{
+    return a.date == b.date && a.exists == b.exists && a.record.status == b.record.status
+        && a.record.body == b.record.body && a.sets == b.sets;
+}
+
+// A change to some days, undone by restoring `before` and redone by
+// restoring `after`
+struct UndoStep {
+    QString text;
+    QVector<DayState> before;
+    QVector<DayState> after;
+};
+
+// Linear undo/redo history. A step holds only the days it changed, and a
+// day's record is a shared body pointer and a status, so each version of
+// the store shares everything else with its neighbours; hundreds of steps
+// cost about as much as the records they touched.
+class UndoHistory {
+public:
+    void push(UndoStep step);
+    void clear();
+    void setLimit(qsizetype steps) { limit = steps; }
+
+    bool canUndo() const { return position > 0; }
+    bool canRedo() const { return position < steps.size(); }
+    QString undoText() const { return canUndo() ? steps[position - 1].text : QString(); }
+    QString redoText() const { return canRedo() ? steps[position].text : QString(); }
+
+    // Move through the history and return the step to apply
+    const UndoStep& undo() { return steps[--position]; }
+    const UndoStep& redo() { return steps[position++]; }
+
+private:
+    QVector<UndoStep> steps;
+    qsizetype position = 0;  // Steps before this are done
+    qsizetype limit = 500;
+};
+
+#endif // UNDO_HISTORY_H
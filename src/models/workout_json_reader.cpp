@@ -0,0 +1,968 @@
+// workout_json_reader.cpp
+#include "workout_json_reader.h"
+#include "record_table.h"
+#include "string_pool.h"
+#include "body_store.h"
+#include "checksum.h"
+#include <QDate>
+#include <QDebug>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+constexpr int MaxNesting = 256;
+// Salvage chunks are at least this large, so small files use one thread
+constexpr qsizetype MinSalvageChunk = 1 << 20;
+
+template <size_t N>
+bool keyIs(QByteArrayView key, const char (&name)[N])
+{
+    return key.size() == qsizetype(N - 1) && std::memcmp(key.data(), name, N - 1) == 0;
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+int digitsValue(const char* text, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        value = value * 10 + (text[i] - '0');
+    }
+    return value;
+}
+
+// "yyyy-MM-dd" without going through QString; anything else is left to
+// QDate::fromString()
+QDate parseIsoDate(QByteArrayView text)
+{
+    const char* s = text.data();
+    if (text.size() == 10 && s[4] == '-' && s[7] == '-'
+        && isDigit(s[0]) && isDigit(s[1]) && isDigit(s[2]) && isDigit(s[3])
+        && isDigit(s[5]) && isDigit(s[6]) && isDigit(s[8]) && isDigit(s[9])) {
+        return QDate(digitsValue(s, 4), digitsValue(s + 5, 2), digitsValue(s + 8, 2));
+    }
+    return QDate::fromString(QString::fromUtf8(text), Qt::ISODate);
+}
+
+void appendUtf8(QByteArray& out, char32_t code)
+{
+    if (code < 0x80) {
+        out.append(char(code));
+    } else if (code < 0x800) {
+        out.append(char(0xC0 | (code >> 6)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+        out.append(char(0xE0 | (code >> 12)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    } else {
+        out.append(char(0xF0 | (code >> 18)));
+        out.append(char(0x80 | ((code >> 12) & 0x3F)));
+        out.append(char(0x80 | ((code >> 6) & 0x3F)));
+        out.append(char(0x80 | (code & 0x3F)));
+    }
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+enum class ElementKind { None, Record, Body };
+
+// What the object opening at `brace` is, judged by its first key: objects
+// are written with sorted keys, so a record starts with "body", "crc",
+// "date" or "status" and a shared body with "description". Exercises
+// start with "name" and are never taken for either.
+ElementKind elementAt(const char* brace, const char* end)
+{
+    const char* p = brace + 1;
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+    const QByteArrayView rest(p, std::min<qsizetype>(end - p, 14));
+    if (rest.startsWith("\"body\"") || rest.startsWith("\"crc\"")
+        || rest.startsWith("\"date\"") || rest.startsWith("\"status\"")) {
+        return ElementKind::Record;
+    }
+    if (rest.startsWith("\"description\"")) {
+        return ElementKind::Body;
+    }
+    return ElementKind::None;
+}
+
+// Offsets of the first element and of the closing bracket of the "bodies"
+// array, or -1 for a file without one. It is the first key, and the first
+// "]" followed by another top-level key closes it: inside it, the key after
+// an "exercises" array is always "name".
+QPair<qsizetype, qsizetype> bodiesExtent(QByteArrayView data)
+{
+    const QByteArray text = QByteArray::fromRawData(data.data(), data.size());
+    const qsizetype key = text.indexOf("\"bodies\"");
+    const qsizetype open = key >= 0 ? text.indexOf('[', key) : -1;
+    if (open < 0) {
+        return {-1, -1};
+    }
+
+    for (qsizetype close = text.indexOf(']', open); close >= 0; close = text.indexOf(']', close + 1)) {
+        qsizetype p = close + 1;
+        while (p < text.size() && isSpace(text[p])) {
+            ++p;
+        }
+        if (p == text.size() || text[p] != ',') {
+            continue;
+        }
+        do {
+            ++p;
+        } while (p < text.size() && isSpace(text[p]));
+        const QByteArrayView rest = data.sliced(p);
+        for (const char* next : {"\"removed\"", "\"schedules\"", "\"sets\"", "\"templates\"", "\"workouts\""}) {
+            if (rest.startsWith(next)) {
+                return {open + 1, close};
+            }
+        }
+    }
+    return {open + 1, text.size()};
+}
+
+// Only separators between two array elements
+bool onlySeparators(const char* from, const char* to)
+{
+    for (const char* p = from; p < to; ++p) {
+        if (!isSpace(*p) && *p != ',') {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// One chunk's share of a salvage scan, with stores of its own so chunks
+// need no locking
+struct WorkoutJsonReader::SalvageChunk {
+    struct Element {
+        ElementKind kind;
+        qsizetype begin;
+        qsizetype end = -1;    // -1 if it does not parse
+        qsizetype index = -1;  // into `records` or `bodyList`; -1 for a record without a valid date
+        int bodyId = -1;
+        qint64 checksum = -1;
+    };
+
+    StringPool strings;
+    BodyStore bodies;
+    RecordTable records;
+    QVector<WorkoutBodyPtr> bodyList;
+    QVector<Element> elements;
+};
+
+WorkoutJsonReader::WorkoutJsonReader(QByteArrayView data, StringPool& strings, BodyStore& bodies)
+    : begin(data.data())
+    , pos(data.data())
+    , end(data.data() + data.size())
+    , strings(strings)
+    , bodies(bodies)
+{
+}
+
+bool WorkoutJsonReader::read(RecordTable& table)
+{
+    records = 0;
+    error.clear();
+    checked = 0;
+    sections.clear();
+    bodyTable.clear();
+    unresolved.clear();
+    checks.clear();
+    damage.clear();
+    if (!readRoot(table)) {
+        return false;
+    }
+
+    // Records read before the "bodies" array point at it by index
+    for (const auto& reference : unresolved) {
+        WorkoutRecord& workout = table.entryAt(reference.first).record;
+        if (reference.second < bodyTable.size()) {
+            workout.body = bodyTable[reference.second];
+        } else {
+            qWarning() << "Unknown workout body" << reference.second;
+        }
+    }
+    verifyChecksums(table);
+    table.sortAndDeduplicate();
+    return true;
+}
+
+void WorkoutJsonReader::verifyChecksums(RecordTable& table)
+{
+    // Bodies are shared, so each is summed once. Damaged entries are
+    // dropped together afterwards, keeping file order for the later
+    // de-duplication, where the last copy of a date wins.
+    QHash<const WorkoutBody*, quint32> bodySums;
+    QVector<qsizetype> dropped;
+    for (auto it = checks.cbegin(); it != checks.cend(); ++it) {
+        DatedRecord& entry = table.entryAt(it->index);
+        const WorkoutBody* body = entry.record.body.get();
+        auto sum = bodySums.constFind(body);
+        if (sum == bodySums.cend()) {
+            sum = bodySums.insert(body, bodyChecksum(body));
+        }
+        if (recordChecksum(entry.date, entry.record.status, sum.value()) == it->checksum) {
+            ++checked;
+            continue;
+        }
+
+        qWarning() << "Checksum mismatch in workout data:" << entry.date;
+        damage.append(DamagedRange{it->begin, it->end, entry.date, QStringLiteral("checksum mismatch")});
+        dropped.append(it->index);
+        --records;
+    }
+    std::sort(dropped.begin(), dropped.end());
+    table.removeEntries(dropped);
+}
+
+bool WorkoutJsonReader::salvage(RecordTable& table, int threads)
+{
+    Q_ASSERT(table.isEmpty());
+    records = 0;
+    checked = 0;
+    error.clear();
+    sections.clear();
+    damage.clear();
+    if (threads <= 0) {
+        threads = QThread::idealThreadCount();
+    }
+
+    // Each chunk owns the elements that start in it; the last one may run
+    // past its end
+    const qsizetype size = end - begin;
+    const int chunkCount = int(qBound<qsizetype>(1, size / MinSalvageChunk, qsizetype(threads) * 4));
+    std::vector<SalvageChunk> chunks(size_t(chunkCount));
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for (int i = 0; i < chunkCount; ++i) {
+            const qsizetype from = size * i / chunkCount;
+            const qsizetype to = size * (i + 1) / chunkCount;
+            SalvageChunk* chunk = &chunks[size_t(i)];
+            pool.start([this, chunk, from, to] {
+                WorkoutJsonReader reader(QByteArrayView(begin, end - begin), chunk->strings, chunk->bodies);
+                reader.scanChunk(*chunk, from, to);
+            });
+        }
+        pool.waitForDone();
+    }
+
+    // Elements in file order. A body's ID is its position in the "bodies"
+    // array, so damaged bodies keep their place; after unreadable bytes
+    // between bodies the positions are no longer known. Templates look
+    // like bodies but lie outside that array.
+    struct Found {
+        SalvageChunk* chunk;
+        const SalvageChunk::Element* element;
+    };
+    const QPair<qsizetype, qsizetype> bodiesArray = bodiesExtent(QByteArrayView(begin, size));
+    QVector<Found> found;
+    qsizetype covered = 0;
+    for (SalvageChunk& chunk : chunks) {
+        for (const SalvageChunk::Element& element : chunk.elements) {
+            const bool inBodies = element.begin >= bodiesArray.first && element.begin < bodiesArray.second;
+            if (element.kind == ElementKind::Body && !inBodies) {
+                continue;
+            }
+            if (element.begin >= covered) {
+                found.append(Found{&chunk, &element});
+                covered = std::max(covered, element.end >= 0 ? element.end : element.begin + 1);
+            }
+        }
+    }
+
+    bodyTable.clear();
+    QSet<int> lostBodies;
+    int bodiesUncertainFrom = std::numeric_limits<int>::max();
+    qsizetype firstRecordBegin = size;
+    for (qsizetype i = 0; i < found.size(); ++i) {
+        const SalvageChunk::Element& element = *found[i].element;
+        const SalvageChunk::Element* previous = i > 0 ? found[i - 1].element : nullptr;
+        qsizetype next = i + 1 < found.size() ? found[i + 1].element->begin : size;
+        if (element.kind == ElementKind::Body) {
+            next = std::min(next, bodiesArray.second);
+        }
+        if (previous && previous->kind == element.kind && previous->end >= 0
+            && !onlySeparators(begin + previous->end, begin + element.begin)) {
+            damage.append(DamagedRange{previous->end, element.begin, QDate(), QStringLiteral("unreadable data")});
+            if (element.kind == ElementKind::Body) {
+                bodiesUncertainFrom = std::min(bodiesUncertainFrom, int(bodyTable.size()));
+            }
+        }
+        if (element.end < 0) {
+            damage.append(DamagedRange{element.begin, next, QDate(), element.kind == ElementKind::Body
+                                       ? QStringLiteral("unreadable workout body")
+                                       : QStringLiteral("unreadable record")});
+        }
+
+        if (element.kind == ElementKind::Body) {
+            if (element.end < 0) {
+                lostBodies.insert(int(bodyTable.size()));
+            }
+            bodyTable.append(element.end >= 0
+                ? bodies.intern(found[i].chunk->bodyList[element.index], strings) : WorkoutBodyPtr());
+        } else {
+            firstRecordBegin = std::min(firstRecordBegin, element.begin);
+        }
+    }
+
+    QHash<const WorkoutBody*, quint32> bodySums;
+    for (const Found& item : std::as_const(found)) {
+        const SalvageChunk::Element& element = *item.element;
+        if (element.kind != ElementKind::Record || element.end < 0) {
+            continue;
+        }
+        if (element.index < 0) {
+            damage.append(DamagedRange{element.begin, element.end, QDate(), QStringLiteral("no valid date")});
+            continue;
+        }
+
+        const DatedRecord& salvaged = item.chunk->records.entryAt(element.index);
+        DamagedRange damaged{element.begin, element.end, salvaged.date, QString()};
+        WorkoutBodyPtr body;
+        if (element.bodyId < 0) {
+            body = bodies.intern(salvaged.record.body, strings);
+        } else if (element.bodyId < bodyTable.size() && !lostBodies.contains(element.bodyId)) {
+            body = bodyTable[element.bodyId];
+        } else {
+            damaged.reason = QStringLiteral("workout body lost");
+        }
+        if (damaged.reason.isEmpty() && element.checksum < 0 && element.bodyId >= bodiesUncertainFrom) {
+            damaged.reason = QStringLiteral("workout body uncertain");
+        }
+        if (damaged.reason.isEmpty() && element.checksum >= 0) {
+            auto sum = bodySums.constFind(body.get());
+            if (sum == bodySums.cend()) {
+                sum = bodySums.insert(body.get(), bodyChecksum(body.get()));
+            }
+            if (recordChecksum(salvaged.date, salvaged.record.status, sum.value()) != quint32(element.checksum)) {
+                damaged.reason = QStringLiteral("checksum mismatch");
+            } else {
+                ++checked;
+            }
+        }
+        if (!damaged.reason.isEmpty()) {
+            damage.append(damaged);
+            continue;
+        }
+
+        DatedRecord& entry = table.emplaceBack();
+        entry.date = salvaged.date;
+        entry.record.status = salvaged.record.status;
+        entry.record.body = std::move(body);
+        ++records;
+    }
+
+    // Sections sit between the two arrays, as the keys sort
+    salvageSections(std::max<qsizetype>(bodiesArray.second, 0), firstRecordBegin);
+
+    table.sortAndDeduplicate();
+    std::sort(damage.begin(), damage.end(), [](const DamagedRange& a, const DamagedRange& b) {
+        return a.begin < b.begin;
+    });
+    if (records == 0 && sections.isEmpty()) {
+        error = QStringLiteral("nothing could be recovered");
+        return false;
+    }
+    return true;
+}
+
+void WorkoutJsonReader::scanChunk(SalvageChunk& chunk, qsizetype from, qsizetype to)
+{
+    const char* cursor = begin + from;
+    const char* const stop = begin + to;
+    while (cursor < stop) {
+        cursor = static_cast<const char*>(std::memchr(cursor, '{', size_t(stop - cursor)));
+        if (!cursor) {
+            break;
+        }
+        const ElementKind kind = elementAt(cursor, end);
+        if (kind == ElementKind::None) {
+            ++cursor;
+            continue;
+        }
+
+        SalvageChunk::Element element{kind, cursor - begin};
+        pos = cursor;
+        if (kind == ElementKind::Record) {
+            const qsizetype before = chunk.records.size();
+            if (readWorkout(chunk.records)) {
+                element.end = pos - begin;
+                if (chunk.records.size() > before) {
+                    element.index = before;
+                    element.bodyId = lastBodyId;
+                    element.checksum = lastChecksum;
+                }
+            }
+            while (element.end < 0 && chunk.records.size() > before) {
+                chunk.records.removeLast();
+            }
+        } else if (readBody()) {
+            element.end = pos - begin;
+            element.index = chunk.bodyList.size();
+            chunk.bodyList.append(bodies.intern(scratchBody, strings));
+        }
+        chunk.elements.append(element);
+        cursor = element.end >= 0 ? begin + element.end : cursor + 1;
+    }
+}
+
+void WorkoutJsonReader::salvageSections(qsizetype from, qsizetype to)
+{
+    // Keys inside sections can repeat these names, but not with an object
+    // or array of the same kind as the top-level value
+    const QByteArray between = QByteArray::fromRawData(begin + from, std::max<qsizetype>(to - from, 0));
+    const QPair<const char*, char> keys[] = {{"archives", '['}, {"removed", '['}, {"schedules", '['},
+                                             {"sets", '{'}, {"templates", '['}};
+    for (const auto& key : keys) {
+        const QByteArray quoted = '"' + QByteArray(key.first) + '"';
+        for (qsizetype at = between.indexOf(quoted); at >= 0; at = between.indexOf(quoted, at + 1)) {
+            pos = between.constData() + at + quoted.size();
+            if (!consume(':') || !peek(key.second)) {
+                continue;
+            }
+            const char* start = pos;
+            if (skipValue()) {
+                sections.append({QByteArray(key.first), QByteArrayView(start, pos - start)});
+            } else {
+                damage.append(DamagedRange{start - begin, to, QDate(),
+                                           QStringLiteral("unreadable \"%1\"").arg(QLatin1String(key.first))});
+            }
+            break;
+        }
+    }
+    error.clear();
+}
+
+bool WorkoutJsonReader::readRoot(RecordTable& table)
+{
+    skipWhitespace();
+    if (!consume('{')) {
+        return fail("expected an object");
+    }
+
+    if (!consume('}')) {
+        do {
+            QByteArrayView key;
+            if (!readKey(key)) {
+                return false;
+            }
+            bool ok;
+            if (keyIs(key, "workouts") && peek('[')) {
+                ok = readWorkouts(table);
+            } else if (keyIs(key, "bodies") && peek('[')) {
+                ok = readBodies();
+            } else {
+                QByteArray name = key.toByteArray();
+                skipWhitespace();
+                const char* start = pos;
+                ok = skipValue();
+                sections.append({name, QByteArrayView(start, pos - start)});
+            }
+            if (!ok) {
+                return false;
+            }
+        } while (consume(','));
+
+        if (!consume('}')) {
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    skipWhitespace();
+    return pos == end || fail("unexpected data after the root object");
+}
+
+bool WorkoutJsonReader::readWorkouts(RecordTable& table)
+{
+    consume('[');
+    if (consume(']')) {
+        return true;
+    }
+
+    do {
+        bool ok = peek('{') ? readWorkout(table) : skipValue();
+        if (!ok) {
+            return false;
+        }
+    } while (consume(','));
+
+    return consume(']') || fail("expected ',' or ']'");
+}
+
+bool WorkoutJsonReader::readBodies()
+{
+    consume('[');
+    if (consume(']')) {
+        return true;
+    }
+
+    // A body's ID is its position in the array
+    do {
+        if (!readBody()) {
+            return false;
+        }
+        bodyTable.append(bodies.intern(scratchBody, strings));
+    } while (consume(','));
+
+    return consume(']') || fail("expected ',' or ']'");
+}
+
+bool WorkoutJsonReader::readBody()
+{
+    resetScratchBody();
+    if (!peek('{')) {
+        return skipValue();
+    }
+
+    consume('{');
+    if (consume('}')) {
+        return true;
+    }
+    do {
+        QByteArrayView key;
+        if (!readKey(key) || !readBodyField(key, scratchBody)) {
+            return false;
+        }
+    } while (consume(','));
+
+    return consume('}') || fail("expected ',' or '}'");
+}
+
+bool WorkoutJsonReader::readBodyField(QByteArrayView key, WorkoutBody& body)
+{
+    if (keyIs(key, "name")) {
+        return readText(body.name);
+    }
+    if (keyIs(key, "description")) {
+        return readText(body.description);
+    }
+    if (keyIs(key, "exercises")) {
+        body.exercises.clear();
+        return peek('[') ? readExercises(body) : skipValue();
+    }
+    return skipValue();
+}
+
+void WorkoutJsonReader::resetScratchBody()
+{
+    // Pooled strings are shared, so resetting only drops references
+    scratchBody.name = QString();
+    scratchBody.description = QString();
+    scratchBody.exercises.clear();
+}
+
+bool WorkoutJsonReader::readWorkout(RecordTable& table)
+{
+    // The record is filled where it will live; it is dropped again if the
+    // object turns out to have no usable date
+    DatedRecord& entry = table.emplaceBack();
+    WorkoutRecord& workout = entry.record;
+    const qsizetype start = pos - begin;
+    QDate date;
+    bool hasDate = false;
+    QString invalidDate;
+    int bodyId = -1;
+    qint64 checksum = -1;
+    resetScratchBody();
+
+    consume('{');
+    if (!consume('}')) {
+        do {
+            QByteArrayView key;
+            if (!readKey(key)) {
+                return false;
+            }
+
+            bool ok = true;
+            if (keyIs(key, "date")) {
+                QByteArrayView text;
+                if (peek('"')) {
+                    ok = readRawString(text);
+                } else {
+                    ok = skipValue();
+                }
+                hasDate = ok && !text.isEmpty();
+                date = hasDate ? parseIsoDate(text) : QDate();
+                if (hasDate && !date.isValid()) {
+                    invalidDate = QString::fromUtf8(text);
+                }
+            } else if (keyIs(key, "status")) {
+                int status = 0;
+                ok = readInt(status, 0);
+                workout.status = static_cast<WorkoutStatus>(status);
+            } else if (keyIs(key, "body")) {
+                ok = readInt(bodyId, -1);
+            } else if (keyIs(key, "crc")) {
+                double value = -1;
+                ok = readNumber(value);
+                checksum = value >= 0 && value <= 0xFFFFFFFFu && value == qint64(value) ? qint64(value) : -1;
+            } else {
+                // Files written before bodies were shared keep them inline
+                ok = readBodyField(key, scratchBody);
+            }
+            if (!ok) {
+                return false;
+            }
+        } while (consume(','));
+
+        if (!consume('}')) {
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    lastBodyId = bodyId;
+    lastChecksum = checksum;
+    if (!hasDate) {
+        table.removeLast();
+    } else if (!date.isValid()) {
+        qWarning() << "Invalid date in workout data:" << invalidDate;
+        table.removeLast();
+    } else {
+        entry.date = date;
+        ++records;
+        if (bodyId < 0) {
+            workout.body = bodies.intern(scratchBody, strings);
+        } else if (bodyId < bodyTable.size()) {
+            workout.body = bodyTable[bodyId];
+        } else {
+            unresolved.append({table.size() - 1, bodyId});
+        }
+        if (checksum >= 0) {
+            checks.append(Check{table.size() - 1, quint32(checksum), start, pos - begin});
+        }
+    }
+    return true;
+}
+
+bool WorkoutJsonReader::readExercises(WorkoutBody& workout)
+{
+    consume('[');
+    if (consume(']')) {
+        return true;
+    }
+
+    do {
+        // Entries that are not objects still count, as empty exercises
+        workout.exercises.append(Exercise{QString(), 0, 0});
+        bool ok = peek('{') ? readExercise(workout.exercises.last()) : skipValue();
+        if (!ok) {
+            return false;
+        }
+    } while (consume(','));
+
+    return consume(']') || fail("expected ',' or ']'");
+}
+
+bool WorkoutJsonReader::readExercise(Exercise& exercise)
+{
+    consume('{');
+    if (consume('}')) {
+        return true;
+    }
+
+    do {
+        QByteArrayView key;
+        if (!readKey(key)) {
+            return false;
+        }
+
+        bool ok;
+        if (keyIs(key, "name")) {
+            ok = readText(exercise.name);
+        } else if (keyIs(key, "sets")) {
+            ok = readInt(exercise.sets, 0);
+        } else if (keyIs(key, "reps")) {
+            ok = readInt(exercise.reps, 0);
+        } else {
+            ok = skipValue();
+        }
+        if (!ok) {
+            return false;
+        }
+    } while (consume(','));
+
+    return consume('}') || fail("expected ',' or '}'");
+}
+
+bool WorkoutJsonReader::readKey(QByteArrayView& key)
+{
+    skipWhitespace();
+    if (!peek('"')) {
+        return fail("expected a key");
+    }
+    if (!readRawString(key)) {
+        return false;
+    }
+    return consume(':') || fail("expected ':'");
+}
+
+bool WorkoutJsonReader::readRawString(QByteArrayView& out)
+{
+    skipWhitespace();
+    ++pos; // opening quote, checked by the caller
+    const char* start = pos;
+    while (pos < end && *pos != '"' && *pos != '\\') {
+        ++pos;
+    }
+    if (pos < end && *pos == '"') {
+        out = QByteArrayView(start, pos - start);
+        ++pos;
+        return true;
+    }
+
+    // Escaped strings are decoded into a reused buffer
+    unescaped.resize(0);
+    unescaped.append(start, pos - start);
+    while (pos < end && *pos != '"') {
+        if (*pos != '\\') {
+            unescaped.append(*pos++);
+            continue;
+        }
+        if (++pos == end) {
+            break;
+        }
+        switch (char c = *pos++) {
+        case '"': case '\\': case '/': unescaped.append(c); break;
+        case 'b': unescaped.append('\b'); break;
+        case 'f': unescaped.append('\f'); break;
+        case 'n': unescaped.append('\n'); break;
+        case 'r': unescaped.append('\r'); break;
+        case 't': unescaped.append('\t'); break;
+        case 'u': {
+            auto readHex = [this](char32_t& code) {
+                if (end - pos < 4) return false;
+                code = 0;
+                for (int i = 0; i < 4; ++i) {
+                    int digit = hexValue(*pos++);
+                    if (digit < 0) return false;
+                    code = code * 16 + char32_t(digit);
+                }
+                return true;
+            };
+            char32_t code;
+            if (!readHex(code)) {
+                return fail("invalid \\u escape");
+            }
+            if (code >= 0xD800 && code < 0xDC00 && end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u') {
+                const char* save = pos;
+                pos += 2;
+                char32_t low;
+                if (readHex(low) && low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                } else {
+                    pos = save;
+                }
+            }
+            appendUtf8(unescaped, code);
+            break;
+        }
+        default:
+            return fail("invalid escape");
+        }
+    }
+    if (pos == end) {
+        return fail("unterminated string");
+    }
+    ++pos;
+    out = QByteArrayView(unescaped.constData(), unescaped.size());
+    return true;
+}
+
+bool WorkoutJsonReader::readString(QString& out)
+{
+    QByteArrayView text;
+    if (!readRawString(text)) {
+        return false;
+    }
+
+    // Names are almost always ASCII; widen them into the reused buffer
+    for (char c : text) {
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            out = QString::fromUtf8(text);
+            return true;
+        }
+    }
+    out.resize(text.size());
+    QChar* data = out.data();
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        data[i] = QLatin1Char(text[i]);
+    }
+    return true;
+}
+
+bool WorkoutJsonReader::readText(QString& out)
+{
+    skipWhitespace();
+    if (!peek('"')) {
+        out = QString();
+        return skipValue();
+    }
+    if (!readString(scratch)) {
+        return false;
+    }
+    out = strings.intern(scratch);
+    return true;
+}
+
+bool WorkoutJsonReader::readNumber(double& out)
+{
+    skipWhitespace();
+    const char* start = pos;
+    bool integral = true;
+    if (pos < end && *pos == '-') {
+        ++pos;
+    }
+    while (pos < end && (isDigit(*pos) || *pos == '.' || *pos == 'e' || *pos == 'E'
+                         || *pos == '+' || *pos == '-')) {
+        integral = integral && isDigit(*pos);
+        ++pos;
+    }
+
+    const qsizetype length = pos - start;
+    const bool negative = length > 0 && *start == '-';
+    const qsizetype digits = length - (negative ? 1 : 0);
+    if (digits == 0) {
+        return fail("invalid number");
+    }
+    if (integral && digits <= 9) {
+        int value = digitsValue(pos - digits, int(digits));
+        out = negative ? -value : value;
+        return true;
+    }
+
+    bool ok = false;
+    out = QByteArray::fromRawData(start, length).toDouble(&ok);
+    return ok || fail("invalid number");
+}
+
+bool WorkoutJsonReader::readInt(int& out, int defaultValue)
+{
+    skipWhitespace();
+    if (pos == end || !(isDigit(*pos) || *pos == '-')) {
+        out = defaultValue;
+        return skipValue();
+    }
+
+    // Same rules as QJsonValue::toInt(): integral doubles in range only
+    double value;
+    if (!readNumber(value)) {
+        return false;
+    }
+    const bool inRange = value >= std::numeric_limits<int>::min()
+                         && value <= std::numeric_limits<int>::max();
+    out = inRange && value == int(value) ? int(value) : defaultValue;
+    return true;
+}
+
+bool WorkoutJsonReader::skipValue(int depth)
+{
+    if (depth > MaxNesting) {
+        return fail("too deeply nested");
+    }
+
+    skipWhitespace();
+    if (pos == end) {
+        return fail("unexpected end of data");
+    }
+
+    switch (*pos) {
+    case '{':
+        ++pos;
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            QByteArrayView key;
+            if (!readKey(key) || !skipValue(depth + 1)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}') || fail("expected ',' or '}'");
+    case '[':
+        ++pos;
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            if (!skipValue(depth + 1)) {
+                return false;
+            }
+        } while (consume(','));
+        return consume(']') || fail("expected ',' or ']'");
+    case '"': {
+        QByteArrayView text;
+        return readRawString(text);
+    }
+    case 't':
+    case 'f':
+    case 'n': {
+        const char* literal = *pos == 't' ? "true" : *pos == 'f' ? "false" : "null";
+        const qsizetype length = qsizetype(std::strlen(literal));
+        if (end - pos < length || std::memcmp(pos, literal, size_t(length)) != 0) {
+            return fail("invalid literal");
+        }
+        pos += length;
+        return true;
+    }
+    default: {
+        double ignored;
+        return readNumber(ignored);
+    }
+    }
+}
+
+void WorkoutJsonReader::skipWhitespace()
+{
+    while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+        ++pos;
+    }
+}
+
+bool WorkoutJsonReader::peek(char c)
+{
+    skipWhitespace();
+    return pos < end && *pos == c;
+}
+
+bool WorkoutJsonReader::consume(char c)
+{
+    if (!peek(c)) {
+        return false;
+    }
+    ++pos;
+    return true;
+}
+
+bool WorkoutJsonReader::fail(const char* message)
+{
+    if (error.isEmpty()) {
+        error = QString("%1 at offset %2").arg(QLatin1String(message)).arg(pos - begin);
+    }
+    return false;
+}
@@ -0,0 +1,115 @@
+// workout_json_reader.h
+#ifndef WORKOUT_JSON_READER_H
+#define WORKOUT_JSON_READER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QDate>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include "types.h"
+
+class RecordTable;
+class StringPool;
+class BodyStore;
+
+// A stretch of a data file that was skipped as damaged
+struct DamagedRange {
+    qsizetype begin = 0;  // byte offsets into the data
+    qsizetype end = 0;
+    QDate date;           // of the record there, if it could still be read
+    QString reason;
+};
+
+// Single-pass reader for workouts.json. Records are decoded straight from
+// the file bytes into the table, in place, without building a QJsonDocument
+// or per-record temporaries. Records refer to the "bodies" array by index;
+// older files with inline bodies are deduplicated through the body store as
+// they are read. Strings go through the pool so only distinct names
+// allocate. Unknown keys inside records are skipped; other top-level
+// values are kept as raw sections for the caller. Records carrying a "crc"
+// are checked against it, and a record that fails is dropped and reported
+// rather than failing the whole file.
+class WorkoutJsonReader {
+public:
+    WorkoutJsonReader(QByteArrayView data, StringPool& strings, BodyStore& bodies);
+
+    // Appends the file's records to `table` in date order. Returns false if
+    // the data is not a JSON object; `table` must then be discarded.
+    bool read(RecordTable& table);
+    // For data read() rejected, such as a truncated file: scans it in
+    // parallel chunks and appends every record that still parses and, if
+    // it has a checksum, matches it to `table`, which must be empty. Body
+    // references and top-level sections are recovered where they parse.
+    // Finding records without a full parse relies on the sorted keys this
+    // app writes. `threads` defaults to one per core. Returns false if
+    // nothing could be recovered.
+    bool salvage(RecordTable& table, int threads = 0);
+    int recordCount() const { return records; }
+    // Records with a checksum that matched; older files have none
+    int checkedCount() const { return checked; }
+    // What read() or salvage() skipped, in file order
+    const QVector<DamagedRange>& damaged() const { return damage; }
+    QString errorString() const { return error; }
+    // Raw JSON of another top-level value, such as "templates"; empty if the
+    // file has none. Points into the data passed to the constructor.
+    QByteArrayView section(const char* key) const;
+
+private:
+    struct Check {
+        qsizetype index;  // into the table
+        quint32 checksum;
+        qsizetype begin;
+        qsizetype end;
+    };
+    struct SalvageChunk;
+
+    bool readRoot(RecordTable& table);
+    bool readWorkouts(RecordTable& table);
+    bool readWorkout(RecordTable& table);
+    bool readBodies();
+    bool readBody();
+    void verifyChecksums(RecordTable& table);
+    void scanChunk(SalvageChunk& chunk, qsizetype from, qsizetype to);
+    void salvageSections(qsizetype from, qsizetype to);
+    bool readBodyField(QByteArrayView key, WorkoutBody& body);
+    void resetScratchBody();
+    bool readExercises(WorkoutBody& workout);
+    bool readExercise(Exercise& exercise);
+
+    bool readKey(QByteArrayView& key);
+    bool readString(QString& out);
+    bool readRawString(QByteArrayView& out);
+    bool readNumber(double& out);
+    bool readInt(int& out, int defaultValue);
+    bool readText(QString& out);
+    bool skipValue(int depth = 0);
+
+    void skipWhitespace();
+    bool peek(char c);
+    bool consume(char c);
+    bool fail(const char* message);
+
+    const char* begin;
+    const char* pos;
+    const char* end;
+    StringPool& strings;
+    BodyStore& bodies;
+    WorkoutBody scratchBody;
+    QVector<WorkoutBodyPtr> bodyTable;
+    QVector<QPair<qsizetype, int>> unresolved;  // record index, body ID
+    QByteArray unescaped;
+    QString scratch;
+    int records = 0;
+    int checked = 0;
+    QString error;
+    QVector<QPair<QByteArray, QByteArrayView>> sections;
+    QVector<Check> checks;
+    QVector<DamagedRange> damage;
+    // Of the record readWorkout() read last
+    int lastBodyId = -1;
+    qint64 lastChecksum = -1;
+};
+
+#endif // WORKOUT_JSON_READER_H
@@ -0,0 +1,227 @@
+// workout_merge.cpp
+#include "workout_merge.h"
+#include "storage_manager.h"
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+
+constexpr MergeFields BodyFields = MergeFields(MergeField::Status) | MergeField::Name
+                                 | MergeField::Description | MergeField::Exercises;
+
+size_t setsHash(const SetLog& sets, const QDate& date, int exerciseCount)
+{
+    if (!sets.hasSets(date)) {
+        return 0;
+    }
+    size_t hash = 0;
+    const QVector<QVector<SetEntry>> exerciseSets = sets.daySets(date, exerciseCount);
+    for (int exercise = 0; exercise < exerciseSets.size(); ++exercise) {
+        for (const SetEntry& entry : exerciseSets[exercise]) {
+            hash = qHashMulti(hash, exercise, entry.weight, entry.reps, entry.rpe, entry.restSeconds);
+        }
+    }
+    return hash;
+}
+
+} // namespace
+
+QString mergeFieldNames(MergeFields fields)
+{
+    QStringList names;
+    if (fields & MergeField::Removed) names << QStringLiteral("removed");
+    if (fields & MergeField::Status) names << QStringLiteral("status");
+    if (fields & MergeField::Name) names << QStringLiteral("name");
+    if (fields & MergeField::Description) names << QStringLiteral("description");
+    if (fields & MergeField::Exercises) names << QStringLiteral("exercises");
+    return names.join(QStringLiteral(", "));
+}
+
+WorkoutMerge::WorkoutMerge(const StorageManager& base, const StorageManager& ours, const StorageManager& theirs)
+{
+    // Walk the three date-ordered tables together
+    auto b = base.records().begin();
+    auto o = ours.records().begin();
+    auto t = theirs.records().begin();
+    const auto bEnd = base.records().end();
+    const auto oEnd = ours.records().end();
+    const auto tEnd = theirs.records().end();
+
+    while (b != bEnd || o != oEnd || t != tEnd) {
+        QDate date;
+        for (const QDate& candidate : {b != bEnd ? b->date : QDate(),
+                                       o != oEnd ? o->date : QDate(),
+                                       t != tEnd ? t->date : QDate()}) {
+            if (candidate.isValid() && (!date.isValid() || candidate < date)) {
+                date = candidate;
+            }
+        }
+        mergeDay(date, base, ours, theirs);
+        if (b != bEnd && b->date == date) ++b;
+        if (o != oEnd && o->date == date) ++o;
+        if (t != tEnd && t->date == date) ++t;
+    }
+}
+
+const WorkoutMerge::BodyHashes& WorkoutMerge::bodyHashes(const WorkoutBodyPtr& body)
+{
+    // Bodies are shared within a store, so most days hit the cache
+    auto it = bodyCache.constFind(body.get());
+    if (it != bodyCache.cend()) {
+        return it.value();
+    }
+
+    static const WorkoutBody empty;
+    const WorkoutBody& content = body ? *body : empty;
+    BodyHashes hashes;
+    hashes.name = qHash(content.name);
+    hashes.description = qHash(content.description);
+    for (const Exercise& exercise : content.exercises) {
+        hashes.exercises = qHashMulti(hashes.exercises, exercise.name, exercise.sets, exercise.reps);
+    }
+    return bodyCache.insert(body.get(), hashes).value();
+}
+
+WorkoutMerge::Fingerprint WorkoutMerge::fingerprint(const StorageManager& store, const QDate& date)
+{
+    Fingerprint print;
+    const WorkoutRecord* workout = store.find(date);
+    const BodyHashes& hashes = bodyHashes(workout ? workout->body : WorkoutBodyPtr());
+    print.exists = workout != nullptr;
+    print.status = workout ? workout->status : WorkoutStatus::NoWorkout;
+    print.name = hashes.name;
+    print.description = hashes.description;
+    print.exercises = qHashMulti(hashes.exercises,
+                                 setsHash(store.sets(), date, workout ? int(workout->exercises().size()) : 0));
+    print.body = workout ? workout->body.get() : nullptr;
+    print.sets = &store.sets();
+    print.date = date;
+    return print;
+}
+
+bool WorkoutMerge::sameField(MergeField field, const Fingerprint& x, const Fingerprint& y)
+{
+    static const WorkoutBody empty;
+    const WorkoutBody& a = x.body ? *x.body : empty;
+    const WorkoutBody& b = y.body ? *y.body : empty;
+    switch (field) {
+        case MergeField::Status:
+            return x.status == y.status;
+        case MergeField::Name:
+            return x.name == y.name && a.name == b.name;
+        case MergeField::Description:
+            return x.description == y.description && a.description == b.description;
+        case MergeField::Exercises: {
+            if (x.exercises != y.exercises || !(a.exercises == b.exercises)) {
+                return false;
+            }
+            const int count = int(a.exercises.size());
+            return x.sets->hasSets(x.date) == y.sets->hasSets(y.date)
+                && x.sets->daySets(x.date, count) == y.sets->daySets(y.date, count);
+        }
+        default:
+            return false;
+    }
+}
+
+bool WorkoutMerge::same(const Fingerprint& x, const Fingerprint& y)
+{
+    // Cheapest fields first; content is only read where the hashes agree
+    return x.exists == y.exists && sameField(MergeField::Status, x, y) && sameField(MergeField::Name, x, y)
+        && sameField(MergeField::Description, x, y) && sameField(MergeField::Exercises, x, y);
+}
+
+void WorkoutMerge::mergeDay(const QDate& date, const StorageManager& base,
+                            const StorageManager& ours, const StorageManager& theirs)
+{
+    const Fingerprint b = fingerprint(base, date);
+    const Fingerprint o = fingerprint(ours, date);
+    const Fingerprint t = fingerprint(theirs, date);
+    // Nothing of theirs to take
+    if (same(o, t) || same(t, b)) {
+        return;
+    }
+
+    MergeDay day;
+    day.date = date;
+    if (same(o, b)) {
+        day.taken = BodyFields;
+    } else if (!o.exists || !t.exists) {
+        day.conflicts = MergeField::Removed;
+    } else {
+        auto mergeField = [&](MergeField field) {
+            if (sameField(field, o, t) || sameField(field, t, b)) {
+                return;
+            }
+            if (sameField(field, o, b)) {
+                day.taken |= field;
+            } else {
+                day.conflicts |= field;
+            }
+        };
+        mergeField(MergeField::Status);
+        mergeField(MergeField::Name);
+        mergeField(MergeField::Description);
+        mergeField(MergeField::Exercises);
+        if (!day.conflicts && !day.taken) {
+            return;
+        }
+    }
+
+    day.base = base.dayState(date);
+    day.ours = ours.dayState(date);
+    day.theirs = theirs.dayState(date);
+    changedDays.append(std::move(day));
+}
+
+int WorkoutMerge::conflictCount() const
+{
+    return int(std::count_if(changedDays.cbegin(), changedDays.cend(),
+                             [](const MergeDay& day) { return bool(day.conflicts); }));
+}
+
+void WorkoutMerge::resolveAll(MergeSide side)
+{
+    for (MergeDay& day : changedDays) {
+        day.resolution = side;
+    }
+}
+
+DayState WorkoutMerge::merged(const MergeDay& day)
+{
+    if (day.conflicts & MergeField::Removed) {
+        return day.resolution == MergeSide::Theirs ? day.theirs : day.ours;
+    }
+    // Ours is unchanged from base, including days theirs added or removed
+    if (day.taken == BodyFields) {
+        return day.theirs;
+    }
+
+    auto fromTheirs = [&day](MergeField field) {
+        return day.conflicts & field ? day.resolution == MergeSide::Theirs : day.taken.testFlag(field);
+    };
+    const WorkoutRecord& ours = day.ours.record;
+    const WorkoutRecord& theirs = day.theirs.record;
+    WorkoutBody body;
+    body.name = (fromTheirs(MergeField::Name) ? theirs : ours).name();
+    body.description = (fromTheirs(MergeField::Description) ? theirs : ours).description();
+    body.exercises = (fromTheirs(MergeField::Exercises) ? theirs : ours).exercises();
+
+    DayState result;
+    result.date = day.date;
+    result.exists = true;
+    result.record = WorkoutRecord(std::move(body), (fromTheirs(MergeField::Status) ? theirs : ours).status);
+    // Set rows refer to exercises by position and go with them
+    result.sets = fromTheirs(MergeField::Exercises) ? day.theirs.sets : day.ours.sets;
+    return result;
+}
+
+QVector<DayState> WorkoutMerge::result() const
+{
+    QVector<DayState> states;
+    states.reserve(changedDays.size());
+    for (const MergeDay& day : changedDays) {
+        states.append(merged(day));
+    }
+    return states;
+}
@@ -0,0 +1,95 @@
+// workout_merge.h
+#ifndef WORKOUT_MERGE_H
+#define WORKOUT_MERGE_H
+
+#include <QFlags>
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "undo_history.h"
+
+class StorageManager;
+
+// Parts of a day that are merged separately. Set detail belongs to the
+// exercises it describes.
+enum class MergeField {
+    Removed = 0x1,      // one side removed the day, the other changed it
+    Status = 0x2,
+    Name = 0x4,
+    Description = 0x8,
+    Exercises = 0x10
+};
+Q_DECLARE_FLAGS(MergeFields, MergeField)
+Q_DECLARE_OPERATORS_FOR_FLAGS(MergeFields)
+
+QString mergeFieldNames(MergeFields fields);
+
+enum class MergeSide { Ours, Theirs };
+
+// A day the merge changes in ours, or on which the sides conflict
+struct MergeDay {
+    QDate date;
+    DayState base;
+    DayState ours;
+    DayState theirs;
+    MergeFields conflicts;
+    // Fields changed only in theirs, taken without asking
+    MergeFields taken;
+    // Which side conflicting fields are taken from
+    MergeSide resolution = MergeSide::Ours;
+};
+
+// Three-way merge of two histories that diverged from a common base, day by
+// day and field by field. A field changed on one side only takes that
+// change; a field changed differently on both sides is a conflict.
+//
+// Fields are compared by hash first, with the body hashes computed once per
+// distinct body, so most differing fields are told apart without touching
+// their content. Equal hashes are confirmed by comparing the content, so a
+// collision never hides a change.
+class WorkoutMerge {
+public:
+    WorkoutMerge(const StorageManager& base, const StorageManager& ours, const StorageManager& theirs);
+
+    // Days where the result differs from ours or that have conflicts, in
+    // date order
+    QVector<MergeDay>& days() { return changedDays; }
+    const QVector<MergeDay>& days() const { return changedDays; }
+    int conflictCount() const;
+    void resolveAll(MergeSide side);
+
+    // The merged state of a day with its conflicts resolved
+    static DayState merged(const MergeDay& day);
+    // Merged states of all listed days, to be stored over ours
+    QVector<DayState> result() const;
+
+private:
+    struct BodyHashes {
+        size_t name = 0;
+        size_t description = 0;
+        size_t exercises = 0;
+    };
+    struct Fingerprint {
+        bool exists = false;
+        WorkoutStatus status = WorkoutStatus::NoWorkout;
+        size_t name = 0;
+        size_t description = 0;
+        size_t exercises = 0;  // exercises and their set detail
+        // What the hashes were taken from, to confirm equal hashes
+        const WorkoutBody* body = nullptr;
+        const SetLog* sets = nullptr;
+        QDate date;
+    };
+
+    void mergeDay(const QDate& date, const StorageManager& base,
+                  const StorageManager& ours, const StorageManager& theirs);
+    Fingerprint fingerprint(const StorageManager& store, const QDate& date);
+    static bool sameField(MergeField field, const Fingerprint& x, const Fingerprint& y);
+    static bool same(const Fingerprint& x, const Fingerprint& y);
+    const BodyHashes& bodyHashes(const WorkoutBodyPtr& body);
+
+    QHash<const WorkoutBody*, BodyHashes> bodyCache;
+    QVector<MergeDay> changedDays;
+};
+
+#endif // WORKOUT_MERGE_H
@@ -0,0 +1,19 @@
+// src/models/workout_status.cpp
+#include "workout_status.h"
+#include <QDebug>
+
+QDebug operator<<(QDebug debug, const WorkoutStatus& status)
+{
+    switch (status) {
+        case WorkoutStatus::NoWorkout:
+            return debug << "NoWorkout";
+        case WorkoutStatus::Completed:
+            return debug << "Completed";
+        case WorkoutStatus::Missed:
+            return debug << "Missed";
+        case WorkoutStatus::RestDay:
+            return debug << "RestDay";
+        default:
+            return debug << "Unknown";
+    }
+}
@@ -2,7 +2,9 @@
 #ifndef WORKOUT_STATUS_H
 #define WORKOUT_STATUS_H
 
-#include <QDebug>
+#include <QString>
+
+class QDebug;
 
 enum class WorkoutStatus {
     NoWorkout,
@@ -11,21 +13,40 @@ enum class WorkoutStatus {
     RestDay
 };
 
-// Add debug output operator
-inline QDebug operator<<(QDebug debug, const WorkoutStatus& status)
+// Debug output; defined in workout_status.cpp so including this header
+// does not pull in QDebug
+QDebug operator<<(QDebug debug, const WorkoutStatus& status);
+
+// Stable lower-case names, used by the command-line tools
+inline QString workoutStatusName(WorkoutStatus status)
 {
     switch (status) {
-        case WorkoutStatus::NoWorkout:
-            return debug << "NoWorkout";
         case WorkoutStatus::Completed:
-            return debug << "Completed";
+            return QStringLiteral("completed");
         case WorkoutStatus::Missed:
-            return debug << "Missed";
+            return QStringLiteral("missed");
         case WorkoutStatus::RestDay:
-            return debug << "RestDay";
+            return QStringLiteral("rest");
         default:
-            return debug << "Unknown";
+            return QStringLiteral("planned");
+    }
+}
+
+inline bool parseWorkoutStatus(const QString& text, WorkoutStatus& status)
+{
+    const QString key = text.trimmed().toLower();
+    if (key == QLatin1String("completed")) {
+        status = WorkoutStatus::Completed;
+    } else if (key == QLatin1String("missed")) {
+        status = WorkoutStatus::Missed;
+    } else if (key == QLatin1String("rest") || key == QLatin1String("restday")) {
+        status = WorkoutStatus::RestDay;
+    } else if (key == QLatin1String("planned") || key == QLatin1String("noworkout")) {
+        status = WorkoutStatus::NoWorkout;
+    } else {
+        return false;
     }
+    return true;
 }
 
 #endif // WORKOUT_STATUS_H
\ No newline at end of file
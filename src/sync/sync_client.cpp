@@ -0,0 +1,251 @@
+// sync_client.cpp
+#include "sync_client.h"
+#include "sync_protocol.h"
+#include "../models/storage_manager.h"
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSaveFile>
+#include <QUuid>
+#include <algorithm>
+
+// Lives on the client's worker thread
+class SyncTransport : public QObject {
+public:
+    void exchange(SyncClient* client, const QUrl& endpoint, const QString& device,
+                  const QString& profile, quint64 since, const QVector<DayState>& changes);
+
+private:
+    QNetworkAccessManager* network = nullptr;
+};
+
+void SyncTransport::exchange(SyncClient* client, const QUrl& endpoint, const QString& device,
+                             const QString& profile, quint64 since, const QVector<DayState>& changes)
+{
+    if (!network) {
+        network = new QNetworkAccessManager(this);
+    }
+
+    QJsonArray days;
+    for (const DayState& state : changes) {
+        days.append(SyncProtocol::dayToJson(state));
+    }
+    QJsonObject message;
+    message["device"] = device;
+    if (!profile.isEmpty()) {
+        message["profile"] = profile;
+    }
+    message["since"] = qint64(since);
+    message["changes"] = days;
+
+    QNetworkRequest request(endpoint);
+    request.setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("application/x-workout-sync"));
+    QNetworkReply* reply = network->post(request, SyncProtocol::encode(message));
+
+    connect(reply, &QNetworkReply::finished, this, [client, reply] {
+        reply->deleteLater();
+        SyncResult result;
+        QJsonObject response;
+        if (reply->error() != QNetworkReply::NoError) {
+            result.error = reply->errorString();
+        } else if (!SyncProtocol::decode(reply->readAll(), response)) {
+            result.error = QStringLiteral("Malformed response from sync server");
+        } else {
+            result.ok = true;
+            result.cursor = quint64(response["cursor"].toInteger());
+            result.more = response["more"].toBool();
+            for (const QJsonValue& value : response["changes"].toArray()) {
+                DayState state = SyncProtocol::dayFromJson(value.toObject());
+                if (state.date.isValid()) {
+                    result.days.append(std::move(state));
+                }
+            }
+            for (const QJsonValue& value : response["conflicts"].toArray()) {
+                const QDate date = QDate::fromString(value.toString(), Qt::ISODate);
+                if (date.isValid()) {
+                    result.conflicts.append(date);
+                }
+            }
+        }
+        // The client outlives the worker thread, so it is still there
+        QMetaObject::invokeMethod(client, [client, result] { client->finishSync(result); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+SyncClient::SyncClient(StorageManager& store, const QUrl& endpoint, const QString& profile,
+                       QObject* parent)
+    : QObject(parent)
+    , store(store)
+    , endpoint(endpoint)
+    , profile(profile)
+    , transport(new SyncTransport)
+{
+    transport->moveToThread(&worker);
+    worker.setObjectName(QStringLiteral("sync"));
+    worker.start();
+
+    loadState();
+
+    // Local edits go out shortly after they settle; remote ones are polled
+    changeTimer.setSingleShot(true);
+    changeTimer.setInterval(2000);
+    connect(&changeTimer, &QTimer::timeout, this, &SyncClient::syncNow);
+    pollTimer.setInterval(60000);
+    connect(&pollTimer, &QTimer::timeout, this, &SyncClient::syncNow);
+    pollTimer.start();
+
+    connect(&store, &StorageManager::workoutsChanged, this, &SyncClient::recordLocalChange);
+}
+
+SyncClient::~SyncClient()
+{
+    worker.quit();
+    worker.wait();
+    delete transport;
+    saveState();
+}
+
+void SyncClient::recordLocalChange(const QVector<QDate>& dates)
+{
+    // Days arriving from the server are not sent back
+    if (applyingRemote) {
+        return;
+    }
+    for (const QDate& date : dates) {
+        dirty[date] = nextSequence++;
+    }
+    saveState();
+    changeTimer.start();
+}
+
+void SyncClient::syncNow()
+{
+    if (syncing) {
+        syncAgain = true;
+        return;
+    }
+    syncing = true;
+    syncAgain = false;
+
+    // Earliest days first, one batch per exchange
+    QVector<DayState> changes;
+    inFlight.clear();
+    for (auto it = dirty.cbegin(); it != dirty.cend() && changes.size() < SyncProtocol::MaxBatch; ++it) {
+        changes.append(store.dayState(it.key()));
+        inFlight.insert(it.key(), it.value());
+    }
+
+    SyncTransport* target = transport;
+    QMetaObject::invokeMethod(transport, [this, target, url = endpoint, device = deviceId,
+                                          space = profile, since = cursor, changes] {
+        target->exchange(this, url, device, space, since, changes);
+    }, Qt::QueuedConnection);
+}
+
+void SyncClient::finishSync(const SyncResult& result)
+{
+    syncing = false;
+    const int sent = int(inFlight.size());
+    if (!result.ok) {
+        qWarning() << "Sync with" << endpoint.toString() << "failed:" << result.error;
+        inFlight.clear();
+        emit syncFinished(false, 0, 0, {}, result.error);
+        return;
+    }
+
+    // Days changed again while the exchange ran stay dirty
+    for (auto it = inFlight.cbegin(); it != inFlight.cend(); ++it) {
+        if (dirty.value(it.key()) == it.value()) {
+            dirty.remove(it.key());
+        }
+    }
+    inFlight.clear();
+
+    // A local edit newer than the server's copy wins; it goes out next.
+    // Either way the other device's edit is lost, so it is reported.
+    QVector<QDate> conflicts = result.conflicts;
+    QVector<DayState> remote;
+    remote.reserve(result.days.size());
+    for (const DayState& state : result.days) {
+        if (!dirty.contains(state.date)) {
+            remote.append(state);
+        } else {
+            conflicts.append(state.date);
+        }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+    conflicts.erase(std::unique(conflicts.begin(), conflicts.end()), conflicts.end());
+    if (!conflicts.isEmpty()) {
+        qWarning() << "Sync kept this device's version of" << conflicts.size()
+                   << "days also changed elsewhere:" << conflicts;
+    }
+    if (!remote.isEmpty()) {
+        applyingRemote = true;
+        store.replaceDays(remote);
+        applyingRemote = false;
+    }
+    cursor = result.cursor;
+    saveState();
+    emit syncFinished(true, int(remote.size()), sent, conflicts, QString());
+
+    if (result.more || syncAgain || (sent > 0 && !dirty.isEmpty())) {
+        QTimer::singleShot(0, this, &SyncClient::syncNow);
+    }
+}
+
+QString SyncClient::statePath() const
+{
+    return store.filePath() + QStringLiteral(".sync");
+}
+
+void SyncClient::loadState()
+{
+    QFile file(statePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Never synced: everything is new to the server
+        deviceId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        for (const QDate& date : store.getAllWorkoutDates()) {
+            dirty.insert(date, nextSequence++);
+        }
+        saveState();
+        return;
+    }
+
+    const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    deviceId = json["device"].toString();
+    if (deviceId.isEmpty()) {
+        deviceId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    }
+    cursor = quint64(json["cursor"].toInteger());
+    for (const QJsonValue& value : json["pending"].toArray()) {
+        const QDate date = QDate::fromString(value.toString(), Qt::ISODate);
+        if (date.isValid()) {
+            dirty.insert(date, nextSequence++);
+        }
+    }
+}
+
+void SyncClient::saveState() const
+{
+    QJsonArray pending;
+    for (auto it = dirty.cbegin(); it != dirty.cend(); ++it) {
+        pending.append(it.key().toString(Qt::ISODate));
+    }
+    QJsonObject json;
+    json["device"] = deviceId;
+    json["cursor"] = qint64(cursor);
+    json["pending"] = pending;
+
+    // A torn state file would lose the cursor and the unsent days
+    QSaveFile file(statePath());
+    if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(json).toJson()) == -1
+        || !file.commit()) {
+        qWarning() << "Could not save sync state to" << statePath();
+    }
+}
@@ -0,0 +1,89 @@
+// sync_client.h
+#ifndef SYNC_CLIENT_H
+#define SYNC_CLIENT_H
+
+#include <QDate>
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+#include "../models/undo_history.h"
+
+class StorageManager;
+class SyncTransport;
+
+// What one exchange with the server brought back
+struct SyncResult {
+    bool ok = false;
+    QString error;
+    quint64 cursor = 0;
+    bool more = false;
+    QVector<DayState> days;
+    QVector<QDate> conflicts;
+};
+
+// Keeps a store in step with a sync server by exchanging changed days only.
+// Every local change gives its day a new sequence number; an exchange sends
+// the days changed since the last one and receives the days other devices
+// changed since the server cursor. Encoding, compression and network I/O
+// run on a worker thread. Remote days are stored through
+// StorageManager::replaceDays(), so views and indexes follow through the
+// usual workoutsChanged() path.
+//
+// The device ID, cursor and unsent days are kept next to the data file in
+// "<file>.sync". The first exchange of a store without one sends every day.
+//
+// `profile` names the server-side history the store syncs with, so that
+// profiles sharing one endpoint stay apart; empty for the default profile.
+class SyncClient : public QObject {
+    Q_OBJECT
+public:
+    SyncClient(StorageManager& store, const QUrl& endpoint, const QString& profile = QString(),
+               QObject* parent = nullptr);
+    ~SyncClient() override;
+
+    // Exchanges also happen this often, to pick up remote changes
+    void setInterval(int milliseconds) { pollTimer.setInterval(milliseconds); }
+    bool isSyncing() const { return syncing; }
+    int pendingDays() const { return int(dirty.size()); }
+
+public slots:
+    void syncNow();
+
+signals:
+    // After each exchange; `received` and `sent` count days. `conflicts`
+    // are days changed both here and on another device since they last
+    // synced: this device's version was kept and the other one is lost.
+    void syncFinished(bool ok, int received, int sent, const QVector<QDate>& conflicts,
+                      const QString& error);
+
+private:
+    void recordLocalChange(const QVector<QDate>& dates);
+    void finishSync(const SyncResult& result);
+    void loadState();
+    void saveState() const;
+    QString statePath() const;
+
+    StorageManager& store;
+    QUrl endpoint;
+    QString profile;
+    QThread worker;
+    SyncTransport* transport;
+    QTimer pollTimer;
+    QTimer changeTimer;
+
+    QString deviceId;
+    quint64 cursor = 0;
+    quint64 nextSequence = 1;
+    // Changed days not yet acknowledged by the server, with the sequence
+    // number of their latest change
+    QMap<QDate, quint64> dirty;
+    QMap<QDate, quint64> inFlight;
+    bool syncing = false;
+    bool syncAgain = false;
+    bool applyingRemote = false;
+};
+
+#endif // SYNC_CLIENT_H
@@ -0,0 +1,94 @@
+// sync_protocol.cpp
+#include "sync_protocol.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+
+namespace SyncProtocol {
+
+QJsonObject dayToJson(const DayState& state)
+{
+    QJsonObject json;
+    json["date"] = state.date.toString(Qt::ISODate);
+    if (!state.exists) {
+        json["removed"] = true;
+        return json;
+    }
+    json["status"] = static_cast<int>(state.record.status);
+    json["name"] = state.record.name();
+    json["description"] = state.record.description();
+
+    QJsonArray exercises;
+    for (qsizetype i = 0; i < state.record.exercises().size(); ++i) {
+        const Exercise& exercise = state.record.exercises()[i];
+        QJsonObject exerciseObj;
+        exerciseObj["name"] = exercise.name;
+        exerciseObj["sets"] = exercise.sets;
+        exerciseObj["reps"] = exercise.reps;
+        if (i < state.sets.size() && !state.sets[i].isEmpty()) {
+            // [weight, reps, rpe, rest] per set
+            QJsonArray rows;
+            for (const SetEntry& entry : state.sets[i]) {
+                rows.append(QJsonArray{double(entry.weight), entry.reps, double(entry.rpe), entry.restSeconds});
+            }
+            exerciseObj["log"] = rows;
+        }
+        exercises.append(exerciseObj);
+    }
+    json["exercises"] = exercises;
+    return json;
+}
+
+DayState dayFromJson(const QJsonObject& json)
+{
+    DayState state;
+    state.date = QDate::fromString(json["date"].toString(), Qt::ISODate);
+    if (json["removed"].toBool()) {
+        return state;
+    }
+
+    WorkoutBody body;
+    body.name = json["name"].toString();
+    body.description = json["description"].toString();
+    bool hasSets = false;
+    QVector<QVector<SetEntry>> sets;
+    for (const QJsonValue& value : json["exercises"].toArray()) {
+        const QJsonObject exerciseObj = value.toObject();
+        body.exercises.append(Exercise{exerciseObj["name"].toString(),
+                                       exerciseObj["sets"].toInt(),
+                                       exerciseObj["reps"].toInt()});
+        QVector<SetEntry> rows;
+        for (const QJsonValue& row : exerciseObj["log"].toArray()) {
+            const QJsonArray fields = row.toArray();
+            rows.append(SetEntry{float(fields.at(0).toDouble()), fields.at(1).toInt(),
+                                 float(fields.at(2).toDouble()), fields.at(3).toInt()});
+        }
+        hasSets = hasSets || !rows.isEmpty();
+        sets.append(std::move(rows));
+    }
+
+    state.exists = true;
+    state.record = WorkoutRecord(std::move(body), static_cast<WorkoutStatus>(json["status"].toInt()));
+    if (hasSets) {
+        state.sets = std::move(sets);
+    }
+    return state;
+}
+
+QByteArray encode(const QJsonObject& message)
+{
+    return qCompress(QJsonDocument(message).toJson(QJsonDocument::Compact));
+}
+
+bool decode(const QByteArray& data, QJsonObject& message)
+{
+    const QByteArray json = qUncompress(data);
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(json, &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        return false;
+    }
+    message = document.object();
+    return true;
+}
+
+} // namespace SyncProtocol
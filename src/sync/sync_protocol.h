@@ -0,0 +1,37 @@
+// sync_protocol.h
+#ifndef SYNC_PROTOCOL_H
+#define SYNC_PROTOCOL_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include "../models/undo_history.h"
+
+// Wire format shared by SyncClient and the local sync server. One exchange
+// is a POST of a zlib-compressed JSON object:
+//
+//   request:  {"device": ID, "profile": NAME, "since": CURSOR, "changes": [DAY...]}
+//   response: {"cursor": CURSOR, "more": BOOL, "changes": [DAY...],
+//              "conflicts": [DATE...]}
+//
+// The client sends the days it changed since its last exchange; the server
+// stores them under new sequence numbers and answers with the latest state
+// of every day other devices stored after `since`. The last change to reach
+// the server wins; "conflicts" lists the sent days that replaced a change
+// from another device the client had not received yet. Every profile has a
+// history and cursor of its own on the server; "profile" is left out for
+// the default profile. A DAY is one day's full
+// state, so a change is the unit of transfer rather than the whole file.
+namespace SyncProtocol {
+
+constexpr int MaxBatch = 500;  // days per message in either direction
+
+QJsonObject dayToJson(const DayState& state);
+// Builds a fresh body; the store interns it when the day is applied
+DayState dayFromJson(const QJsonObject& json);
+
+QByteArray encode(const QJsonObject& message);
+bool decode(const QByteArray& data, QJsonObject& message);
+
+} // namespace SyncProtocol
+
+#endif // SYNC_PROTOCOL_H
@@ -6,7 +6,11 @@
 #include <QAction>
 #include <QContextMenuEvent>
 #include <QMouseEvent>
+#include <QAbstractItemView>
+#include <QGuiApplication>
 #include <QDebug>
+#include <algorithm>
+#include "../models/alloc_tracker.h"
 
 CustomCalendarWidget::CustomCalendarWidget(QWidget *parent)
     : QCalendarWidget(parent)
@@ -32,10 +36,27 @@ CustomCalendarWidget::CustomCalendarWidget(QWidget *parent)
         "QCalendarWidget QToolButton { color: white; }"
         "QCalendarWidget QToolButton:hover { background-color: #404040; }"
     );
+
+    // Shift/ctrl-click and drags are tracked on top of the built-in single
+    // selection; the day grid's viewport tells us when a drag starts and ends
+    if (auto view = findChild<QAbstractItemView*>(QStringLiteral("qt_calendar_calendarview"))) {
+        view->viewport()->installEventFilter(this);
+    }
+    connect(this, &QCalendarWidget::selectionChanged,
+            this, &CustomCalendarWidget::handleSelectionChanged);
+    connect(this, &QCalendarWidget::clicked,
+            this, &CustomCalendarWidget::handleDateClicked);
+    connect(&StorageManager::instance(), &StorageManager::workoutsChanged,
+            this, &CustomCalendarWidget::refreshDates);
+    connect(&StorageManager::instance(), &StorageManager::scheduleChanged,
+            this, &CustomCalendarWidget::refreshPlannedDates);
+    connect(this, &QCalendarWidget::currentPageChanged,
+            this, &CustomCalendarWidget::refreshPlannedDates);
 }
 
 void CustomCalendarWidget::setDayStatus(const QDate &date, WorkoutStatus status)
 {
+    WT_ALLOC_SCOPE("status-change");
     // Prevent recursive updates
     static bool updatingStatus = false;
     if (updatingStatus) return;
@@ -92,6 +113,100 @@ void CustomCalendarWidget::mousePressEvent(QMouseEvent *event)
     }
 }
 
+bool CustomCalendarWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::MouseButtonPress: {
+        auto mouseEvent = static_cast<QMouseEvent*>(event);
+        if (mouseEvent->button() == Qt::LeftButton) {
+            m_mousePressed = true;
+            m_dragStartDate = QDate();
+        } else if (mouseEvent->button() == Qt::RightButton && !m_selectedDates.isEmpty()) {
+            // Keep the selection for the context menu that follows
+            return true;
+        }
+        break;
+    }
+    case QEvent::MouseMove:
+        // The first move of a drag starts from the day that was pressed
+        if (m_mousePressed && !m_dragStartDate.isValid()) {
+            m_dragStartDate = selectedDate();
+        }
+        break;
+    case QEvent::MouseButtonRelease:
+        if (static_cast<QMouseEvent*>(event)->button() == Qt::LeftButton) {
+            m_mousePressed = false;
+            m_dragStartDate = QDate();
+        }
+        break;
+    default:
+        break;
+    }
+    return QCalendarWidget::eventFilter(watched, event);
+}
+
+void CustomCalendarWidget::handleSelectionChanged()
+{
+    const QDate date = selectedDate();
+    const Qt::KeyboardModifiers modifiers = QGuiApplication::keyboardModifiers();
+
+    if (modifiers & Qt::ControlModifier) {
+        return; // toggled in handleDateClicked()
+    }
+    if ((modifiers & Qt::ShiftModifier) && m_anchorDate.isValid()) {
+        selectRange(m_anchorDate, date);
+    } else if (m_dragStartDate.isValid()) {
+        selectRange(m_dragStartDate, date);
+    } else {
+        m_selectedDates.clear();
+        m_anchorDate = date;
+    }
+    update();
+}
+
+void CustomCalendarWidget::handleDateClicked(const QDate &date)
+{
+    if (!(QGuiApplication::keyboardModifiers() & Qt::ControlModifier)) {
+        return;
+    }
+
+    if (m_selectedDates.isEmpty() && m_anchorDate.isValid()) {
+        m_selectedDates.insert(m_anchorDate);
+    }
+    if (!m_selectedDates.remove(date)) {
+        m_selectedDates.insert(date);
+    }
+    m_anchorDate = date;
+    update();
+}
+
+void CustomCalendarWidget::selectRange(const QDate &from, const QDate &to)
+{
+    m_selectedDates.clear();
+    const QDate first = qMin(from, to);
+    const QDate last = qMax(from, to);
+    for (QDate date = first; date <= last; date = date.addDays(1)) {
+        m_selectedDates.insert(date);
+    }
+}
+
+QVector<QDate> CustomCalendarWidget::selectedDates() const
+{
+    if (m_selectedDates.isEmpty()) {
+        return {selectedDate()};
+    }
+    QVector<QDate> dates(m_selectedDates.cbegin(), m_selectedDates.cend());
+    std::sort(dates.begin(), dates.end());
+    return dates;
+}
+
+void CustomCalendarWidget::clearDateSelection()
+{
+    m_selectedDates.clear();
+    m_anchorDate = selectedDate();
+    update();
+}
+
 void CustomCalendarWidget::startSelectionAnimation()
 {
     selectionAnimation->stop();
@@ -108,47 +223,66 @@ void CustomCalendarWidget::contextMenuEvent(QContextMenuEvent *event)
 void CustomCalendarWidget::createContextMenu(const QDate &date, const QPoint &pos)
 {
     QMenu menu(this);
+
+    // With several days selected the actions apply to all of them
+    QVector<QDate> dates = selectedDates();
+    if (!dates.contains(date)) {
+        dates = {date};
+    }
+    if (dates.size() > 1) {
+        menu.addSection(tr("%n days selected", nullptr, int(dates.size())));
+    }
     
     QAction* completedAction = menu.addAction(tr("Mark as Completed"));
     QAction* missedAction = menu.addAction(tr("Mark as Missed"));
     QAction* plannedAction = menu.addAction(tr("Mark as Planned"));
     QAction* restAction = menu.addAction(tr("Mark as Rest Day"));
     
-    connect(completedAction, &QAction::triggered, this, [this, date]() {
-        setDayStatus(date, WorkoutStatus::Completed);
-        emit statusChanged(date, WorkoutStatus::Completed);
-        StorageManager::instance().saveToFile();  // Add explicit save
+    // The status signals are persisted by the receiver
+    connect(completedAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::Completed);
     });
     
-    connect(missedAction, &QAction::triggered, this, [this, date]() {
-        setDayStatus(date, WorkoutStatus::Missed);
-        emit statusChanged(date, WorkoutStatus::Missed);
-        StorageManager::instance().saveToFile();  // Add explicit save
+    connect(missedAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::Missed);
     });
     
-    connect(plannedAction, &QAction::triggered, this, [this, date]() {
-        setDayStatus(date, WorkoutStatus::NoWorkout);
-        emit statusChanged(date, WorkoutStatus::NoWorkout);
-        StorageManager::instance().saveToFile();  // Add explicit save
+    connect(plannedAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::NoWorkout);
     });
     
-    connect(restAction, &QAction::triggered, this, [this, date]() {
-        setDayStatus(date, WorkoutStatus::RestDay);
-        emit statusChanged(date, WorkoutStatus::RestDay);
-        StorageManager::instance().saveToFile();  // Add explicit save
+    connect(restAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::RestDay);
     });
     
     menu.exec(pos);
 }
 
+void CustomCalendarWidget::setDatesStatus(const QVector<QDate> &dates, WorkoutStatus status)
+{
+    if (dates.size() == 1) {
+        setDayStatus(dates.first(), status);
+        return;
+    }
+
+    WT_ALLOC_SCOPE("status-change");
+    for (const QDate &date : dates) {
+        dayStatusMap[date] = status;
+        workoutMap[date] = true;
+    }
+    update();
+    emit bulkStatusChanged(dates, status);
+}
+
 void CustomCalendarWidget::paintCell(QPainter *painter, const QRect &rect, QDate date) const
 {
+    WT_ALLOC_SCOPE("repaint");
     painter->save();
 
     WorkoutStatus status = getDayStatus(date);
     QColor bgColor = getStatusColor(status);
     
-    if (date == selectedDate()) {
+    if (date == selectedDate() || m_selectedDates.contains(date)) {
         bgColor = bgColor.lighter(120);
         painter->setPen(QPen(Qt::white, 2));
     } else {
@@ -170,48 +304,64 @@ void CustomCalendarWidget::paintCell(QPainter *painter, const QRect &rect, QDate
     painter->setFont(font);
     painter->drawText(rect, Qt::AlignCenter, QString::number(date.day()));
     
+    int indicatorSize = 4;
+    int margin = 2;
+    QRect indicatorRect(
+        rect.right() - indicatorSize - margin,
+        rect.top() + margin,
+        indicatorSize,
+        indicatorSize
+    );
     if (hasWorkout(date)) {
-        int indicatorSize = 4;
-        int margin = 2;
-        QRect indicatorRect(
-            rect.right() - indicatorSize - margin,
-            rect.top() + margin,
-            indicatorSize,
-            indicatorSize
-        );
         painter->fillRect(indicatorRect, textColor);
+    } else if (plannedDates.contains(date)) {
+        // Planned by a schedule but not recorded yet
+        painter->setPen(textColor);
+        painter->drawRect(indicatorRect.adjusted(0, 0, -1, -1));
     }
     
     painter->restore();
 }
 
-void CustomCalendarWidget::setWorkoutData(const QDate &date, 
-                                        const QString &name,
-                                        const QString &description,
-                                        const QVector<Exercise> &exercises)
+void CustomCalendarWidget::setWorkoutData(const QDate &date, const WorkoutRecord &workout)
 {
-    WorkoutInfo info;
-    info.name = name;
-    info.description = description;
-    info.exercises = exercises;
-    workoutData[date] = info;
+    Q_UNUSED(workout);
     workoutMap[date] = true;
     updateCell(date);
 }
 
-bool CustomCalendarWidget::getWorkoutData(const QDate &date, 
-                                        QString &name, 
-                                        QString &description,
-                                        QVector<Exercise> &exercises) const
+void CustomCalendarWidget::refreshDates(const QVector<QDate> &dates)
 {
-    if (workoutData.contains(date)) {
-        const WorkoutInfo &info = workoutData[date];
-        name = info.name;
-        description = info.description;
-        exercises = info.exercises;
-        return true;
+    StorageManager& storage = StorageManager::instance();
+    for (const QDate& date : dates) {
+        if (const WorkoutRecord* workout = storage.find(date)) {
+            dayStatusMap[date] = workout->status;
+            workoutMap[date] = true;
+        } else {
+            dayStatusMap.remove(date);
+            workoutMap.remove(date);
+        }
+        updateCell(date);
     }
-    return false;
+}
+
+void CustomCalendarWidget::refreshPlannedDates()
+{
+    plannedDates.clear();
+    const Schedule& schedule = StorageManager::instance().schedule();
+    if (schedule.rules().isEmpty()) {
+        update();
+        return;
+    }
+
+    // The grid shows up to six weeks around the month
+    const QDate first(yearShown(), monthShown(), 1);
+    const QDate from = first.addDays(-7);
+    const QDate to = first.addDays(42);
+    for (const PlannedWorkout& planned : schedule.plannedBetween(from, to)) {
+        plannedDates.insert(planned.date);
+    }
+    update();
 }
 
 void CustomCalendarWidget::loadSavedData()
@@ -221,27 +371,16 @@ void CustomCalendarWidget::loadSavedData()
     
     dayStatusMap.clear();
     workoutMap.clear();
-    workoutData.clear();
     
     for (const QDate& date : dates) {
-        QString name, description;
-        QVector<Exercise> exercises;
-        WorkoutStatus status;
-        
-        if (storage.loadWorkout(date, name, description, exercises, status)) {
-            dayStatusMap[date] = status;
+        if (const WorkoutRecord* workout = storage.find(date)) {
+            dayStatusMap[date] = workout->status;
             workoutMap[date] = true;
-            
-            WorkoutInfo info;
-            info.name = name;
-            info.description = description;
-            info.exercises = exercises;
-            workoutData[date] = info;
-            
             updateCell(date);
         }
     }
     
+    refreshPlannedDates();
     update();
     repaint();
 }
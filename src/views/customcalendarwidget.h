@@ -5,6 +5,7 @@
 #include <QCalendarWidget>
 #include <QColor>
 #include <QMap>
+#include <QSet>
 #include <QDate>
 #include <QMenu>
 #include <QPropertyAnimation>
@@ -25,15 +26,20 @@ public:
     void setDayStatus(const QDate &date, WorkoutStatus status);
     WorkoutStatus getDayStatus(const QDate &date) const;
     bool hasWorkout(const QDate &date) const;
-    void setWorkoutData(const QDate &date, const QString &name, const QString &description);
-    void setWorkoutData(const QDate &date, const QString &name, 
-                       const QString &description,
-                       const QVector<Exercise> &exercises);
-    bool getWorkoutData(const QDate &date, QString &name, 
-                       QString &description,
-                       QVector<Exercise> &exercises) const;
+    // The calendar only paints status and a workout marker; record contents
+    // stay in StorageManager
+    void setWorkoutData(const QDate &date, const WorkoutRecord &workout);
     
     void loadSavedData();
+    // Re-reads status and workout marker of `dates` from StorageManager
+    void refreshDates(const QVector<QDate> &dates);
+    // Recomputes planned days for the visible month only
+    void refreshPlannedDates();
+
+    // Days picked with ctrl-click, shift-click or a drag, in date order;
+    // just selectedDate() when no range is selected
+    QVector<QDate> selectedDates() const;
+    void clearDateSelection();
     
     qreal selectionOpacity() const { return m_selectionOpacity; }
     void setSelectionOpacity(qreal opacity);
@@ -43,25 +49,34 @@ protected:
     void paintCell(QPainter *painter, const QRect &rect, QDate date) const override;
     void contextMenuEvent(QContextMenuEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 signals:
     void statusChanged(const QDate& date, WorkoutStatus status);
+    // A status applied to several selected days at once
+    void bulkStatusChanged(const QVector<QDate>& dates, WorkoutStatus status);
+
+private slots:
+    void handleSelectionChanged();
+    void handleDateClicked(const QDate &date);
 
 private:
     QMap<QDate, WorkoutStatus> dayStatusMap;
     QMap<QDate, bool> workoutMap;
+    QSet<QDate> plannedDates;
     qreal m_selectionOpacity;
     QPropertyAnimation* selectionAnimation;
 
-    struct WorkoutInfo {
-        QString name;
-        QString description;
-        QVector<Exercise> exercises;
-    };
-    QMap<QDate, WorkoutInfo> workoutData;
+    // Multi-day selection on top of QCalendarWidget's single selected date
+    QSet<QDate> m_selectedDates;
+    QDate m_anchorDate;
+    QDate m_dragStartDate;
+    bool m_mousePressed = false;
     
     QColor getStatusColor(WorkoutStatus status) const;
     void createContextMenu(const QDate &date, const QPoint &pos);
+    void setDatesStatus(const QVector<QDate> &dates, WorkoutStatus status);
+    void selectRange(const QDate &from, const QDate &to);
 };
 
 #endif // CUSTOMCALENDARWIDGET_H
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "exercisenamedelegate.h"
+#include "../models/storage_manager.h"
+#include <QCompleter>
+#include <QLineEdit>
+#include <QStringListModel>
+
+QWidget *ExerciseNameDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                                            const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+
+    auto editor = new QLineEdit(parent);
+    editor->setFrame(false);
+
+    // The index does the matching and ranking; the completer only shows
+    // its answer for the current text
+    auto model = new QStringListModel(editor);
+    auto completer = new QCompleter(model, editor);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    editor->setCompleter(completer);
+
+    connect(editor, &QLineEdit::textEdited, completer, [model, completer](const QString &text) {
+        model->setStringList(text.isEmpty()
+                                 ? QStringList()
+                                 : StorageManager::instance().exerciseNameIndex().complete(text));
+        completer->complete();
+    });
+    return editor;
+}
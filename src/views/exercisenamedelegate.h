@@ -0,0 +1,19 @@
+#ifndef EXERCISENAMEDELEGATE_H
+#define EXERCISENAMEDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// Editor for exercise-name cells that completes from the names already in
+// the store, most used and most recent first
+class ExerciseNameDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const override;
+};
+
+#endif // EXERCISENAMEDELEGATE_H
@@ -0,0 +1,206 @@
+#include "exercisetablemodel.h"
+#include <QRegularExpression>
+#include <algorithm>
+
+ExerciseTableModel::ExerciseTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int ExerciseTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(exerciseRows.size());
+}
+
+int ExerciseTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ExerciseTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= exerciseRows.size()
+        || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QVariant();
+    }
+
+    const Exercise &exercise = exerciseRows[index.row()];
+    switch (index.column()) {
+        case NameColumn:
+            return exercise.name;
+        case SetsColumn:
+            return exercise.sets;
+        case RepsColumn:
+            return exercise.reps;
+        default:
+            return QVariant();
+    }
+}
+
+bool ExerciseTableModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || index.row() >= exerciseRows.size() || role != Qt::EditRole) {
+        return false;
+    }
+
+    Exercise &exercise = exerciseRows[index.row()];
+    switch (index.column()) {
+        case NameColumn:
+            exercise.name = value.toString().simplified();
+            break;
+        case SetsColumn:
+            exercise.sets = qMax(0, value.toInt());
+            break;
+        case RepsColumn:
+            exercise.reps = qMax(0, value.toInt());
+            break;
+        default:
+            return false;
+    }
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    return true;
+}
+
+QVariant ExerciseTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+        case NameColumn:
+            return tr("Exercise Name");
+        case SetsColumn:
+            return tr("Sets");
+        case RepsColumn:
+            return tr("Reps");
+        default:
+            return QVariant();
+    }
+}
+
+Qt::ItemFlags ExerciseTableModel::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags result = QAbstractTableModel::flags(index);
+    if (index.isValid() && !isReadOnly) {
+        result |= Qt::ItemIsEditable;
+    }
+    return result;
+}
+
+bool ExerciseTableModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || row > exerciseRows.size() || count <= 0) {
+        return false;
+    }
+
+    beginInsertRows(parent, row, row + count - 1);
+    exerciseRows.insert(row, count, Exercise{QString(), 0, 0});
+    setRows.insert(row, count, QVector<SetEntry>());
+    endInsertRows();
+    return true;
+}
+
+bool ExerciseTableModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if (parent.isValid() || row < 0 || count <= 0 || row + count > exerciseRows.size()) {
+        return false;
+    }
+
+    beginRemoveRows(parent, row, row + count - 1);
+    exerciseRows.remove(row, count);
+    setRows.remove(row, count);
+    endRemoveRows();
+    return true;
+}
+
+bool ExerciseTableModel::moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                                  const QModelIndex &destinationParent, int destinationChild)
+{
+    if (sourceParent.isValid() || destinationParent.isValid() || count <= 0
+        || sourceRow < 0 || sourceRow + count > exerciseRows.size()
+        || destinationChild < 0 || destinationChild > exerciseRows.size()
+        || (destinationChild >= sourceRow && destinationChild <= sourceRow + count)) {
+        return false;
+    }
+
+    if (!beginMoveRows(sourceParent, sourceRow, sourceRow + count - 1, destinationParent, destinationChild)) {
+        return false;
+    }
+    // Rotate the block into place in both parallel lists
+    auto rotate = [&](auto &rows) {
+        if (destinationChild < sourceRow) {
+            std::rotate(rows.begin() + destinationChild, rows.begin() + sourceRow,
+                        rows.begin() + sourceRow + count);
+        } else {
+            std::rotate(rows.begin() + sourceRow, rows.begin() + sourceRow + count,
+                        rows.begin() + destinationChild);
+        }
+    };
+    rotate(exerciseRows);
+    rotate(setRows);
+    endMoveRows();
+    return true;
+}
+
+void ExerciseTableModel::setExercises(const QVector<Exercise> &exercises)
+{
+    beginResetModel();
+    exerciseRows = exercises;
+    setRows = QVector<QVector<SetEntry>>(exercises.size());
+    endResetModel();
+}
+
+void ExerciseTableModel::insertExercises(int row, const QVector<Exercise> &exercises)
+{
+    row = qBound(0, row, int(exerciseRows.size()));
+    if (exercises.isEmpty()) {
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), row, row + int(exercises.size()) - 1);
+    for (qsizetype i = 0; i < exercises.size(); ++i) {
+        exerciseRows.insert(row + i, exercises[i]);
+        setRows.insert(row + i, QVector<SetEntry>());
+    }
+    endInsertRows();
+}
+
+void ExerciseTableModel::setSets(int row, const QVector<SetEntry> &sets)
+{
+    if (row < 0 || row >= setRows.size()) {
+        return;
+    }
+
+    setRows[row] = sets;
+    // With set detail the set count is the number of rows
+    if (!sets.isEmpty() && exerciseRows[row].sets != sets.size()) {
+        exerciseRows[row].sets = int(sets.size());
+        const QModelIndex changed = index(row, SetsColumn);
+        emit dataChanged(changed, changed, {Qt::DisplayRole, Qt::EditRole});
+    }
+}
+
+void ExerciseTableModel::setAllSets(const QVector<QVector<SetEntry>> &sets)
+{
+    for (int row = 0; row < qMin(int(sets.size()), int(setRows.size())); ++row) {
+        setRows[row] = sets[row];
+    }
+}
+
+QVector<Exercise> ExerciseTableModel::parseRows(const QString &text)
+{
+    static const QRegularExpression lineBreak("\\r?\\n");
+    QVector<Exercise> exercises;
+    for (const QString &line : text.split(lineBreak, Qt::SkipEmptyParts)) {
+        const QStringList fields = line.split(line.contains('\t') ? QChar('\t') : QChar(','));
+        const QString name = fields.value(0).simplified();
+        if (name.isEmpty()) {
+            continue;
+        }
+        exercises.append(Exercise{name,
+                                  qMax(0, fields.value(1).trimmed().toInt()),
+                                  qMax(0, fields.value(2).trimmed().toInt())});
+    }
+    return exercises;
+}
@@ -0,0 +1,54 @@
+#ifndef EXERCISETABLEMODEL_H
+#define EXERCISETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include "../models/types.h"
+#include "../models/set_log.h"
+
+// Editable exercise list for WorkoutDialog. Values are held typed, so
+// reading the exercises back involves no text parsing; each row also
+// carries its optional per-set detail.
+class ExerciseTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { NameColumn, SetsColumn, RepsColumn, ColumnCount };
+
+    explicit ExerciseTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                  const QModelIndex &destinationParent, int destinationChild) override;
+
+    void setReadOnly(bool readOnly) { isReadOnly = readOnly; }
+
+    const QVector<Exercise> &exercises() const { return exerciseRows; }
+    void setExercises(const QVector<Exercise> &exercises);
+    void insertExercises(int row, const QVector<Exercise> &exercises);
+
+    const QVector<SetEntry> &sets(int row) const { return setRows[row]; }
+    // Also sets the row's set count when there is detail
+    void setSets(int row, const QVector<SetEntry> &sets);
+    const QVector<QVector<SetEntry>> &allSets() const { return setRows; }
+    void setAllSets(const QVector<QVector<SetEntry>> &sets);
+
+    // Rows of tab- or comma-separated "name, sets, reps" text, as copied
+    // from a spreadsheet; missing numbers are 0 and blank lines are skipped
+    static QVector<Exercise> parseRows(const QString &text);
+
+private:
+    QVector<Exercise> exerciseRows;
+    QVector<QVector<SetEntry>> setRows;  // Parallel to exerciseRows
+    bool isReadOnly = false;
+};
+
+#endif // EXERCISETABLEMODEL_H
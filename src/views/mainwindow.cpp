@@ -1,6 +1,20 @@
 #include "mainwindow.h"
 #include "customcalendarwidget.h"
 #include "../models/storage_manager.h"
+#include "../models/alloc_tracker.h"
+#include "scheduledialog.h"
+#include "statspanel.h"
+#include "recordsdialog.h"
+#include "mergedialog.h"
+#include "teamdashboard.h"
+#include "../models/workout_merge.h"
+#include "../models/profile_manager.h"
+#ifdef WORKOUT_SYNC
+#include "../sync/sync_client.h"
+#endif
+#include <QDockWidget>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QStyle>
 #include <QApplication>
 #include <QDate>
@@ -10,11 +24,20 @@
 #include <QPainter> 
 #include <QDebug>
 #include <QMessageBox>
+#include <QStatusBar>
+#include <QComboBox>
+#include <QInputDialog>
+#include <QLineEdit>
+#include <QShortcut>
+#include <QSignalBlocker>
+#include <QLocale>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , isMonthViewActive(true)
 {
+    // The application's own file is repaired on load rather than refused
+    StorageManager::instance().setSalvageDamaged(true);
     setupUI();
     createActions();
     createToolBar();
@@ -25,13 +48,17 @@ MainWindow::MainWindow(QWidget *parent)
     if (!StorageManager::instance().loadFromFile()) {
         qWarning() << "Failed to load workout data!";
     }
+    // Pick up edits made on other machines sharing the file
+    StorageManager::instance().setWatchingFile(true);
+    setupProfiles();
+    setupSync();
     
     // Initial data load and status update
     loadWorkoutData();
     handleDayClicked(QDate::currentDate());
     
     setWindowTitle(tr("Workout Tracker"));
-    resize(800, 600);
+    resize(1100, 600);
 }
 
 MainWindow::~MainWindow()
@@ -58,11 +85,22 @@ void MainWindow::setupUI()
     setupWeekView();
     weekView->loadWorkoutData();
     
+    statsPanel = new StatsPanel(this);
+    statsDock = new QDockWidget(tr("Statistics"), this);
+    statsDock->setObjectName("statsDock");
+    statsDock->setWidget(statsPanel);
+    addDockWidget(Qt::RightDockWidgetArea, statsDock);
+    
     // Connect signals
     connect(calendar, &QCalendarWidget::clicked,
             this, &MainWindow::handleDayClicked);
     connect(calendar, &CustomCalendarWidget::statusChanged,
             this, &MainWindow::handleCalendarStatusChanged);
+    connect(calendar, &CustomCalendarWidget::bulkStatusChanged,
+            this, &MainWindow::handleCalendarBulkStatusChanged);
+    // Both views refresh changed days themselves; only the label is ours
+    connect(&StorageManager::instance(), &StorageManager::workoutsChanged,
+            this, &MainWindow::handleWorkoutsChanged);
     connect(weekView, &WeekView::dayClicked,
             this, &MainWindow::handleDayClicked);
     
@@ -79,16 +117,9 @@ void MainWindow::setupWeekView()
     mainLayout->addWidget(weekView);
     weekView->hide(); // Initially hidden
     
-    // Connect signals
+    // Status edits reach the calendar through StorageManager::workoutsChanged
     connect(weekView, &WeekView::dayClicked,
             this, &MainWindow::handleDayClicked);
-    connect(weekView, &WeekView::statusChanged,
-            [this](const QDate& date, WorkoutStatus status) {
-                // Update calendar if it's not visible
-                if (isMonthViewActive) {
-                    calendar->setDayStatus(date, status);
-                }
-            });
 }
 
 void MainWindow::createActions()
@@ -122,6 +153,36 @@ void MainWindow::createActions()
     weekViewAction = new QAction(tr("Week View"), this);
     weekViewAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_DialogHelpButton));
     connect(weekViewAction, &QAction::triggered, this, &MainWindow::switchToWeekView);
+
+    // Create Plan Schedule action
+    planScheduleAction = new QAction(tr("Plan Schedule"), this);
+    planScheduleAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_FileDialogListView));
+    connect(planScheduleAction, &QAction::triggered, this, &MainWindow::planSchedule);
+
+    // Create Personal Records action
+    recordsAction = new QAction(tr("Personal Records"), this);
+    recordsAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_FileDialogInfoView));
+    connect(recordsAction, &QAction::triggered, this, &MainWindow::showPersonalRecords);
+
+    // Create Merge action
+    mergeAction = new QAction(tr("Merge File..."), this);
+    mergeAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_BrowserReload));
+    connect(mergeAction, &QAction::triggered, this, &MainWindow::mergeFile);
+
+    // Create Undo and Redo actions
+    undoAction = new QAction(tr("Undo"), this);
+    undoAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_ArrowBack));
+    undoAction->setShortcut(QKeySequence::Undo);
+    connect(undoAction, &QAction::triggered, this, &MainWindow::undo);
+
+    redoAction = new QAction(tr("Redo"), this);
+    redoAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_ArrowForward));
+    redoAction->setShortcut(QKeySequence::Redo);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::redo);
+
+    connect(&StorageManager::instance(), &StorageManager::undoStateChanged,
+            this, &MainWindow::updateUndoActions);
+    updateUndoActions();
 }
 
 void MainWindow::createToolBar()
@@ -129,9 +190,236 @@ void MainWindow::createToolBar()
     toolBar = addToolBar(tr("Main"));
     toolBar->addAction(newWorkoutAction);
     toolBar->addAction(editWorkoutAction);
+    toolBar->addAction(undoAction);
+    toolBar->addAction(redoAction);
     toolBar->addSeparator();
     toolBar->addAction(monthViewAction);
     toolBar->addAction(weekViewAction);
+    toolBar->addSeparator();
+    toolBar->addAction(planScheduleAction);
+    toolBar->addAction(statsDock->toggleViewAction());
+    toolBar->addAction(recordsAction);
+    toolBar->addAction(mergeAction);
+}
+
+void MainWindow::setupSync()
+{
+#ifdef WORKOUT_SYNC
+    // e.g. http://127.0.0.1:8765/sync for workout-sync-server
+    const QUrl endpoint(QString::fromLocal8Bit(qgetenv("WORKOUT_SYNC_URL")));
+    if (!endpoint.isValid() || endpoint.isEmpty()) {
+        return;
+    }
+
+    if (!syncAction) {
+        syncAction = new QAction(tr("Sync Now"), this);
+        syncAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_DriveNetIcon));
+        connect(syncAction, &QAction::triggered, this, [this] {
+            if (syncClient) {
+                syncClient->syncNow();
+            }
+        });
+        toolBar->addAction(syncAction);
+    }
+
+    // Each profile syncs with a history of its own on the server
+    const QString profile = profileManager->currentProfile();
+    syncClient = new SyncClient(StorageManager::instance(), endpoint,
+                                profile == ProfileManager::DefaultProfile ? QString() : profile, this);
+    connect(syncClient, &SyncClient::syncFinished, this,
+            [this](bool ok, int received, int sent, const QVector<QDate> &conflicts, const QString &error) {
+        if (!ok) {
+            statusBar()->showMessage(tr("Sync failed: %1").arg(error), 10000);
+        } else if (!conflicts.isEmpty()) {
+            QStringList days;
+            for (const QDate &date : conflicts) {
+                days << QLocale().toString(date, QLocale::ShortFormat);
+            }
+            QMessageBox::warning(this, tr("Sync"),
+                                 tr("These days were also changed on another device. This device's "
+                                    "version was kept:\n%1").arg(days.join('\n')));
+        } else if (received > 0 || sent > 0) {
+            statusBar()->showMessage(tr("Synced: %1 days received, %2 sent").arg(received).arg(sent), 5000);
+        }
+    });
+    syncClient->syncNow();
+#endif
+}
+
+void MainWindow::setupProfiles()
+{
+    profileManager = new ProfileManager(StorageManager::instance(), this);
+    connect(profileManager, &ProfileManager::profileChanged,
+            this, &MainWindow::handleProfileChanged);
+    connect(profileManager, &ProfileManager::saveFailed, this, [this](const QString &name) {
+        statusBar()->showMessage(tr("Could not save profile \"%1\"; its changes are kept open").arg(name), 10000);
+    });
+
+    profileCombo = new QComboBox(this);
+    profileCombo->setToolTip(tr("Active profile (Ctrl+P)"));
+    profileCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    connect(profileCombo, &QComboBox::activated, this, [this](int index) {
+        switchProfile(profileCombo->itemText(index));
+    });
+    auto profileShortcut = new QShortcut(QKeySequence(tr("Ctrl+P")), this);
+    connect(profileShortcut, &QShortcut::activated, this, [this] {
+        profileCombo->setFocus();
+        profileCombo->showPopup();
+    });
+
+    newProfileAction = new QAction(tr("New Profile..."), this);
+    newProfileAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_FileDialogNewFolder));
+    connect(newProfileAction, &QAction::triggered, this, &MainWindow::createProfile);
+
+    teamDashboardAction = new QAction(tr("Team Dashboard"), this);
+    teamDashboardAction->setIcon(QApplication::style()->standardIcon(QStyle::SP_FileDialogContentsView));
+    connect(teamDashboardAction, &QAction::triggered, this, &MainWindow::showTeamDashboard);
+
+    toolBar->addSeparator();
+    toolBar->addWidget(profileCombo);
+    toolBar->addAction(newProfileAction);
+    toolBar->addAction(teamDashboardAction);
+    refreshProfiles();
+}
+
+void MainWindow::refreshProfiles()
+{
+    QSignalBlocker blocker(profileCombo);
+    profileCombo->clear();
+    profileCombo->addItems(profileManager->profiles());
+    profileCombo->setCurrentText(profileManager->currentProfile());
+}
+
+void MainWindow::switchProfile(const QString &name)
+{
+    if (name == profileManager->currentProfile()) {
+        return;
+    }
+
+#ifdef WORKOUT_SYNC
+    // Sync state belongs to the outgoing profile's file
+    delete syncClient;
+    syncClient = nullptr;
+#endif
+    if (!profileManager->switchTo(name)) {
+        QMessageBox::warning(this, tr("Profiles"), tr("Could not open profile \"%1\".").arg(name));
+        refreshProfiles();
+    }
+    setupSync();
+}
+
+void MainWindow::createProfile()
+{
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, tr("New Profile"), tr("Athlete name:"),
+                                               QLineEdit::Normal, QString(), &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+    if (!profileManager->createProfile(name)) {
+        QMessageBox::warning(this, tr("New Profile"),
+            tr("\"%1\" already exists or is not a valid profile name.").arg(name));
+        return;
+    }
+    switchProfile(name);
+}
+
+void MainWindow::showTeamDashboard()
+{
+    // Kept between openings so its per-profile results stay cached
+    if (!teamDashboard) {
+        teamDashboard = new TeamDashboard(*profileManager, this);
+    }
+    teamDashboard->show();
+    teamDashboard->raise();
+    teamDashboard->activateWindow();
+}
+
+void MainWindow::handleProfileChanged(const QString &name)
+{
+    // The store now holds another history: rebuild everything shown
+    calendar->loadSavedData();
+    weekView->loadWorkoutData();
+    loadWorkoutData();
+    handleDayClicked(isMonthViewActive ? calendar->selectedDate() : weekView->selectedDate());
+    refreshProfiles();
+    setWindowTitle(name == ProfileManager::DefaultProfile ? tr("Workout Tracker")
+                                                          : tr("Workout Tracker - %1").arg(name));
+}
+
+void MainWindow::undo()
+{
+    // Both views and the label follow through workoutsChanged
+    StorageManager::instance().undo();
+}
+
+void MainWindow::redo()
+{
+    StorageManager::instance().redo();
+}
+
+void MainWindow::updateUndoActions()
+{
+    const StorageManager& storage = StorageManager::instance();
+    undoAction->setEnabled(storage.canUndo());
+    redoAction->setEnabled(storage.canRedo());
+    undoAction->setToolTip(storage.canUndo() ? tr("Undo changes to %1").arg(storage.undoText()) : tr("Undo"));
+    redoAction->setToolTip(storage.canRedo() ? tr("Redo changes to %1").arg(storage.redoText()) : tr("Redo"));
+}
+
+void MainWindow::planSchedule()
+{
+    if (StorageManager::instance().schedule().templates().isEmpty()) {
+        QMessageBox::information(this, tr("Plan Schedule"),
+            tr("Save a workout as a template first (right-click a day in the week view)."));
+        return;
+    }
+
+    QDate startDate = isMonthViewActive ? calendar->selectedDate()
+                                        : weekView->selectedDate();
+    ScheduleDialog dialog(startDate, this);
+    dialog.exec();
+}
+
+void MainWindow::showPersonalRecords()
+{
+    RecordsDialog dialog(this);
+    dialog.exec();
+}
+
+void MainWindow::mergeFile()
+{
+    const QString theirsPath = QFileDialog::getOpenFileName(this, tr("File to Merge In"),
+        QString(), tr("Workout data (*.json)"));
+    if (theirsPath.isEmpty()) {
+        return;
+    }
+    // The base is the last copy both sides had, e.g. the previous sync
+    const QString basePath = QFileDialog::getOpenFileName(this, tr("Common Base File"),
+        QFileInfo(theirsPath).absolutePath(), tr("Workout data (*.json)"));
+    if (basePath.isEmpty()) {
+        return;
+    }
+
+    StorageManager base;
+    StorageManager theirs;
+    if (!base.loadFromFile(basePath) || !theirs.loadFromFile(theirsPath)) {
+        QMessageBox::warning(this, tr("Merge"), tr("Could not read the selected files."));
+        return;
+    }
+
+    StorageManager &storage = StorageManager::instance();
+    WorkoutMerge merge(base, storage, theirs);
+    if (merge.days().isEmpty()) {
+        QMessageBox::information(this, tr("Merge"), tr("Nothing to merge: all changes are already here."));
+        return;
+    }
+
+    MergeDialog dialog(merge, this);
+    if (dialog.exec() == QDialog::Accepted) {
+        // One undo step; the views follow through workoutsChanged
+        storage.replaceDays(merge.result());
+    }
 }
 
 void MainWindow::createNewWorkout()
@@ -152,32 +440,14 @@ void MainWindow::editWorkout()
 
 void MainWindow::loadWorkoutData()
 {
-    QVector<QDate> dates = StorageManager::instance().getAllWorkoutDates();
-    qDebug() << "Found" << dates.size() << "saved workouts";
-    
-    // Load data for both views
-    for (const QDate& date : dates) {
-        QString name, description;
-        QVector<Exercise> exercises;
-        WorkoutStatus status;
-        
-        if (StorageManager::instance().loadWorkout(date, name, description, exercises, status)) {
-            // Update calendar
-            calendar->setWorkoutData(date, name, description, exercises);
-            calendar->setDayStatus(date, status);
-            
-            // Update week view if it exists
-            if (weekView) {
-                weekView->updateCell(date);
-            }
-        }
-    }
-    
-    // Force update
-    calendar->update();
+    qDebug() << "Found" << StorageManager::instance().records().size() << "saved workouts";
+
+    // One bulk pass per view; later changes reach them through workoutsChanged
+    calendar->loadSavedData();
     if (weekView) {
-        weekView->setCurrentDate(weekView->currentDate());
+        weekView->loadWorkoutData();
     }
+    statsPanel->refresh();
 }
 
 void MainWindow::switchToMonthView()
@@ -194,20 +464,8 @@ void MainWindow::switchToMonthView()
         qDebug() << "Switching to month view with date:" << selectedDate.toString(Qt::ISODate);
         
         isMonthViewActive = true;
-        
-        // Обновляем данные календаря
-        QVector<QDate> dates = StorageManager::instance().getAllWorkoutDates();
-        for (const QDate& date : dates) {
-            QString name, description;
-            QVector<Exercise> exercises;
-            WorkoutStatus status;
-            
-            if (StorageManager::instance().loadWorkout(date, name, description, exercises, status)) {
-                calendar->setWorkoutData(date, name, description, exercises);
-                calendar->setDayStatus(date, status);
-            }
-        }
-        
+
+        // The hidden calendar kept up through workoutsChanged
         calendar->setVisible(true);
         weekView->setVisible(false);
         
@@ -283,18 +541,21 @@ void MainWindow::handleDayClicked(const QDate &date)
         weekView->setSelectedDate(date);
     }
     
-    QString name, description;
-    QVector<Exercise> exercises;
-    WorkoutStatus status;
+    updateStatusLabel(date);
+    isUpdating = false;
+}
+
+void MainWindow::updateStatusLabel(const QDate &date)
+{
     QString statusText = QString("Selected: %1").arg(date.toString("dd.MM.yyyy"));
     
     // Reset status label style first
     statusLabel->setStyleSheet("QLabel { color: white; padding: 5px; }");
     
-    if (StorageManager::instance().loadWorkout(date, name, description, exercises, status)) {
-        statusText += QString(" - Workout: %1 (%2 exercises)").arg(name).arg(exercises.size());
+    if (const WorkoutRecord* workout = StorageManager::instance().find(date)) {
+        statusText += QString(" - Workout: %1 (%2 exercises)").arg(workout->name()).arg(workout->exercises().size());
         
-        switch (status) {
+        switch (workout->status) {
             case WorkoutStatus::Completed:
                 statusText += " - Completed";
                 statusLabel->setStyleSheet("QLabel { color: #4CAF50; padding: 5px; }");
@@ -308,72 +569,77 @@ void MainWindow::handleDayClicked(const QDate &date)
                 statusLabel->setStyleSheet("QLabel { color: #9E9E9E; padding: 5px; }");
                 break;
         }
+    } else if (const WorkoutTemplate* planned = StorageManager::instance().plannedWorkout(date)) {
+        statusText += QString(" - Planned: %1 (%2 exercises)").arg(planned->name).arg(planned->exercises.size());
+    }
+    
+    const StreakTracker& streaks = StorageManager::instance().streakTracker();
+    statusText += QString(" | Streak: %1 (best %2)").arg(streaks.currentStreak()).arg(streaks.longestStreak());
+    const double adherence = streaks.adherence(QDate::currentDate(), 90);
+    if (adherence >= 0) {
+        statusText += QString(" | 90-day adherence: %1%").arg(qRound(adherence * 100));
     }
     
     statusLabel->setText(statusText);
-    isUpdating = false;
 }
 
 void MainWindow::handleCalendarStatusChanged(const QDate& date, WorkoutStatus status)
 {
     if (isUpdating) return;
+    WT_ALLOC_SCOPE("status-change");
     isUpdating = true;
     
-    if (weekView) {
-        weekView->updateCell(date);
-    }
-    
-    QString name, description;
-    QVector<Exercise> exercises;
-    WorkoutStatus currentStatus;
+    // Only the status changes; the calendar already shows it and the week
+    // view picks it up from workoutsChanged
+    StorageManager::instance().setStatus(date, status);
     
-    if (StorageManager::instance().loadWorkout(date, name, description, exercises, currentStatus)) {
-        StorageManager::instance().saveWorkout(date, name, description, exercises, status);
-    } else {
-        StorageManager::instance().saveWorkout(date, "", "", QVector<Exercise>(), status);
-    }
-    
-    StorageManager::instance().saveToFile();
+    isUpdating = false;
+}
+
+void MainWindow::handleCalendarBulkStatusChanged(const QVector<QDate>& dates, WorkoutStatus status)
+{
+    if (isUpdating) return;
+    WT_ALLOC_SCOPE("status-change");
+    isUpdating = true;
     
-    calendar->loadSavedData();
-    weekView->loadWorkoutData();
+    // One transaction: a single save and a single change notification
+    StorageManager::instance().setStatus(dates, status);
     
     isUpdating = false;
 }
 
+void MainWindow::handleWorkoutsChanged(const QVector<QDate>& dates)
+{
+    // Streaks can change with any day, so the label is always refreshed
+    Q_UNUSED(dates);
+    updateStatusLabel(isMonthViewActive ? calendar->selectedDate()
+                                        : weekView->selectedDate());
+}
+
 void MainWindow::showWorkoutDialog(const QDate &date, bool readOnly)
 {
     WorkoutDialog* dialog = new WorkoutDialog(date, this);
     
-    QString name, description;
-    QVector<Exercise> exercises;
-    WorkoutStatus status;
+    StorageManager& storage = StorageManager::instance();
     
-    bool hasExistingWorkout = StorageManager::instance().loadWorkout(
-        date, name, description, exercises, status);
-        
-    if (hasExistingWorkout) {
-        dialog->setWorkoutName(name);
-        dialog->setWorkoutDescription(description);
-        dialog->setExercises(exercises);
+    if (const WorkoutRecord* existing = storage.find(date)) {
+        dialog->setWorkoutName(existing->name());
+        dialog->setWorkoutDescription(existing->description());
+        dialog->setExercises(toVector(existing->exercises()));
+        dialog->setExerciseSets(storage.sets().daySets(date, int(existing->exercises().size())));
+        dialog->setReadOnly(readOnly);
+    } else if (const WorkoutTemplate* planned = storage.plannedWorkout(date)) {
+        // Saving the dialog materializes the planned day
+        dialog->setWorkoutName(planned->name);
+        dialog->setWorkoutDescription(planned->description);
+        dialog->setExercises(toVector(planned->exercises));
         dialog->setReadOnly(readOnly);
     }
     
     if (dialog->exec() == QDialog::Accepted && !readOnly) {
-        name = dialog->getWorkoutName();
-        description = dialog->getWorkoutDescription();
-        exercises = dialog->getExercises();
-        
-        status = hasExistingWorkout ? status : WorkoutStatus::NoWorkout;
-        
-        StorageManager::instance().saveWorkout(date, name, description, exercises, status);
-        StorageManager::instance().saveToFile();
-        
-        calendar->setWorkoutData(date, name, description, exercises);
-        calendar->setDayStatus(date, status);
-        
+        // WorkoutDialog has already written the record to storage, and both
+        // views refreshed the day from workoutsChanged
         if (!isMonthViewActive) {
-            weekView->updateCell(date);
             weekView->setSelectedDate(date);  // Обновляем выбранную дату
             weekView->setCurrentDate(date);   // и текущую дату
         }
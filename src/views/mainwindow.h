@@ -13,6 +13,13 @@
 #include "customcalendarwidget.h"
 #include "workoutdialog.h"
 #include "weekview.h"
+#include "statspanel.h"
+
+class QDockWidget;
+class SyncClient;
+class ProfileManager;
+class QComboBox;
+class TeamDashboard;
 
 class MainWindow : public QMainWindow
 {
@@ -27,8 +34,19 @@ private slots:
     void editWorkout();
     void switchToMonthView();
     void switchToWeekView();
+    void planSchedule();
+    void showPersonalRecords();
+    void mergeFile();
+    void createProfile();
+    void showTeamDashboard();
+    void handleProfileChanged(const QString &name);
+    void undo();
+    void redo();
+    void updateUndoActions();
     void handleDayClicked(const QDate &date);
     void handleCalendarStatusChanged(const QDate& date, WorkoutStatus status);
+    void handleCalendarBulkStatusChanged(const QVector<QDate>& dates, WorkoutStatus status);
+    void handleWorkoutsChanged(const QVector<QDate>& dates);
 
 signals:
     void workoutDataLoaded();
@@ -37,10 +55,15 @@ private:
     void setupUI();
     void createActions();
     void createToolBar();
+    void setupSync();
+    void setupProfiles();
+    void refreshProfiles();
+    void switchProfile(const QString &name);
     void showWorkoutDialog(const QDate &date, bool readOnly);
     void setupWeekView();
     void updateViewVisibility();
     void loadWorkoutData();
+    void updateStatusLabel(const QDate &date);
     // Просто удалим reloadWorkoutData(), так как его функционал 
     // уже покрывается методом loadWorkoutData()
 
@@ -50,11 +73,25 @@ private:
     WeekView *weekView;
     QToolBar *toolBar;
     QLabel *statusLabel;
+    StatsPanel *statsPanel;
+    QDockWidget *statsDock;
 
     QAction *newWorkoutAction;
     QAction *editWorkoutAction;
     QAction *monthViewAction;
     QAction *weekViewAction;
+    QAction *planScheduleAction;
+    QAction *recordsAction;
+    QAction *mergeAction;
+    QAction *undoAction;
+    QAction *redoAction;
+    QAction *syncAction = nullptr;
+    SyncClient *syncClient = nullptr;
+    ProfileManager *profileManager;
+    QComboBox *profileCombo;
+    QAction *newProfileAction;
+    QAction *teamDashboardAction;
+    TeamDashboard *teamDashboard = nullptr;
     
     bool isMonthViewActive;
     bool isUpdating = false;
@@ -0,0 +1,94 @@
+#include "mergedialog.h"
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+namespace {
+constexpr int KeepColumn = 4;
+}
+
+MergeDialog::MergeDialog(WorkoutMerge &merge, QWidget *parent)
+    : QDialog(parent)
+    , merge(merge)
+{
+    setWindowTitle(tr("Merge"));
+
+    auto mainLayout = new QVBoxLayout(this);
+    mainLayout->addWidget(new QLabel(tr("%n day(s) change, %1 with conflicts.", "", int(merge.days().size()))
+                                         .arg(merge.conflictCount()), this));
+
+    dayTable = new QTableWidget(int(merge.days().size()), 5, this);
+    QStringList headers;
+    headers << tr("Date") << tr("Changes") << tr("Ours") << tr("Theirs") << tr("Keep");
+    dayTable->setHorizontalHeaderLabels(headers);
+    dayTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    dayTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    dayTable->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
+    dayTable->verticalHeader()->hide();
+    dayTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    for (int row = 0; row < merge.days().size(); ++row) {
+        const MergeDay &day = merge.days()[row];
+        const MergeFields changes = day.conflicts ? day.conflicts : day.taken;
+        dayTable->setItem(row, 0, new QTableWidgetItem(day.date.toString("dd.MM.yyyy")));
+        dayTable->setItem(row, 1, new QTableWidgetItem(mergeFieldNames(changes)));
+        dayTable->setItem(row, 2, new QTableWidgetItem(describe(day.ours)));
+        dayTable->setItem(row, 3, new QTableWidgetItem(describe(day.theirs)));
+
+        if (!day.conflicts) {
+            dayTable->setItem(row, KeepColumn, new QTableWidgetItem(tr("Theirs")));
+            continue;
+        }
+        auto sideCombo = new QComboBox(dayTable);
+        sideCombo->addItems({tr("Ours"), tr("Theirs")});
+        sideCombo->setCurrentIndex(day.resolution == MergeSide::Theirs ? 1 : 0);
+        connect(sideCombo, &QComboBox::currentIndexChanged, this, [this, row](int index) {
+            this->merge.days()[row].resolution = index == 1 ? MergeSide::Theirs : MergeSide::Ours;
+        });
+        dayTable->setCellWidget(row, KeepColumn, sideCombo);
+    }
+    mainLayout->addWidget(dayTable);
+
+    auto allLayout = new QHBoxLayout();
+    auto oursButton = new QPushButton(tr("Keep All Ours"), this);
+    auto theirsButton = new QPushButton(tr("Take All Theirs"), this);
+    connect(oursButton, &QPushButton::clicked, this, [this] { resolveAll(0); });
+    connect(theirsButton, &QPushButton::clicked, this, [this] { resolveAll(1); });
+    allLayout->addWidget(oursButton);
+    allLayout->addWidget(theirsButton);
+    allLayout->addStretch();
+    mainLayout->addLayout(allLayout);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    buttons->button(QDialogButtonBox::Ok)->setText(tr("Apply"));
+    connect(buttons, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(buttons);
+
+    resize(700, 450);
+}
+
+void MergeDialog::resolveAll(int side)
+{
+    for (int row = 0; row < dayTable->rowCount(); ++row) {
+        if (auto sideCombo = qobject_cast<QComboBox *>(dayTable->cellWidget(row, KeepColumn))) {
+            sideCombo->setCurrentIndex(side);
+        }
+    }
+}
+
+QString MergeDialog::describe(const DayState &state)
+{
+    if (!state.exists) {
+        return tr("(none)");
+    }
+    QString text = workoutStatusName(state.record.status);
+    if (!state.record.name().isEmpty()) {
+        text += QStringLiteral(": ") + state.record.name();
+    }
+    return text + tr(" (%n exercise(s))", "", int(state.record.exercises().size()));
+}
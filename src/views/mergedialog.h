@@ -0,0 +1,27 @@
+#ifndef MERGEDIALOG_H
+#define MERGEDIALOG_H
+
+#include <QDialog>
+#include <QTableWidget>
+#include "../models/workout_merge.h"
+
+// Reviews a three-way merge before it is applied: lists every day the merge
+// changes and lets the user pick a side for each conflict
+class MergeDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    MergeDialog(WorkoutMerge &merge, QWidget *parent = nullptr);
+
+private slots:
+    void resolveAll(int side);
+
+private:
+    static QString describe(const DayState &state);
+
+    WorkoutMerge &merge;
+    QTableWidget *dayTable;
+};
+
+#endif // MERGEDIALOG_H
@@ -0,0 +1,52 @@
+#include "recordsdialog.h"
+#include "../models/storage_manager.h"
+#include <QDialogButtonBox>
+#include <QHeaderView>
+#include <QLabel>
+#include <QVBoxLayout>
+
+RecordsDialog::RecordsDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Personal Records"));
+
+    auto mainLayout = new QVBoxLayout(this);
+    exerciseCombo = new QComboBox(this);
+    exerciseCombo->addItems(StorageManager::instance().personalRecords().exercises());
+    mainLayout->addWidget(new QLabel(tr("Exercise:"), this));
+    mainLayout->addWidget(exerciseCombo);
+
+    recordTable = new QTableWidget(0, 4, this);
+    QStringList headers;
+    headers << tr("Date") << tr("Metric") << tr("Value") << tr("Previous");
+    recordTable->setHorizontalHeaderLabels(headers);
+    recordTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    recordTable->verticalHeader()->hide();
+    recordTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    mainLayout->addWidget(recordTable);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(buttons);
+
+    connect(exerciseCombo, &QComboBox::currentTextChanged, this, &RecordsDialog::showExercise);
+    showExercise(exerciseCombo->currentText());
+    resize(450, 400);
+}
+
+void RecordsDialog::showExercise(const QString &exercise)
+{
+    const QVector<PersonalRecord> records = StorageManager::instance().personalRecords().history(exercise);
+
+    // Newest first
+    recordTable->setRowCount(int(records.size()));
+    for (int row = 0; row < records.size(); ++row) {
+        const PersonalRecord &record = records[records.size() - 1 - row];
+        recordTable->setItem(row, 0, new QTableWidgetItem(record.date.toString("dd.MM.yyyy")));
+        recordTable->setItem(row, 1, new QTableWidgetItem(recordMetricName(record.metric)));
+        recordTable->setItem(row, 2, new QTableWidgetItem(QString::number(double(record.value))));
+        recordTable->setItem(row, 3, new QTableWidgetItem(record.previous > 0
+                                                              ? QString::number(double(record.previous))
+                                                              : QString()));
+    }
+}
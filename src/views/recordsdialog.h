@@ -0,0 +1,26 @@
+#ifndef RECORDSDIALOG_H
+#define RECORDSDIALOG_H
+
+#include <QDialog>
+#include <QComboBox>
+#include <QTableWidget>
+#include "../models/personal_records.h"
+
+// Personal-record history of one exercise: every day that set a new best
+// for reps, volume or weight, read from the store's record index
+class RecordsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit RecordsDialog(QWidget *parent = nullptr);
+
+private slots:
+    void showExercise(const QString &exercise);
+
+private:
+    QComboBox *exerciseCombo;
+    QTableWidget *recordTable;
+};
+
+#endif // RECORDSDIALOG_H
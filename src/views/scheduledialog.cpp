@@ -0,0 +1,137 @@
+#include "scheduledialog.h"
+#include <QLabel>
+#include <QLocale>
+#include <QMessageBox>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFormLayout>
+
+ScheduleDialog::ScheduleDialog(const QDate &startDate, QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Plan Schedule"));
+    setupUI();
+
+    startEdit->setDate(startDate.isValid() ? startDate : QDate::currentDate());
+    if (startDate.isValid()) {
+        dayChecks[startDate.dayOfWeek() - 1]->setChecked(true);
+    }
+    loadSchedules();
+    updateControlsState();
+}
+
+void ScheduleDialog::setupUI()
+{
+    auto mainLayout = new QVBoxLayout(this);
+    auto formLayout = new QFormLayout;
+
+    templateCombo = new QComboBox(this);
+    for (const WorkoutTemplate &workout : StorageManager::instance().schedule().templates()) {
+        templateCombo->addItem(workout.name);
+    }
+    formLayout->addRow(tr("Template:"), templateCombo);
+
+    auto daysLayout = new QHBoxLayout;
+    for (int day = 1; day <= 7; ++day) {
+        dayChecks[day - 1] = new QCheckBox(QLocale().dayName(day, QLocale::ShortFormat), this);
+        daysLayout->addWidget(dayChecks[day - 1]);
+        connect(dayChecks[day - 1], &QCheckBox::toggled, this, &ScheduleDialog::updateControlsState);
+    }
+    formLayout->addRow(tr("Days:"), daysLayout);
+
+    startEdit = new QDateEdit(this);
+    startEdit->setCalendarPopup(true);
+    startEdit->setDisplayFormat("dd.MM.yyyy");
+    formLayout->addRow(tr("Starting:"), startEdit);
+
+    weeksSpin = new QSpinBox(this);
+    weeksSpin->setRange(1, 104);
+    weeksSpin->setValue(12);
+    weeksSpin->setSuffix(tr(" weeks"));
+    formLayout->addRow(tr("For:"), weeksSpin);
+    mainLayout->addLayout(formLayout);
+
+    addButton = new QPushButton(tr("Add to Schedule"), this);
+    mainLayout->addWidget(addButton);
+
+    mainLayout->addWidget(new QLabel(tr("Current schedules:"), this));
+    scheduleList = new QListWidget(this);
+    mainLayout->addWidget(scheduleList);
+
+    removeButton = new QPushButton(tr("Remove Schedule"), this);
+    closeButton = new QPushButton(tr("Close"), this);
+    auto buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(removeButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(closeButton);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(addButton, &QPushButton::clicked, this, &ScheduleDialog::addSchedule);
+    connect(removeButton, &QPushButton::clicked, this, &ScheduleDialog::removeSchedule);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    connect(scheduleList, &QListWidget::currentRowChanged, this, &ScheduleDialog::updateControlsState);
+
+    setMinimumWidth(450);
+}
+
+void ScheduleDialog::loadSchedules()
+{
+    scheduleList->clear();
+    for (const RecurrenceRule &rule : StorageManager::instance().schedule().rules()) {
+        scheduleList->addItem(describeRule(rule));
+    }
+}
+
+QString ScheduleDialog::describeRule(const RecurrenceRule &rule) const
+{
+    QStringList days;
+    for (int day = 1; day <= 7; ++day) {
+        if (rule.weekdays & RecurrenceRule::weekdayBit(day)) {
+            days << QLocale().dayName(day, QLocale::ShortFormat);
+        }
+    }
+    return tr("%1: %2, %3 - %4")
+        .arg(rule.templateName)
+        .arg(days.join("/"))
+        .arg(rule.start.toString("dd.MM.yyyy"))
+        .arg(rule.end.toString("dd.MM.yyyy"));
+}
+
+void ScheduleDialog::addSchedule()
+{
+    RecurrenceRule rule;
+    rule.templateName = templateCombo->currentText();
+    rule.start = startEdit->date();
+    rule.end = rule.start.addDays(weeksSpin->value() * 7 - 1);
+    for (int day = 1; day <= 7; ++day) {
+        if (dayChecks[day - 1]->isChecked()) {
+            rule.weekdays |= RecurrenceRule::weekdayBit(day);
+        }
+    }
+
+    if (!StorageManager::instance().addRecurrence(rule)) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not add the schedule"));
+        return;
+    }
+    loadSchedules();
+    updateControlsState();
+}
+
+void ScheduleDialog::removeSchedule()
+{
+    int row = scheduleList->currentRow();
+    if (row >= 0 && StorageManager::instance().removeRecurrence(row)) {
+        loadSchedules();
+        updateControlsState();
+    }
+}
+
+void ScheduleDialog::updateControlsState()
+{
+    bool anyDay = false;
+    for (QCheckBox *check : dayChecks) {
+        anyDay = anyDay || check->isChecked();
+    }
+    addButton->setEnabled(templateCombo->count() > 0 && anyDay);
+    removeButton->setEnabled(scheduleList->currentRow() >= 0);
+}
@@ -0,0 +1,44 @@
+#ifndef SCHEDULEDIALOG_H
+#define SCHEDULEDIALOG_H
+
+#include <QDialog>
+#include <QDate>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QDateEdit>
+#include <QSpinBox>
+#include <QListWidget>
+#include <QPushButton>
+#include "../models/schedule.h"
+#include "../models/storage_manager.h"
+
+// Plans a template on chosen weekdays for a number of weeks and lists the
+// existing plans. Changes go straight to StorageManager.
+class ScheduleDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit ScheduleDialog(const QDate &startDate, QWidget *parent = nullptr);
+
+private slots:
+    void addSchedule();
+    void removeSchedule();
+    void updateControlsState();
+
+private:
+    void setupUI();
+    void loadSchedules();
+    QString describeRule(const RecurrenceRule &rule) const;
+
+    QComboBox *templateCombo;
+    QCheckBox *dayChecks[7];
+    QDateEdit *startEdit;
+    QSpinBox *weeksSpin;
+    QListWidget *scheduleList;
+    QPushButton *addButton;
+    QPushButton *removeButton;
+    QPushButton *closeButton;
+};
+
+#endif // SCHEDULEDIALOG_H
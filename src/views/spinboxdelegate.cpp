@@ -0,0 +1,34 @@
+#include "spinboxdelegate.h"
+#include <QSpinBox>
+
+SpinBoxDelegate::SpinBoxDelegate(int minimum, int maximum, QObject *parent)
+    : QStyledItemDelegate(parent)
+    , minimum(minimum)
+    , maximum(maximum)
+{
+}
+
+QWidget *SpinBoxDelegate::createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                                       const QModelIndex &index) const
+{
+    Q_UNUSED(option);
+    Q_UNUSED(index);
+
+    auto editor = new QSpinBox(parent);
+    editor->setFrame(false);
+    editor->setRange(minimum, maximum);
+    return editor;
+}
+
+void SpinBoxDelegate::setEditorData(QWidget *editor, const QModelIndex &index) const
+{
+    static_cast<QSpinBox*>(editor)->setValue(index.data(Qt::EditRole).toInt());
+}
+
+void SpinBoxDelegate::setModelData(QWidget *editor, QAbstractItemModel *model,
+                                   const QModelIndex &index) const
+{
+    auto spinBox = static_cast<QSpinBox*>(editor);
+    spinBox->interpretText();
+    model->setData(index, spinBox->value(), Qt::EditRole);
+}
@@ -0,0 +1,26 @@
+#ifndef SPINBOXDELEGATE_H
+#define SPINBOXDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// Integer cells edited with a bounded spin box; the value goes to the model
+// as an int
+class SpinBoxDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    SpinBoxDelegate(int minimum, int maximum, QObject *parent = nullptr);
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
+                          const QModelIndex &index) const override;
+    void setEditorData(QWidget *editor, const QModelIndex &index) const override;
+    void setModelData(QWidget *editor, QAbstractItemModel *model,
+                      const QModelIndex &index) const override;
+
+private:
+    int minimum;
+    int maximum;
+};
+
+#endif // SPINBOXDELEGATE_H
@@ -0,0 +1,121 @@
+#include "statspanel.h"
+#include "../models/analytics.h"
+#include "../models/storage_manager.h"
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+
+// Acute:chronic ratio needs 28 days; 1RM changes compare two such windows
+constexpr int ChronicDays = 28;
+constexpr int WindowDays = 2 * ChronicDays;
+
+QString formatNumber(float value, int decimals = 0)
+{
+    return QString::number(double(value), 'f', decimals);
+}
+
+} // namespace
+
+StatsPanel::StatsPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    setupUI();
+    connect(&StorageManager::instance(), &StorageManager::workoutsChanged,
+            this, &StatsPanel::handleWorkoutsChanged);
+    refresh();
+}
+
+void StatsPanel::setupUI()
+{
+    auto mainLayout = new QVBoxLayout(this);
+    auto formLayout = new QFormLayout;
+
+    volumeLabel = new QLabel(this);
+    ratioLabel = new QLabel(this);
+    tonnageLabel = new QLabel(this);
+    ratioLabel->setToolTip(tr("Average daily volume over 7 days divided by that over 28 days. "
+                              "0.8-1.3 is usually considered a safe range."));
+    formLayout->addRow(tr("Volume (reps):"), volumeLabel);
+    formLayout->addRow(tr("Acute:chronic:"), ratioLabel);
+    formLayout->addRow(tr("Weekly tonnage:"), tonnageLabel);
+    mainLayout->addLayout(formLayout);
+
+    oneRepMaxTable = new QTableWidget(0, 4, this);
+    QStringList headers;
+    headers << tr("Exercise") << tr("Epley") << tr("Brzycki") << tr("Change");
+    oneRepMaxTable->setHorizontalHeaderLabels(headers);
+    oneRepMaxTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    oneRepMaxTable->verticalHeader()->hide();
+    oneRepMaxTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    oneRepMaxTable->setToolTip(tr("Best estimated one-rep max over the last 4 weeks; "
+                                  "the change is against the 4 weeks before"));
+    mainLayout->addWidget(oneRepMaxTable);
+}
+
+void StatsPanel::handleWorkoutsChanged(const QVector<QDate> &dates)
+{
+    // Edits outside the window cannot change what is shown
+    const QDate today = QDate::currentDate();
+    if (std::any_of(dates.cbegin(), dates.cend(), [&](const QDate &date) {
+            return date >= today.addDays(1 - WindowDays) && date <= today;
+        })) {
+        refresh();
+    }
+}
+
+void StatsPanel::refresh()
+{
+    using namespace Analytics;
+    const StorageManager &storage = StorageManager::instance();
+    const QDate today = QDate::currentDate();
+    const QDate from = today.addDays(1 - WindowDays);
+    const QDate recentFrom = today.addDays(1 - ChronicDays);
+
+    const DailyLoad load = dailyLoad(storage.records(), storage.sets(), from, today);
+    const qsizetype days = load.size();
+
+    QVector<float> weekly(days);
+    QVector<float> monthly(days);
+    QVector<float> ratio(days);
+    rollingSum(load.volume.constData(), weekly.data(), days, 7);
+    rollingSum(load.volume.constData(), monthly.data(), days, ChronicDays);
+    acuteChronicRatio(load.volume.constData(), ratio.data(), days, 7, ChronicDays);
+
+    volumeLabel->setText(tr("%1 this week, %2 in 4 weeks")
+                             .arg(formatNumber(weekly.last()), formatNumber(monthly.last())));
+    ratioLabel->setText(ratio.last() > 0 ? formatNumber(ratio.last(), 2) : tr("n/a"));
+
+    const QVector<WeeklyTotal> weeks = weeklyTotals(load);
+    QStringList tonnage;
+    for (qsizetype i = std::max<qsizetype>(0, weeks.size() - 4); i < weeks.size(); ++i) {
+        tonnage << formatNumber(weeks[i].tonnage);
+    }
+    tonnageLabel->setText(tonnage.join(QStringLiteral(" / ")));
+    tonnageLabel->setToolTip(tr("Weight x reps of logged sets, last 4 weeks, oldest first"));
+
+    const QHash<QString, float> epley = bestOneRepMax(storage.records(), storage.sets(),
+                                                      OneRepMaxFormula::Epley, recentFrom, today);
+    const QHash<QString, float> brzycki = bestOneRepMax(storage.records(), storage.sets(),
+                                                        OneRepMaxFormula::Brzycki, recentFrom, today);
+    const QHash<QString, float> previous = bestOneRepMax(storage.records(), storage.sets(),
+                                                         OneRepMaxFormula::Epley, from, recentFrom.addDays(-1));
+
+    QStringList exercises = epley.keys();
+    exercises.sort(Qt::CaseInsensitive);
+    oneRepMaxTable->setRowCount(int(exercises.size()));
+    for (int row = 0; row < exercises.size(); ++row) {
+        const QString &name = exercises[row];
+        const float before = previous.value(name);
+        const float now = epley.value(name);
+        QString change = before > 0 ? QString("%1%2%").arg(now >= before ? "+" : "")
+                                                       .arg(formatNumber((now - before) / before * 100, 1))
+                                    : QString();
+        oneRepMaxTable->setItem(row, 0, new QTableWidgetItem(name));
+        oneRepMaxTable->setItem(row, 1, new QTableWidgetItem(formatNumber(now, 1)));
+        oneRepMaxTable->setItem(row, 2, new QTableWidgetItem(formatNumber(brzycki.value(name), 1)));
+        oneRepMaxTable->setItem(row, 3, new QTableWidgetItem(change));
+    }
+}
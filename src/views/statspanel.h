@@ -0,0 +1,36 @@
+#ifndef STATSPANEL_H
+#define STATSPANEL_H
+
+#include <QWidget>
+#include <QDate>
+#include <QLabel>
+#include <QTableWidget>
+#include <QVector>
+
+// Training-load summary for the last weeks: rolling volume, acute:chronic
+// workload ratio, weekly tonnage and estimated one-rep maxes per exercise.
+// Recomputed from the whole window whenever workouts change; the kernels
+// in Analytics make that cheap.
+class StatsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StatsPanel(QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+private slots:
+    void handleWorkoutsChanged(const QVector<QDate> &dates);
+
+private:
+    void setupUI();
+
+    QLabel *volumeLabel;
+    QLabel *ratioLabel;
+    QLabel *tonnageLabel;
+    QTableWidget *oneRepMaxTable;
+};
+
+#endif // STATSPANEL_H
@@ -0,0 +1,199 @@
+#include "teamdashboard.h"
+#include "../models/profile_manager.h"
+#include "../models/storage_manager.h"
+#include <QDialogButtonBox>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrentMap>
+
+namespace {
+
+enum Column { AthleteColumn, CompletedColumn, MissedColumn, AdherenceColumn, VolumeColumn, TrendColumn };
+
+QString formatPercent(float fraction, bool sign = false)
+{
+    const QString number = QString::number(double(fraction) * 100, 'f', 0) + QLatin1Char('%');
+    return sign && fraction > 0 ? QLatin1Char('+') + number : number;
+}
+
+} // namespace
+
+TeamDashboard::TeamDashboard(ProfileManager &profiles, QWidget *parent)
+    : QDialog(parent)
+    , profiles(profiles)
+{
+    setWindowTitle(tr("Team Dashboard"));
+
+    auto mainLayout = new QVBoxLayout(this);
+    athleteTable = new QTableWidget(0, 6, this);
+    QStringList headers;
+    headers << tr("Athlete") << tr("Completed") << tr("Missed") << tr("Adherence")
+            << tr("Volume (last week)") << tr("Trend");
+    athleteTable->setHorizontalHeaderLabels(headers);
+    athleteTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    athleteTable->horizontalHeader()->setSectionResizeMode(AthleteColumn, QHeaderView::Stretch);
+    athleteTable->verticalHeader()->hide();
+    athleteTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    athleteTable->setToolTip(tr("Sessions this week so far; the trend compares last week's volume "
+                                "with the average of the four weeks before"));
+    mainLayout->addWidget(athleteTable);
+
+    totalsLabel = new QLabel(this);
+    mainLayout->addWidget(totalsLabel);
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    auto refreshButton = buttons->addButton(tr("Refresh"), QDialogButtonBox::ActionRole);
+    connect(refreshButton, &QPushButton::clicked, this, &TeamDashboard::refresh);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    mainLayout->addWidget(buttons);
+
+    connect(&watcher, &QFutureWatcher<Row>::resultReadyAt, this, &TeamDashboard::handleResultReady);
+
+    // Edits to the active profile reach its file on save; pick them up once
+    // they settle
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(500);
+    connect(&refreshTimer, &QTimer::timeout, this, &TeamDashboard::refresh);
+    connect(&StorageManager::instance(), &StorageManager::workoutsChanged, this, [this] {
+        if (isVisible()) {
+            refreshTimer.start();
+        }
+    });
+
+    resize(650, 400);
+}
+
+TeamDashboard::~TeamDashboard()
+{
+    // Workers only touch their own snapshot, but the watcher must not
+    // outlive the future it reports on
+    watcher.cancel();
+    watcher.waitForFinished();
+}
+
+void TeamDashboard::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+}
+
+TeamDashboard::Row TeamDashboard::summarize(const Job &job)
+{
+    Row row;
+    row.job = job;
+    StorageManager store;
+    row.ok = store.loadFromFile(job.path);
+    if (row.ok) {
+        row.summary = Analytics::athleteSummary(store.records(), store.sets(), job.today);
+    }
+    return row;
+}
+
+bool TeamDashboard::sameSnapshot(const Job &a, const Job &b)
+{
+    return a.path == b.path && a.modified == b.modified && a.size == b.size && a.today == b.today;
+}
+
+void TeamDashboard::refresh()
+{
+    if (watcher.isRunning()) {
+        // Whatever it produces is replaced by this pass
+        watcher.cancel();
+    }
+
+    const QDate today = QDate::currentDate();
+    const QStringList names = profiles.profiles();
+    athleteTable->setRowCount(int(names.size()));
+    rowOf.clear();
+
+    QList<Job> pending;
+    for (int i = 0; i < names.size(); ++i) {
+        Job job;
+        job.profile = names[i];
+        job.path = profiles.filePathFor(names[i]);
+        const QFileInfo info(job.path);
+        job.modified = info.lastModified();
+        job.size = info.size();
+        job.today = today;
+
+        rowOf.insert(job.profile, i);
+        athleteTable->setItem(i, AthleteColumn, new QTableWidgetItem(job.profile));
+        auto hit = memo.constFind(job.profile);
+        if (hit != memo.cend() && sameSnapshot(hit->job, job)) {
+            showRow(*hit);
+        } else {
+            for (int column = CompletedColumn; column <= TrendColumn; ++column) {
+                athleteTable->setItem(i, column, new QTableWidgetItem(tr("...")));
+            }
+            memo.remove(job.profile);
+            pending.append(job);
+        }
+    }
+    updateTotals();
+
+    if (!pending.isEmpty()) {
+        watcher.setFuture(QtConcurrent::mapped(std::move(pending), &TeamDashboard::summarize));
+    }
+}
+
+void TeamDashboard::handleResultReady(int index)
+{
+    if (watcher.isCanceled()) {
+        return;
+    }
+    const Row row = watcher.resultAt(index);
+    memo.insert(row.job.profile, row);
+    showRow(row);
+}
+
+void TeamDashboard::showRow(const Row &row)
+{
+    const int tableRow = rowOf.value(row.job.profile, -1);
+    if (tableRow < 0) {
+        return;
+    }
+    if (!row.ok) {
+        athleteTable->setItem(tableRow, CompletedColumn, new QTableWidgetItem(tr("unreadable")));
+        for (int column = MissedColumn; column <= TrendColumn; ++column) {
+            athleteTable->setItem(tableRow, column, new QTableWidgetItem());
+        }
+        return;
+    }
+
+    const Analytics::AthleteSummary &summary = row.summary;
+    const QVector<float> &weeks = summary.weeklyVolume;
+    const float lastWeek = weeks.size() >= 2 ? weeks[weeks.size() - 2] : 0.0f;
+    athleteTable->setItem(tableRow, CompletedColumn, new QTableWidgetItem(QString::number(summary.completed)));
+    athleteTable->setItem(tableRow, MissedColumn, new QTableWidgetItem(QString::number(summary.missed)));
+    athleteTable->setItem(tableRow, AdherenceColumn, new QTableWidgetItem(
+        summary.completed + summary.missed > 0 ? formatPercent(summary.adherence) : tr("n/a")));
+    athleteTable->setItem(tableRow, VolumeColumn, new QTableWidgetItem(QString::number(double(lastWeek), 'f', 0)));
+    athleteTable->setItem(tableRow, TrendColumn, new QTableWidgetItem(formatPercent(summary.volumeTrend, true)));
+    updateTotals();
+}
+
+void TeamDashboard::updateTotals()
+{
+    // The reduce step: team totals over the rows shown so far
+    int athletes = 0;
+    int completed = 0;
+    int missed = 0;
+    for (auto it = rowOf.cbegin(); it != rowOf.cend(); ++it) {
+        auto row = memo.constFind(it.key());
+        if (row == memo.cend() || !row->ok) {
+            continue;
+        }
+        ++athletes;
+        completed += row->summary.completed;
+        missed += row->summary.missed;
+    }
+    const int sessions = completed + missed;
+    totalsLabel->setText(tr("Team this week: %1 completed, %2 missed, %3 adherence (%4 of %5 athletes)")
+                             .arg(completed)
+                             .arg(missed)
+                             .arg(sessions > 0 ? formatPercent(float(completed) / float(sessions)) : tr("n/a"))
+                             .arg(athletes)
+                             .arg(rowOf.size()));
+}
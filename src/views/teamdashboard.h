@@ -0,0 +1,67 @@
+#ifndef TEAMDASHBOARD_H
+#define TEAMDASHBOARD_H
+
+#include <QDateTime>
+#include <QDialog>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTimer>
+#include "../models/analytics.h"
+
+class ProfileManager;
+
+// Week-to-date adherence, missed sessions and volume trend of every
+// profile. Each profile is summarized from its own data file on the
+// QtConcurrent pool, and rows appear as their profile finishes. Summaries
+// are kept per profile and reused while its file and the date are the
+// same, so only changed profiles are read again.
+class TeamDashboard : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit TeamDashboard(ProfileManager &profiles, QWidget *parent = nullptr);
+    ~TeamDashboard();
+
+    // What one map step needs and returns; plain values only, so workers
+    // share nothing with the GUI
+    struct Job {
+        QString profile;
+        QString path;
+        QDateTime modified;
+        qint64 size = 0;
+        QDate today;
+    };
+    struct Row {
+        Job job;
+        bool ok = false;
+        Analytics::AthleteSummary summary;
+    };
+
+public slots:
+    void refresh();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void handleResultReady(int index);
+
+private:
+    static Row summarize(const Job &job);
+    static bool sameSnapshot(const Job &a, const Job &b);
+    void showRow(const Row &row);
+    void updateTotals();
+
+    ProfileManager &profiles;
+    QTableWidget *athleteTable;
+    QLabel *totalsLabel;
+    QTimer refreshTimer;
+    QFutureWatcher<Row> watcher;
+    QHash<QString, Row> memo;     // by profile
+    QHash<QString, int> rowOf;    // table row by profile
+};
+
+#endif // TEAMDASHBOARD_H
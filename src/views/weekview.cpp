@@ -2,8 +2,15 @@
 #include "weekview.h"
 #include <QPainter>
 #include <QMouseEvent>
+#include <QGuiApplication>
+#include <QInputDialog>
+#include <QMessageBox>
 #include <QDebug>
+#include <algorithm>
+#include <utility>
 #include "../models/workout_status.h"
+#include "../models/alloc_tracker.h"
+#include "scheduledialog.h"
 
 WeekView::WeekView(QWidget* parent)
     : QWidget(parent)
@@ -17,16 +24,11 @@ WeekView::WeekView(QWidget* parent)
     setupNavigation();
     createHeaderLabels();
     createWeekCells();
-    
-    // Connect signals for cells
-    for (auto cell : m_cells) {
-        if (cell) {  // Add null check
-            connect(cell, &WeekViewCell::clicked,
-                    this, &WeekView::handleCellClicked);
-            connect(cell, &WeekViewCell::contextMenuRequested,
-                    this, &WeekView::handleCellContextMenu);
-        }
-    }
+
+    connect(&StorageManager::instance(), &StorageManager::workoutsChanged,
+            this, &WeekView::refreshDates);
+    connect(&StorageManager::instance(), &StorageManager::scheduleChanged,
+            this, &WeekView::loadWorkoutData);
 }
 
 void WeekView::createHeaderLabels()
@@ -62,41 +64,47 @@ void WeekView::createWeekCells()
     
     for (int i = 0; i < 7; ++i) {
         QDate cellDate = weekStart.addDays(i);
-        WeekViewCell* cell = new WeekViewCell(cellDate, this);
-        
-        connect(cell, &WeekViewCell::clicked,
-                this, &WeekView::handleCellClicked);
-        connect(cell, &WeekViewCell::contextMenuRequested,
-                this, &WeekView::handleCellContextMenu);
-        
-        m_gridLayout->addWidget(cell, 1, i);
-        m_cells[cellDate] = cell;
+        m_gridLayout->addWidget(createCell(cellDate), 1, i);
     }
     
     loadWorkoutData();
 }
 
+WeekViewCell* WeekView::createCell(const QDate& date)
+{
+    WeekViewCell* cell = new WeekViewCell(date, this);
+    
+    connect(cell, &WeekViewCell::clicked,
+            this, &WeekView::handleCellClicked);
+    connect(cell, &WeekViewCell::contextMenuRequested,
+            this, &WeekView::handleCellContextMenu);
+    connect(cell, &WeekViewCell::dragMoved,
+            this, &WeekView::handleCellDragged);
+    
+    m_cells[date] = cell;
+    return cell;
+}
+
 void WeekView::loadWorkoutData()
+{
+    for (auto it = m_cells.begin(); it != m_cells.end(); ++it) {
+        showCell(it.value(), it.key());
+    }
+}
+
+void WeekView::showCell(WeekViewCell* cell, const QDate& date)
 {
     StorageManager& storage = StorageManager::instance();
     
-    for (auto it = m_cells.begin(); it != m_cells.end(); ++it) {
-        const QDate& date = it.key();
-        WeekViewCell* cell = it.value();
-        
-        QString name, description;
-        QVector<Exercise> exercises;
-        WorkoutStatus status;
-        
-        if (storage.loadWorkout(date, name, description, exercises, status)) {
-            cell->setWorkoutData(name, description, exercises, status);
-        } else {
-            cell->setWorkoutData("", "", 
-                               QVector<Exercise>(), 
-                               WorkoutStatus::NoWorkout);
-        }
-        cell->update();
+    // Planned days are expanded only for the seven visible cells
+    if (const WorkoutRecord* workout = storage.find(date)) {
+        cell->setWorkoutData(*workout);
+    } else if (const WorkoutTemplate* planned = storage.plannedWorkout(date)) {
+        cell->setPlannedWorkout(*planned);
+    } else {
+        cell->clear();
     }
+    cell->update();
 }
 
 QDate WeekView::getWeekStart(const QDate& date) const
@@ -107,6 +115,7 @@ QDate WeekView::getWeekStart(const QDate& date) const
 
 void WeekView::setCurrentDate(const QDate& date)
 {
+    WT_ALLOC_SCOPE("week-nav");
     if (m_currentDate != date) {
         m_currentDate = date;
         updateView();
@@ -130,25 +139,13 @@ void WeekView::updateView()
     
     for (int i = 0; i < 7; ++i) {
         QDate cellDate = weekStart.addDays(i);
-        WeekViewCell* cell = new WeekViewCell(cellDate, this);
-        
-        connect(cell, &WeekViewCell::clicked,
-                this, &WeekView::handleCellClicked);
-        connect(cell, &WeekViewCell::contextMenuRequested,
-                this, &WeekView::handleCellContextMenu);
-        
-        m_gridLayout->addWidget(cell, 1, i);
-        m_cells[cellDate] = cell;
+        m_gridLayout->addWidget(createCell(cellDate), 1, i);
     }
     
     loadWorkoutData();
     
     // Reset selection
-    if (m_selectedDate.isValid()) {
-        if (auto cell = m_cells.value(m_selectedDate)) {
-            cell->setSelected(true);
-        }
-    }
+    updateCellSelection();
 }
 
 void WeekView::handleCellClicked(const QDate& date)
@@ -157,83 +154,176 @@ void WeekView::handleCellClicked(const QDate& date)
         return;
     }
 
-    if (auto oldCell = m_cells.value(m_selectedDate)) {
-        oldCell->setSelected(false);
+    const Qt::KeyboardModifiers modifiers = QGuiApplication::keyboardModifiers();
+    if (modifiers & Qt::ControlModifier) {
+        if (m_selectedDates.isEmpty() && m_selectedDate.isValid()) {
+            m_selectedDates.insert(m_selectedDate);
+        }
+        if (!m_selectedDates.remove(date)) {
+            m_selectedDates.insert(date);
+        }
+        m_anchorDate = date;
+    } else if ((modifiers & Qt::ShiftModifier) && m_anchorDate.isValid()) {
+        selectRange(m_anchorDate, date);
+    } else {
+        m_selectedDates.clear();
+        m_anchorDate = date;
     }
 
     m_selectedDate = date;
-    
-    if (auto newCell = m_cells.value(m_selectedDate)) {
-        newCell->setSelected(true);
-    }
+    updateCellSelection();
 
     emit dayClicked(date);
 }
 
+void WeekView::handleCellDragged(const QPoint& globalPos)
+{
+    auto cell = qobject_cast<WeekViewCell*>(childAt(mapFromGlobal(globalPos)));
+    if (!cell || !m_anchorDate.isValid() || cell->date() == m_selectedDate) {
+        return;
+    }
+
+    m_selectedDate = cell->date();
+    selectRange(m_anchorDate, m_selectedDate);
+    updateCellSelection();
+}
+
+void WeekView::selectRange(const QDate& from, const QDate& to)
+{
+    m_selectedDates.clear();
+    const QDate first = qMin(from, to);
+    const QDate last = qMax(from, to);
+    for (QDate date = first; date <= last; date = date.addDays(1)) {
+        m_selectedDates.insert(date);
+    }
+}
+
+void WeekView::updateCellSelection()
+{
+    for (auto it = m_cells.cbegin(); it != m_cells.cend(); ++it) {
+        it.value()->setSelected(it.key() == m_selectedDate || m_selectedDates.contains(it.key()));
+    }
+}
+
+QVector<QDate> WeekView::selectedDates() const
+{
+    if (m_selectedDates.isEmpty()) {
+        return {m_selectedDate};
+    }
+    QVector<QDate> dates(m_selectedDates.cbegin(), m_selectedDates.cend());
+    std::sort(dates.begin(), dates.end());
+    return dates;
+}
+
+void WeekView::refreshDates(const QVector<QDate>& dates)
+{
+    for (const QDate& date : dates) {
+        updateCell(date);
+    }
+}
+
 void WeekView::updateCell(const QDate& date)
 {
     if (WeekViewCell* cell = m_cells.value(date)) {
-        QString name, description;
-        QVector<Exercise> exercises;
-        WorkoutStatus status;
-        
-        StorageManager::instance().loadWorkout(date, name, description, exercises, status);
-        cell->setWorkoutData(name, description, exercises, status);
-        cell->update();
+        showCell(cell, date);
     }
 }
 
 bool WeekView::hasWorkout(const QDate& date) const
 {
     if (auto it = m_cells.find(date); it != m_cells.end()) {
-        return !it.value()->workoutName().isEmpty();
+        return !it.value()->workoutName().isEmpty() && !it.value()->isPlanned();
     }
     return false;
 }
 
 void WeekView::updateCellStatus(const QDate& date, WorkoutStatus status)
 {
-    if (auto cell = m_cells.value(date)) {
-        QString name = cell->workoutName();
-        QString description = cell->workoutDescription();
-        QVector<Exercise> exercises = cell->workoutExercises();
-        
-        // Сначала обновляем в хранилище
-        StorageManager::instance().saveWorkout(date, name, description, exercises, status);
-        StorageManager::instance().saveToFile();  // Явно сохраняем
-        
-        // Затем обновляем ячейку
-        cell->setWorkoutData(name, description, exercises, status);
-        cell->update();
+    WT_ALLOC_SCOPE("status-change");
+    if (m_cells.contains(date)) {
+        // Обновляем только статус; ячейка обновится по workoutsChanged
+        StorageManager::instance().setStatus(date, status);
         
         // Испускаем сигнал для синхронизации
         emit statusChanged(date, status);
     }
 }
 
+void WeekView::setDatesStatus(const QVector<QDate>& dates, WorkoutStatus status)
+{
+    if (dates.size() == 1) {
+        updateCellStatus(dates.first(), status);
+        return;
+    }
+
+    // One save and one change notification for the whole selection
+    WT_ALLOC_SCOPE("status-change");
+    StorageManager::instance().setStatus(dates, status);
+}
+
 void WeekView::handleCellContextMenu(const QDate& date, const QPoint& globalPos)
 {
     QMenu menu(this);
+
+    // Right-clicking inside a multi-day selection acts on all of it
+    QVector<QDate> dates = selectedDates();
+    if (!dates.contains(date)) {
+        dates = {date};
+    }
+    if (dates.size() > 1) {
+        menu.addSection(tr("%n days selected", nullptr, int(dates.size())));
+    }
     
     QAction* completedAction = menu.addAction(tr("Mark as Completed"));
     QAction* missedAction = menu.addAction(tr("Mark as Missed"));
     QAction* plannedAction = menu.addAction(tr("Mark as Planned"));
     QAction* restAction = menu.addAction(tr("Mark as Rest Day"));
     
-    connect(completedAction, &QAction::triggered, this, [this, date]() {
-        updateCellStatus(date, WorkoutStatus::Completed);
+    connect(completedAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::Completed);
     });
     
-    connect(missedAction, &QAction::triggered, this, [this, date]() {
-        updateCellStatus(date, WorkoutStatus::Missed);
+    connect(missedAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::Missed);
     });
     
-    connect(plannedAction, &QAction::triggered, this, [this, date]() {
-        updateCellStatus(date, WorkoutStatus::NoWorkout);
+    connect(plannedAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::NoWorkout);
     });
     
-    connect(restAction, &QAction::triggered, this, [this, date]() {
-        updateCellStatus(date, WorkoutStatus::RestDay);
+    connect(restAction, &QAction::triggered, this, [this, dates]() {
+        setDatesStatus(dates, WorkoutStatus::RestDay);
+    });
+
+    StorageManager& storage = StorageManager::instance();
+    const WorkoutRecord* workout = storage.find(date);
+    menu.addSeparator();
+
+    QAction* copyAction = menu.addAction(tr("Copy Workout"));
+    copyAction->setEnabled((workout && !workout->name().isEmpty()) || storage.plannedWorkout(date));
+    connect(copyAction, &QAction::triggered, this, [this, date]() {
+        copyWorkout(date);
+    });
+
+    QAction* pasteAction = menu.addAction(tr("Paste Workout"));
+    pasteAction->setEnabled(copiedWorkout != nullptr);
+    connect(pasteAction, &QAction::triggered, this, [this, dates]() {
+        pasteWorkout(dates);
+    });
+
+    menu.addSeparator();
+
+    QAction* templateAction = menu.addAction(tr("Save as Template..."));
+    templateAction->setEnabled(workout && !workout->name.isEmpty());
+    connect(templateAction, &QAction::triggered, this, [this, date]() {
+        saveAsTemplate(date);
+    });
+
+    QAction* planAction = menu.addAction(tr("Plan Schedule..."));
+    planAction->setEnabled(!storage.schedule().templates().isEmpty());
+    connect(planAction, &QAction::triggered, this, [this, date]() {
+        ScheduleDialog dialog(date, this);
+        dialog.exec();
     });
     
     menu.exec(globalPos);
@@ -300,44 +390,77 @@ void WeekView::updateWeekLabel()
 
 void WeekView::copyWorkout(const QDate& date)
 {
-    QString name, description;
-    QVector<Exercise> exercises;
-    WorkoutStatus status;
-    
-    if (StorageManager::instance().loadWorkout(date, name, description, exercises, status)) {
-        copiedWorkout.name = name;
-        copiedWorkout.description = description;
-        copiedWorkout.exercises = exercises;
+    StorageManager& storage = StorageManager::instance();
+    if (const WorkoutRecord* workout = storage.find(date)) {
+        copiedWorkout = workout->body;
+    } else if (const WorkoutTemplate* planned = storage.plannedWorkout(date)) {
+        copiedWorkout = WorkoutRecord(WorkoutBody{planned->name, planned->description,
+                                                  planned->exercises}).body;
     }
 }
 
-void WeekView::pasteWorkout(const QDate& date)
+void WeekView::pasteWorkout(const QVector<QDate>& dates)
 {
-    if (!copiedWorkout.isNull()) {
-        StorageManager::instance().saveWorkout(
-            date, 
-            copiedWorkout.name,
-            copiedWorkout.description,
-            copiedWorkout.exercises,
-            WorkoutStatus::NoWorkout
-        );
-        
-        updateCell(date);
+    if (!copiedWorkout) {
+        return;
+    }
+
+    // Pasting over a selection is one save; cells refresh from workoutsChanged
+    StorageManager& storage = StorageManager::instance();
+    StorageManager::Transaction transaction(storage);
+    for (const QDate& date : dates) {
+        WorkoutRecord workout;
+        workout.body = copiedWorkout;
+        if (const WorkoutRecord* existing = storage.find(date)) {
+            workout.status = existing->status;
+        }
+        storage.saveWorkout(date, std::move(workout));
+    }
+    transaction.commit();
+
+    for (const QDate& date : dates) {
         emit workoutModified(date);
     }
 }
 
+void WeekView::saveAsTemplate(const QDate& date)
+{
+    StorageManager& storage = StorageManager::instance();
+    const WorkoutRecord* workout = storage.find(date);
+    if (!workout) {
+        return;
+    }
+
+    bool ok = false;
+    QString name = QInputDialog::getText(this, tr("Save as Template"), tr("Template name:"),
+                                         QLineEdit::Normal, workout->name(), &ok).trimmed();
+    if (!ok || name.isEmpty()) {
+        return;
+    }
+
+    // The dialog ran an event loop; look the record up again
+    workout = storage.find(date);
+    if (!workout) {
+        return;
+    }
+    WorkoutTemplate workoutTemplate;
+    workoutTemplate.name = name;
+    workoutTemplate.description = workout->description;
+    workoutTemplate.exercises = workout->exercises;
+    if (!storage.saveTemplate(std::move(workoutTemplate))) {
+        QMessageBox::warning(this, tr("Error"), tr("Could not save the template"));
+    }
+}
+
 void WeekView::setSelectedDate(const QDate& date)
 {
-    if (auto oldCell = m_cells.value(m_selectedDate)) {
-        oldCell->setSelected(false);
+    // Selecting a day outside the multi-day selection drops it
+    if (!m_selectedDates.contains(date)) {
+        m_selectedDates.clear();
+        m_anchorDate = date;
     }
-    
     m_selectedDate = date;
-    
-    if (auto newCell = m_cells.value(m_selectedDate)) {
-        newCell->setSelected(true);
-    }
+    updateCellSelection();
     
     update();
 }
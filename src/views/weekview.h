@@ -5,6 +5,7 @@
 #include <QGridLayout>
 #include <QLabel>
 #include <QMap>
+#include <QSet>
 #include <QDate>
 #include <QMenu>
 #include <QPushButton>
@@ -27,6 +28,9 @@ public:
     WeekViewCell* getCell(const QDate& date);
     void setSelectedDate(const QDate& date);
     QDate selectedDate() const;
+    // Days picked with ctrl-click, shift-click or a drag, in date order;
+    // just selectedDate() when no range is selected
+    QVector<QDate> selectedDates() const;
 
 signals:
     void dayClicked(const QDate& date);
@@ -36,10 +40,13 @@ signals:
 public slots:
     void nextWeek();
     void prevWeek();
+    // Re-reads the cells of `dates` that are in the current week
+    void refreshDates(const QVector<QDate>& dates);
 
 private slots:
     void updateView();
     void handleCellClicked(const QDate& date);
+    void handleCellDragged(const QPoint& globalPos);
     void handleCellContextMenu(const QDate& date, const QPoint& globalPos);
     void updateCellStatus(const QDate& date, WorkoutStatus status);
 
@@ -51,6 +58,8 @@ private:
     QPushButton* nextWeekButton;
     QLabel* weekLabel;
     QDate m_selectedDate;
+    QSet<QDate> m_selectedDates;  // multi-day selection, may span weeks
+    QDate m_anchorDate;
     
     void createHeaderLabels();
     void createWeekCells();
@@ -58,16 +67,17 @@ private:
     QDate getWeekStart(const QDate& date) const;
     void setupNavigation();
     void copyWorkout(const QDate& date);
-    void pasteWorkout(const QDate& date);
+    void pasteWorkout(const QVector<QDate>& dates);
+    void saveAsTemplate(const QDate& date);
+    void showCell(WeekViewCell* cell, const QDate& date);
     void updateWeekLabel();
+    WeekViewCell* createCell(const QDate& date);
+    void selectRange(const QDate& from, const QDate& to);
+    void updateCellSelection();
+    void setDatesStatus(const QVector<QDate>& dates, WorkoutStatus status);
 
-    struct CopiedWorkoutData {
-        QString name;
-        QString description;
-        QVector<Exercise> exercises;
-        bool isNull() const { return name.isEmpty(); }
-    };
-    CopiedWorkoutData copiedWorkout;
+    // Shared with the store, so pasting never copies the exercises
+    WorkoutBodyPtr copiedWorkout;
 };
 
 #endif // WEEKVIEW_H
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <QMouseEvent>
 #include <QContextMenuEvent>
 #include <QFontMetrics>
+#include "../models/alloc_tracker.h"
 
 WeekViewCell::WeekViewCell(const QDate& date, QWidget* parent)
     : QWidget(parent)
@@ -20,15 +21,14 @@ WeekViewCell::WeekViewCell(const QDate& date, QWidget* parent)
     setPalette(pal);
 }
 
-void WeekViewCell::setWorkoutData(const QString& name, 
-                               const QString& description,
-                               const QVector<Exercise>& exercises,
-                               WorkoutStatus status)
+void WeekViewCell::setWorkoutData(const WorkoutRecord& workout)
 {
-    m_workoutName = name;
-    m_workoutDescription = description;
-    m_exercises = exercises;
-    m_status = status;
+    // Strings are implicitly shared with the store; only the count is painted
+    m_workoutName = workout.name();
+    m_workoutDescription = workout.description();
+    m_exerciseCount = workout.exercises().size();
+    m_status = workout.status;
+    m_isPlanned = false;
     update();  // Force immediate update
     
     // If status changed, force parent update too
@@ -37,17 +37,29 @@ void WeekViewCell::setWorkoutData(const QString& name,
     }
 }
 
+void WeekViewCell::setPlannedWorkout(const WorkoutTemplate& workout)
+{
+    m_workoutName = workout.name;
+    m_workoutDescription = workout.description;
+    m_exerciseCount = workout.exercises.size();
+    m_status = WorkoutStatus::NoWorkout;
+    m_isPlanned = true;
+    update();
+}
+
 void WeekViewCell::clear()
 {
+    m_isPlanned = false;
     m_workoutName.clear();
     m_workoutDescription.clear();
-    m_exercises.clear();
+    m_exerciseCount = 0;
     m_status = WorkoutStatus::NoWorkout;
     update();
 }
 
 void WeekViewCell::paintEvent(QPaintEvent* event)
 {
+    WT_ALLOC_SCOPE("repaint");
     Q_UNUSED(event);
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
@@ -110,6 +122,7 @@ void WeekViewCell::paintEvent(QPaintEvent* event)
         QFont nameFont = painter.font();
         nameFont.setPointSize(12);
         nameFont.setBold(true);
+        nameFont.setItalic(m_isPlanned);
         painter.setFont(nameFont);
         
         painter.setPen(Qt::white);  // Always white text for workout info
@@ -124,7 +137,8 @@ void WeekViewCell::paintEvent(QPaintEvent* event)
         QRect exerciseRect = rect.adjusted(10, rect.height()/2, -10, -10);
         painter.drawText(exerciseRect, 
                         Qt::AlignLeft | Qt::AlignTop,
-                        tr("%1 exercises").arg(m_exercises.size()));
+                        m_isPlanned ? tr("%1 exercises (planned)").arg(m_exerciseCount)
+                                    : tr("%1 exercises").arg(m_exerciseCount));
     }
 }
 
@@ -152,6 +166,14 @@ void WeekViewCell::mousePressEvent(QMouseEvent* event)
     }
 }
 
+void WeekViewCell::mouseMoveEvent(QMouseEvent* event)
+{
+    // The pressed cell keeps the mouse grab, so it reports the whole drag
+    if (event->buttons() & Qt::LeftButton) {
+        emit dragMoved(event->globalPosition().toPoint());
+    }
+}
+
 void WeekViewCell::contextMenuEvent(QContextMenuEvent* event)
 {
     emit contextMenuRequested(m_date, event->globalPos());
@@ -6,6 +6,7 @@
 #include <QDate>
 #include <QPainterPath>
 #include "../models/types.h"
+#include "../models/schedule.h"
 #include "../models/workout_status.h"
 
 class WeekViewCell : public QWidget {
@@ -13,38 +14,43 @@ class WeekViewCell : public QWidget {
 public:
     explicit WeekViewCell(const QDate& date, QWidget* parent = nullptr);
     
-    void setWorkoutData(const QString& name, 
-                       const QString& description,
-                       const QVector<Exercise>& exercises,
-                       WorkoutStatus status);
+    void setWorkoutData(const WorkoutRecord& workout);
+    // Shows a template planned for the day, without a stored record
+    void setPlannedWorkout(const WorkoutTemplate& workout);
+    bool isPlanned() const { return m_isPlanned; }
     void clear();
 
     void setSelected(bool selected);
     bool isSelected() const { return m_isSelected; }
+    QDate date() const { return m_date; }
     
     // Getters
     QString workoutName() const { return m_workoutName; }
     QString workoutDescription() const { return m_workoutDescription; }
-    QVector<Exercise> workoutExercises() const { return m_exercises; }
+    int exerciseCount() const { return m_exerciseCount; }
     WorkoutStatus workoutStatus() const { return m_status; }
 
 signals:
     void clicked(const QDate& date);
     void contextMenuRequested(const QDate& date, const QPoint& globalPos);
+    // Mouse moved with the left button held after pressing this cell
+    void dragMoved(const QPoint& globalPos);
 
 protected:
     void paintEvent(QPaintEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
     void contextMenuEvent(QContextMenuEvent* event) override;
 
 private:
     QDate m_date;
     QString m_workoutName;
     QString m_workoutDescription;
-    QVector<Exercise> m_exercises;
+    int m_exerciseCount = 0;
     WorkoutStatus m_status;
     QColor getStatusColor() const;
     bool m_isSelected = false;
+    bool m_isPlanned = false;
 };
 
 #endif // WEEKVIEWCELL_H
\ No newline at end of file
@@ -1,7 +1,13 @@
 #include "workoutdialog.h"
+#include "exercisenamedelegate.h"
+#include "spinboxdelegate.h"
 #include <QLabel>
 #include <QMessageBox>
 #include <QHeaderView>
+#include <QApplication>
+#include <QClipboard>
+#include <QShortcut>
+#include <algorithm>
 
 WorkoutDialog::WorkoutDialog(const QDate &date, QWidget *parent)
     : QDialog(parent)
@@ -38,11 +44,31 @@ void WorkoutDialog::setupUI()
     auto exerciseButtonLayout = new QHBoxLayout;  // Changed name to be more specific
     addExerciseButton = new QPushButton(tr("Add Exercise"), this);
     removeExerciseButton = new QPushButton(tr("Remove Exercise"), this);
+    moveUpButton = new QPushButton(tr("Move Up"), this);
+    moveDownButton = new QPushButton(tr("Move Down"), this);
+    moveUpButton->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_Up));
+    moveDownButton->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_Down));
     exerciseButtonLayout->addWidget(addExerciseButton);
     exerciseButtonLayout->addWidget(removeExerciseButton);
+    exerciseButtonLayout->addWidget(moveUpButton);
+    exerciseButtonLayout->addWidget(moveDownButton);
     exerciseButtonLayout->addStretch();
     mainLayout->addLayout(exerciseButtonLayout);
     
+    // Per-set detail of the selected exercise
+    auto setsLabel = new QLabel(tr("Sets of the selected exercise:"), this);
+    setupSetTable();
+    mainLayout->addWidget(setsLabel);
+    mainLayout->addWidget(setTable);
+    
+    auto setButtonLayout = new QHBoxLayout;
+    addSetButton = new QPushButton(tr("Add Set"), this);
+    removeSetButton = new QPushButton(tr("Remove Set"), this);
+    setButtonLayout->addWidget(addSetButton);
+    setButtonLayout->addWidget(removeSetButton);
+    setButtonLayout->addStretch();
+    mainLayout->addLayout(setButtonLayout);
+    
     // Add edit button and final buttons
     editButton = new QPushButton(tr("Edit"), this);
     saveButton = new QPushButton(tr("Save"), this);
@@ -58,9 +84,21 @@ void WorkoutDialog::setupUI()
     // Connect signals
     connect(addExerciseButton, &QPushButton::clicked, this, &WorkoutDialog::addExercise);
     connect(removeExerciseButton, &QPushButton::clicked, this, &WorkoutDialog::removeExercise);
+    connect(moveUpButton, &QPushButton::clicked, this, &WorkoutDialog::moveExerciseUp);
+    connect(moveDownButton, &QPushButton::clicked, this, &WorkoutDialog::moveExerciseDown);
     connect(saveButton, &QPushButton::clicked, this, &WorkoutDialog::saveWorkout);
     connect(cancelButton, &QPushButton::clicked, this, &QDialog::reject);
     connect(editButton, &QPushButton::clicked, this, &WorkoutDialog::editWorkout);
+    connect(addSetButton, &QPushButton::clicked, this, &WorkoutDialog::addSet);
+    connect(removeSetButton, &QPushButton::clicked, this, &WorkoutDialog::removeSet);
+    connect(exerciseTable->selectionModel(), &QItemSelectionModel::currentRowChanged, this,
+            [this](const QModelIndex &current) { showSetsForRow(current.row()); });
+    
+    // Multi-row paste of "name, sets, reps" lines, e.g. from a spreadsheet
+    auto pasteShortcut = new QShortcut(QKeySequence::Paste, exerciseTable);
+    pasteShortcut->setContext(Qt::WidgetShortcut);
+    connect(pasteShortcut, &QShortcut::activated, this, &WorkoutDialog::pasteExercises);
+    connect(setTable, &QTableWidget::itemChanged, this, &WorkoutDialog::storeSetsForRow);
     
     setMinimumWidth(500);
     updateControlsState();
@@ -68,12 +106,10 @@ void WorkoutDialog::setupUI()
 
 void WorkoutDialog::setupExerciseTable()
 {
-    exerciseTable = new QTableWidget(0, 3, this);
-    
-    // Set headers
-    QStringList headers;
-    headers << tr("Exercise Name") << tr("Sets") << tr("Reps");
-    exerciseTable->setHorizontalHeaderLabels(headers);
+    exerciseModel = new ExerciseTableModel(this);
+    exerciseTable = new QTableView(this);
+    exerciseTable->setModel(exerciseModel);
+    exerciseTable->setSelectionBehavior(QAbstractItemView::SelectRows);
     
     // Adjust table properties
     exerciseTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
@@ -81,31 +117,170 @@ void WorkoutDialog::setupExerciseTable()
     exerciseTable->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Fixed);
     exerciseTable->setColumnWidth(1, 70);
     exerciseTable->setColumnWidth(2, 70);
+    exerciseTable->setItemDelegateForColumn(ExerciseTableModel::NameColumn, new ExerciseNameDelegate(exerciseTable));
+    exerciseTable->setItemDelegateForColumn(ExerciseTableModel::SetsColumn, new SpinBoxDelegate(0, 100, exerciseTable));
+    exerciseTable->setItemDelegateForColumn(ExerciseTableModel::RepsColumn, new SpinBoxDelegate(0, 1000, exerciseTable));
 }
 
-void WorkoutDialog::addExercise()
+void WorkoutDialog::setupSetTable()
 {
-    int row = exerciseTable->rowCount();
-    exerciseTable->insertRow(row);
+    setTable = new QTableWidget(0, 4, this);
     
-    QTableWidgetItem *nameItem = new QTableWidgetItem("");
-    QTableWidgetItem *setsItem = new QTableWidgetItem("0");
-    QTableWidgetItem *repsItem = new QTableWidgetItem("0");
+    QStringList headers;
+    headers << tr("Weight") << tr("Reps") << tr("RPE") << tr("Rest (s)");
+    setTable->setHorizontalHeaderLabels(headers);
+    setTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    setTable->setMaximumHeight(150);
+}
+
+void WorkoutDialog::addSetRow(const SetEntry &set)
+{
+    int row = setTable->rowCount();
+    setTable->insertRow(row);
+    setTable->setItem(row, 0, new QTableWidgetItem(QString::number(set.weight)));
+    setTable->setItem(row, 1, new QTableWidgetItem(QString::number(set.reps)));
+    setTable->setItem(row, 2, new QTableWidgetItem(QString::number(set.rpe)));
+    setTable->setItem(row, 3, new QTableWidgetItem(QString::number(set.restSeconds)));
+}
+
+void WorkoutDialog::addSet()
+{
+    if (!setTableRow.isValid()) {
+        return;
+    }
     
-    exerciseTable->setItem(row, 0, nameItem);
-    exerciseTable->setItem(row, 1, setsItem);
-    exerciseTable->setItem(row, 2, repsItem);
+    // A new set starts as a copy of the previous one, which is usually close
+    SetEntry set;
+    const QVector<SetEntry> &sets = exerciseModel->sets(setTableRow.row());
+    if (!sets.isEmpty()) {
+        set = sets.last();
+    }
+    loadingSets = true;
+    addSetRow(set);
+    loadingSets = false;
+    storeSetsForRow();
 }
 
-void WorkoutDialog::removeExercise()
+void WorkoutDialog::removeSet()
 {
-    QList<QTableWidgetItem*> selectedItems = exerciseTable->selectedItems();
+    QList<QTableWidgetItem*> selectedItems = setTable->selectedItems();
     if (!selectedItems.isEmpty()) {
-        int row = selectedItems.first()->row();
-        exerciseTable->removeRow(row);
+        setTable->removeRow(selectedItems.first()->row());
+        storeSetsForRow();
     }
 }
 
+void WorkoutDialog::showSetsForRow(int row)
+{
+    // A persistent index follows the exercise when rows move or are removed
+    setTableRow = row >= 0 && row < exerciseModel->rowCount()
+        ? QPersistentModelIndex(exerciseModel->index(row, 0))
+        : QPersistentModelIndex();
+    loadingSets = true;
+    setTable->setRowCount(0);
+    if (setTableRow.isValid()) {
+        const QVector<SetEntry> sets = exerciseModel->sets(row);
+        for (const SetEntry &set : sets) {
+            addSetRow(set);
+        }
+    }
+    loadingSets = false;
+    updateControlsState();
+}
+
+void WorkoutDialog::storeSetsForRow()
+{
+    if (loadingSets || !setTableRow.isValid()) {
+        return;
+    }
+    
+    QVector<SetEntry> sets;
+    for (int row = 0; row < setTable->rowCount(); ++row) {
+        auto text = [this, row](int column) {
+            QTableWidgetItem *item = setTable->item(row, column);
+            return item ? item->text() : QString();
+        };
+        sets.append(SetEntry{text(0).toFloat(), text(1).toInt(), text(2).toFloat(), text(3).toInt()});
+    }
+    exerciseModel->setSets(setTableRow.row(), sets);
+}
+
+QVector<QVector<SetEntry>> WorkoutDialog::getExerciseSets() const
+{
+    return exerciseModel->allSets();
+}
+
+void WorkoutDialog::setExerciseSets(const QVector<QVector<SetEntry>> &exerciseSets)
+{
+    exerciseModel->setAllSets(exerciseSets);
+    showSetsForRow(exerciseTable->currentIndex().row());
+}
+
+void WorkoutDialog::addExercise()
+{
+    int row = exerciseModel->rowCount();
+    exerciseModel->insertRows(row, 1);
+    
+    const QModelIndex name = exerciseModel->index(row, ExerciseTableModel::NameColumn);
+    exerciseTable->setCurrentIndex(name);
+    exerciseTable->edit(name);
+}
+
+void WorkoutDialog::removeExercise()
+{
+    // Remove bottom-up so earlier rows keep their numbers
+    QModelIndexList rows = exerciseTable->selectionModel()->selectedRows();
+    std::sort(rows.begin(), rows.end(), [](const QModelIndex &a, const QModelIndex &b) {
+        return a.row() > b.row();
+    });
+    for (const QModelIndex &index : rows) {
+        exerciseModel->removeRows(index.row(), 1);
+    }
+    showSetsForRow(exerciseTable->currentIndex().row());
+}
+
+void WorkoutDialog::moveExerciseUp()
+{
+    moveExercise(-1);
+}
+
+void WorkoutDialog::moveExerciseDown()
+{
+    moveExercise(1);
+}
+
+void WorkoutDialog::moveExercise(int offset)
+{
+    const QModelIndex current = exerciseTable->currentIndex();
+    const int row = current.row();
+    const int target = row + offset;
+    if (isReadOnly || !current.isValid() || target < 0 || target >= exerciseModel->rowCount()) {
+        return;
+    }
+    
+    // moveRows() takes the row the block is inserted before
+    exerciseModel->moveRows(QModelIndex(), row, 1, QModelIndex(), offset > 0 ? target + 1 : target);
+    exerciseTable->setCurrentIndex(exerciseModel->index(target, current.column()));
+}
+
+void WorkoutDialog::pasteExercises()
+{
+    if (isReadOnly) {
+        return;
+    }
+    
+    const QVector<Exercise> pasted = ExerciseTableModel::parseRows(QApplication::clipboard()->text());
+    if (pasted.isEmpty()) {
+        return;
+    }
+    
+    // Pasted rows go after the current one, or at the end
+    const QModelIndex current = exerciseTable->currentIndex();
+    const int row = current.isValid() ? current.row() + 1 : exerciseModel->rowCount();
+    exerciseModel->insertExercises(row, pasted);
+    exerciseTable->setCurrentIndex(exerciseModel->index(row, ExerciseTableModel::NameColumn));
+}
+
 QVector<Exercise> WorkoutDialog::getExercises() const
 {
     return getCurrentExercises();
@@ -113,23 +288,14 @@ QVector<Exercise> WorkoutDialog::getExercises() const
 
 void WorkoutDialog::setExercises(const QVector<Exercise> &exercises)
 {
-    exerciseTable->setRowCount(0);
-    for (const Exercise &exercise : exercises) {
-        addExerciseRow(exercise.name, exercise.sets, exercise.reps);
-    }
+    exerciseModel->setExercises(exercises);
+    showSetsForRow(exerciseTable->currentIndex().row());
 }
 
 QVector<Exercise> WorkoutDialog::getCurrentExercises() const
 {
-    QVector<Exercise> exercises;
-    for (int row = 0; row < exerciseTable->rowCount(); ++row) {
-        Exercise exercise;
-        exercise.name = exerciseTable->item(row, 0)->text();
-        exercise.sets = exerciseTable->item(row, 1)->text().toInt();
-        exercise.reps = exerciseTable->item(row, 2)->text().toInt();
-        exercises.append(exercise);
-    }
-    return exercises;
+    // Values are already typed in the model; nothing to parse
+    return exerciseModel->exercises();
 }
 
 void WorkoutDialog::saveWorkout()
@@ -140,28 +306,47 @@ void WorkoutDialog::saveWorkout()
         return;
     }
     
-    WorkoutStatus currentStatus = WorkoutStatus::NoWorkout;
-    QString oldName, oldDescription;
-    QVector<Exercise> oldExercises;
-    
-    if (StorageManager::instance().loadWorkout(workoutDate, 
-            oldName, oldDescription, oldExercises, currentStatus)) {
-        StorageManager::instance().saveWorkout(workoutDate, 
-            nameEdit->text(), 
-            descriptionEdit->toPlainText(), 
-            getCurrentExercises(),
-            currentStatus);
-    } else {
-        StorageManager::instance().saveWorkout(workoutDate, 
-            nameEdit->text(), 
-            descriptionEdit->toPlainText(), 
-            getCurrentExercises(),
-            WorkoutStatus::NoWorkout);
+    // Keep the day's status; the edited fields are temporaries and move in
+    const WorkoutRecord* existing = StorageManager::instance().find(workoutDate);
+    WorkoutStatus currentStatus = existing ? existing->status : WorkoutStatus::NoWorkout;
+    
+    // New bests are reported when the transaction commits
+    QVector<PersonalRecord> newRecords;
+    auto recordsConnection = connect(&StorageManager::instance(), &StorageManager::personalRecordsSet,
+                                     this, [&newRecords](const QVector<PersonalRecord> &records) {
+                                         newRecords += records;
+                                     });
+    
+    // Sets are saved after the workout they refer to, in the same save
+    StorageManager::Transaction transaction(StorageManager::instance());
+    StorageManager::instance().saveWorkout(workoutDate, 
+        nameEdit->text(), 
+        descriptionEdit->toPlainText(), 
+        getCurrentExercises(),
+        currentStatus);
+    StorageManager::instance().saveSets(workoutDate, getExerciseSets());
+    transaction.commit();
+    disconnect(recordsConnection);
+    
+    if (!newRecords.isEmpty()) {
+        showPersonalRecords(newRecords);
     }
     
     accept();
 }
 
+void WorkoutDialog::showPersonalRecords(const QVector<PersonalRecord> &records)
+{
+    QStringList lines;
+    for (const PersonalRecord &record : records) {
+        lines << tr("%1: %2 %3 (previous best %4)")
+                     .arg(record.exercise, recordMetricName(record.metric))
+                     .arg(double(record.value))
+                     .arg(double(record.previous));
+    }
+    QMessageBox::information(this, tr("New Personal Record"), lines.join('\n'));
+}
+
 void WorkoutDialog::setReadOnly(bool readOnly)
 {
     isReadOnly = readOnly;
@@ -170,27 +355,26 @@ void WorkoutDialog::setReadOnly(bool readOnly)
 
 void WorkoutDialog::addExerciseRow(const QString &name, int sets, int reps)
 {
-    int row = exerciseTable->rowCount();
-    exerciseTable->insertRow(row);
-    
-    QTableWidgetItem *nameItem = new QTableWidgetItem(name);
-    QTableWidgetItem *setsItem = new QTableWidgetItem(QString::number(sets));
-    QTableWidgetItem *repsItem = new QTableWidgetItem(QString::number(reps));
-    
-    exerciseTable->setItem(row, 0, nameItem);
-    exerciseTable->setItem(row, 1, setsItem);
-    exerciseTable->setItem(row, 2, repsItem);
+    exerciseModel->insertExercises(exerciseModel->rowCount(), {Exercise{name, sets, reps}});
 }
 
 void WorkoutDialog::updateControlsState()
 {
     nameEdit->setReadOnly(isReadOnly);
     descriptionEdit->setReadOnly(isReadOnly);
+    exerciseModel->setReadOnly(isReadOnly);
     exerciseTable->setEditTriggers(isReadOnly ? QAbstractItemView::NoEditTriggers 
-                                            : QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+                                            : QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed
+                                              | QAbstractItemView::AnyKeyPressed);
     
     addExerciseButton->setVisible(!isReadOnly);
     removeExerciseButton->setVisible(!isReadOnly);
+    moveUpButton->setVisible(!isReadOnly);
+    moveDownButton->setVisible(!isReadOnly);
+    setTable->setEditTriggers(exerciseTable->editTriggers());
+    addSetButton->setVisible(!isReadOnly);
+    addSetButton->setEnabled(setTableRow.isValid());
+    removeSetButton->setVisible(!isReadOnly);
     saveButton->setVisible(!isReadOnly);
     editButton->setVisible(isReadOnly);
     
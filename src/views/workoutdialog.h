@@ -5,12 +5,15 @@
 #include <QDate>
 #include <QLineEdit>
 #include <QTextEdit>
+#include <QTableView>
 #include <QTableWidget>
+#include <QPersistentModelIndex>
 #include <QPushButton>
 #include <QVBoxLayout>
 #include "../models/types.h"
 #include "../models/workout_status.h"
 #include "../models/storage_manager.h"
+#include "exercisetablemodel.h"
 
 class WorkoutDialog : public QDialog
 {
@@ -30,29 +33,51 @@ public:
     void setWorkoutDescription(const QString &desc) { descriptionEdit->setText(desc); }
     QVector<Exercise> getExercises() const;
     void setExercises(const QVector<Exercise> &exercises);
+    // Per-set detail, one list per exercise row
+    QVector<QVector<SetEntry>> getExerciseSets() const;
+    void setExerciseSets(const QVector<QVector<SetEntry>> &exerciseSets);
 
 private slots:
     void addExercise();
     void removeExercise();
+    void moveExerciseUp();
+    void moveExerciseDown();
+    void pasteExercises();
     void saveWorkout();
     void editWorkout();
+    void addSet();
+    void removeSet();
+    void showSetsForRow(int row);
+    void storeSetsForRow();
 
 private:
     void setupUI();
     void setupExerciseTable();
+    void setupSetTable();
+    void addSetRow(const SetEntry &set);
     void updateControlsState();
+    void moveExercise(int offset);
+    void showPersonalRecords(const QVector<PersonalRecord> &records);
     
     QLineEdit *nameEdit;
     QTextEdit *descriptionEdit;
-    QTableWidget *exerciseTable;
+    QTableView *exerciseTable;
+    ExerciseTableModel *exerciseModel;
     QPushButton *addExerciseButton;
     QPushButton *removeExerciseButton;
+    QPushButton *moveUpButton;
+    QPushButton *moveDownButton;
+    QTableWidget *setTable;
+    QPushButton *addSetButton;
+    QPushButton *removeSetButton;
     QPushButton *saveButton;
     QPushButton *cancelButton;
     QPushButton *editButton;
     
     QDate workoutDate;
     bool isReadOnly;
+    QPersistentModelIndex setTableRow;  // Exercise whose sets setTable shows
+    bool loadingSets = false;
     QVector<Exercise> getCurrentExercises() const;
 };
 
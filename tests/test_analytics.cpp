@@ -0,0 +1,43 @@
+// test_analytics.cpp
+#include "models/analytics.h"
+#include "models/storage_manager.h"
+#include <QTest>
+
+class TestAnalytics : public QObject {
+    Q_OBJECT
+private slots:
+    void dailyLoadCountsCompletedDaysOnly();
+};
+
+void TestAnalytics::dailyLoadCountsCompletedDaysOnly()
+{
+    StorageManager store;
+    store.setAutoSave(false);
+    const QDate completed(2024, 5, 6);
+    const QDate missed(2024, 5, 7);
+    const QDate planned(2024, 5, 8);
+    const QVector<Exercise> exercises{Exercise{"Squat", 3, 5}};
+
+    QVERIFY(store.saveWorkout(completed, "Legs", QString(), exercises, WorkoutStatus::Completed));
+    QVERIFY(store.saveSets(completed, {{SetEntry{100, 5}, SetEntry{100, 5}}}));
+    // Sets logged ahead of a session that was then missed
+    QVERIFY(store.saveWorkout(missed, "Legs", QString(), exercises, WorkoutStatus::Missed));
+    QVERIFY(store.saveSets(missed, {{SetEntry{120, 5}}}));
+    QVERIFY(store.saveWorkout(planned, "Legs", QString(), exercises, WorkoutStatus::NoWorkout));
+
+    const Analytics::DailyLoad load = Analytics::dailyLoad(store.records(), store.sets(),
+                                                           completed, planned);
+    QCOMPARE(load.size(), 3);
+    QCOMPARE(load.volume[0], 10.0f);
+    QCOMPARE(load.tonnage[0], 1000.0f);
+    QCOMPARE(load.volume[1], 0.0f);
+    QCOMPARE(load.tonnage[1], 0.0f);
+    QCOMPARE(load.volume[2], 0.0f);
+
+    const QVector<Analytics::WeeklyTotal> weeks = Analytics::weeklyTotals(load);
+    QCOMPARE(weeks.size(), 1);
+    QCOMPARE(weeks.first().volume, 10.0f);
+}
+
+QTEST_GUILESS_MAIN(TestAnalytics)
+#include "test_analytics.moc"
@@ -0,0 +1,54 @@
+// test_archive_blocks.cpp
+#include "models/archive_blocks.h"
+#include <QTest>
+
+class TestArchiveBlocks : public QObject {
+    Q_OBJECT
+private slots:
+    void damagedBlockIsSkippedAlone();
+    void legacyArchiveIsOneBlock();
+
+private:
+    static QByteArray threeBlocks(qsizetype* secondPayload);
+};
+
+QByteArray TestArchiveBlocks::threeBlocks(qsizetype* secondPayload)
+{
+    QByteArray archive = archiveHeader();
+    appendArchiveBlock(archive, R"({"workouts":[1]})");
+    *secondPayload = archive.size() + 12;
+    appendArchiveBlock(archive, R"({"workouts":[2]})");
+    appendArchiveBlock(archive, R"({"workouts":[3]})");
+    return archive;
+}
+
+void TestArchiveBlocks::damagedBlockIsSkippedAlone()
+{
+    qsizetype second = 0;
+    QByteArray archive = threeBlocks(&second);
+    QCOMPARE(readArchiveBlocks(archive).size(), 3);
+
+    archive[second + 2] = char(archive[second + 2] ^ 0x5A);
+    const QVector<ArchiveBlock> blocks = readArchiveBlocks(archive);
+    QCOMPARE(blocks.size(), 3);
+    QVERIFY(blocks[0].isIntact());
+    QCOMPARE(blocks[0].json, QByteArray(R"({"workouts":[1]})"));
+    QVERIFY(!blocks[1].isIntact());
+    QVERIFY(blocks[1].json.isEmpty());
+    QVERIFY(blocks[2].isIntact());
+    QCOMPARE(blocks[2].json, QByteArray(R"({"workouts":[3]})"));
+}
+
+void TestArchiveBlocks::legacyArchiveIsOneBlock()
+{
+    const QByteArray json = R"({"workouts":[]})";
+    const QVector<ArchiveBlock> blocks = readArchiveBlocks(qCompress(json, 9));
+    QCOMPARE(blocks.size(), 1);
+    QVERIFY(blocks.first().isIntact());
+    QCOMPARE(blocks.first().json, json);
+
+    QVERIFY(!readArchiveBlocks("not an archive").first().isIntact());
+}
+
+QTEST_GUILESS_MAIN(TestArchiveBlocks)
+#include "test_archive_blocks.moc"
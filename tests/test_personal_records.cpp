@@ -0,0 +1,56 @@
+// test_personal_records.cpp
+#include "models/storage_manager.h"
+#include <QSignalSpy>
+#include <QTest>
+
+class TestPersonalRecords : public QObject {
+    Q_OBJECT
+private slots:
+    void savingRecordDayAgainDoesNotAnnounce();
+    void raisingOwnRecordAnnounces();
+
+private:
+    static bool save(StorageManager& store, const QDate& date, int reps);
+};
+
+bool TestPersonalRecords::save(StorageManager& store, const QDate& date, int reps)
+{
+    return store.saveWorkout(date, "Push", QString(), {Exercise{"Push-ups", 3, reps}},
+                             WorkoutStatus::Completed);
+}
+
+void TestPersonalRecords::savingRecordDayAgainDoesNotAnnounce()
+{
+    StorageManager store;
+    store.setAutoSave(false);
+    QSignalSpy spy(&store, &StorageManager::personalRecordsSet);
+
+    QVERIFY(save(store, QDate(2024, 3, 1), 10));
+    QCOMPARE(spy.count(), 0);  // the first value is not a record
+    QVERIFY(save(store, QDate(2024, 3, 4), 12));
+    QCOMPARE(spy.count(), 1);
+
+    // Editing the record day without raising its values
+    QVERIFY(save(store, QDate(2024, 3, 4), 12));
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestPersonalRecords::raisingOwnRecordAnnounces()
+{
+    StorageManager store;
+    store.setAutoSave(false);
+    QSignalSpy spy(&store, &StorageManager::personalRecordsSet);
+
+    QVERIFY(save(store, QDate(2024, 3, 1), 10));
+    QVERIFY(save(store, QDate(2024, 3, 4), 12));
+    QVERIFY(save(store, QDate(2024, 3, 4), 14));
+    QCOMPARE(spy.count(), 2);
+
+    const auto records = spy.last().first().value<QVector<PersonalRecord>>();
+    QVERIFY(!records.isEmpty());
+    QCOMPARE(records.first().value, 14.0f);
+    QCOMPARE(records.first().previous, 10.0f);
+}
+
+QTEST_GUILESS_MAIN(TestPersonalRecords)
+#include "test_personal_records.moc"
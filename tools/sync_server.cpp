@@ -0,0 +1,258 @@
+// tools/sync_server.cpp
+//
+// Local stand-in for the sync endpoint, for development:
+//
+//   workout-sync-server [--port PORT] [--state FILE]
+//
+// Answers POST /sync in the SyncProtocol format. The server keeps only the
+// latest state of each day, tagged with the sequence number it was stored
+// under and the device that sent it; a client's cursor is the last sequence
+// number it has seen. Each profile has a history and sequence of its own.
+// With --state the histories survive restarts.
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QSaveFile>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <cstdio>
+#include "sync/sync_protocol.h"
+
+namespace {
+
+class SyncServer : public QObject {
+public:
+    explicit SyncServer(const QString& statePath) : statePath(statePath) { load(); }
+
+    bool listen(quint16 port)
+    {
+        connect(&server, &QTcpServer::newConnection, this, [this] {
+            while (QTcpSocket* socket = server.nextPendingConnection()) {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket] { readRequest(socket); });
+                connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+                    buffers.remove(socket);
+                    socket->deleteLater();
+                });
+            }
+        });
+        return server.listen(QHostAddress::LocalHost, port);
+    }
+
+private:
+    struct Entry {
+        quint64 sequence = 0;
+        QString device;
+        QJsonObject day;
+    };
+    struct History {
+        QMap<QString, Entry> latest;       // by ISO date
+        QMap<quint64, QString> sequences;  // sequence number -> date
+        quint64 lastSequence = 0;
+
+        void insert(Entry entry);
+    };
+
+    void readRequest(QTcpSocket* socket);
+    void reply(QTcpSocket* socket, int status, const QByteArray& reason, const QByteArray& body = {});
+    QByteArray exchange(const QJsonObject& request);
+    void load();
+    void save() const;
+
+    QTcpServer server;
+    QString statePath;
+    QHash<QTcpSocket*, QByteArray> buffers;
+    // By profile; the default profile is ""
+    QMap<QString, History> histories;
+};
+
+void SyncServer::History::insert(Entry entry)
+{
+    const QString date = entry.day["date"].toString();
+    sequences.insert(entry.sequence, date);
+    lastSequence = qMax(lastSequence, entry.sequence);
+    latest.insert(date, std::move(entry));
+}
+
+void SyncServer::readRequest(QTcpSocket* socket)
+{
+    QByteArray& buffer = buffers[socket];
+    buffer += socket->readAll();
+    const qsizetype headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return;
+    }
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.value(0).trimmed().split(' ');
+    qsizetype contentLength = 0;
+    for (const QByteArray& line : lines.mid(1)) {
+        const qsizetype colon = line.indexOf(':');
+        if (colon > 0 && line.left(colon).trimmed().toLower() == "content-length") {
+            contentLength = line.mid(colon + 1).trimmed().toLongLong();
+        }
+    }
+    if (buffer.size() < headerEnd + 4 + contentLength) {
+        return;
+    }
+
+    const QByteArray body = buffer.mid(headerEnd + 4, contentLength);
+    buffers.remove(socket);
+
+    QJsonObject request;
+    if (requestLine.value(0) != "POST" || requestLine.value(1) != "/sync") {
+        reply(socket, 404, "Not Found");
+    } else if (!SyncProtocol::decode(body, request) || request["device"].toString().isEmpty()) {
+        reply(socket, 400, "Bad Request");
+    } else {
+        reply(socket, 200, "OK", exchange(request));
+    }
+}
+
+void SyncServer::reply(QTcpSocket* socket, int status, const QByteArray& reason, const QByteArray& body)
+{
+    socket->write("HTTP/1.1 " + QByteArray::number(status) + ' ' + reason + "\r\n"
+                  "Content-Type: application/x-workout-sync\r\n"
+                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                  "Connection: close\r\n\r\n" + body);
+    socket->disconnectFromHost();
+}
+
+QByteArray SyncServer::exchange(const QJsonObject& request)
+{
+    const QString device = request["device"].toString();
+    const QString profile = request["profile"].toString();
+    const quint64 since = quint64(request["since"].toInteger());
+    History& history = histories[profile];
+    QMap<QString, Entry>& latest = history.latest;
+    QMap<quint64, QString>& sequences = history.sequences;
+    quint64& lastSequence = history.lastSequence;
+
+    const QJsonArray changes = request["changes"].toArray();
+    QJsonArray conflicts;
+    for (const QJsonValue& value : changes) {
+        const QJsonObject day = value.toObject();
+        const QString date = day["date"].toString();
+        if (date.isEmpty()) {
+            continue;
+        }
+        auto previous = latest.constFind(date);
+        if (previous != latest.cend()) {
+            // Another device's change this client never received
+            if (previous->device != device && previous->sequence > since) {
+                conflicts.append(date);
+            }
+            sequences.remove(previous->sequence);
+        }
+        latest[date] = Entry{++lastSequence, device, day};
+        sequences.insert(lastSequence, date);
+    }
+    if (!changes.isEmpty()) {
+        save();
+    }
+
+    // Days stored by other devices since the client's cursor, in order
+    QJsonArray days;
+    quint64 cursor = since;
+    auto it = sequences.upperBound(since);
+    for (; it != sequences.cend() && days.size() < SyncProtocol::MaxBatch; ++it) {
+        const Entry& entry = latest[it.value()];
+        if (entry.device != device) {
+            days.append(entry.day);
+        }
+        cursor = it.key();
+    }
+    if (it == sequences.cend()) {
+        cursor = qMax(cursor, lastSequence);
+    }
+
+    std::printf("%s%s%s: received %d, sent %d, cursor %llu\n", qPrintable(device),
+                profile.isEmpty() ? "" : " ", qPrintable(profile), int(changes.size()),
+                int(days.size()), static_cast<unsigned long long>(cursor));
+    std::fflush(stdout);
+
+    QJsonObject response;
+    response["cursor"] = qint64(cursor);
+    response["more"] = it != sequences.cend();
+    response["changes"] = days;
+    response["conflicts"] = conflicts;
+    return SyncProtocol::encode(response);
+}
+
+void SyncServer::load()
+{
+    QFile file(statePath);
+    if (statePath.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+    // State files from before profiles hold the default profile's days only
+    QJsonObject profiles = json["profiles"].toObject();
+    if (json.contains("days")) {
+        profiles.insert(QString(), QJsonObject{{"days", json["days"]}});
+    }
+    for (auto profile = profiles.constBegin(); profile != profiles.constEnd(); ++profile) {
+        History& history = histories[profile.key()];
+        for (const QJsonValue& value : profile.value().toObject()["days"].toArray()) {
+            const QJsonObject entryObj = value.toObject();
+            history.insert(Entry{quint64(entryObj["sequence"].toInteger()), entryObj["device"].toString(),
+                                 entryObj["day"].toObject()});
+        }
+    }
+}
+
+void SyncServer::save() const
+{
+    if (statePath.isEmpty()) {
+        return;
+    }
+    QJsonObject profiles;
+    for (auto history = histories.cbegin(); history != histories.cend(); ++history) {
+        QJsonArray days;
+        for (const Entry& entry : history->latest) {
+            QJsonObject entryObj;
+            entryObj["sequence"] = qint64(entry.sequence);
+            entryObj["device"] = entry.device;
+            entryObj["day"] = entry.day;
+            days.append(entryObj);
+        }
+        profiles.insert(history.key(), QJsonObject{{"days", days}});
+    }
+    // Replaced only once fully written, so a crash keeps the previous state
+    QSaveFile file(statePath);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(QJsonObject{{"profiles", profiles}}).toJson(QJsonDocument::Compact)) == -1
+        || !file.commit()) {
+        std::fprintf(stderr, "workout-sync-server: cannot write %s\n", qPrintable(statePath));
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("workout-sync-server");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Local sync endpoint for development: http://127.0.0.1:PORT/sync");
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", "Port to listen on.", "port", "8765");
+    QCommandLineOption stateOption("state", "File keeping the synced days between runs.", "file");
+    parser.addOptions({portOption, stateOption});
+    parser.process(app);
+
+    SyncServer server(parser.value(stateOption));
+    const quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!server.listen(port)) {
+        std::fprintf(stderr, "workout-sync-server: cannot listen on port %u\n", unsigned(port));
+        return 1;
+    }
+    std::printf("Listening on http://127.0.0.1:%u/sync\n", unsigned(port));
+    std::fflush(stdout);
+    return app.exec();
+}
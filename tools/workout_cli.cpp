@@ -0,0 +1,673 @@
+// tools/workout_cli.cpp
+//
+// Headless batch operations over one or many workouts.json files:
+//
+//   workout-cli stats [--from DATE] [--to DATE] PATH...
+//   workout-cli find-exercise NAME [--from DATE] [--to DATE] PATH...
+//   workout-cli mark --status STATUS --from DATE --to DATE [--create] [--archive] PATH...
+//   workout-cli export [--format csv|jsonl] PATH...
+//   workout-cli import CSV --output FILE
+//   workout-cli merge BASE OURS THEIRS [--prefer ours|theirs] [--output FILE] [--archive]
+//   workout-cli verify PATH...
+//   workout-cli repair FILE [--output FILE] [--archive]
+//
+// Files are written back whole. With --archive, closed years go to year
+// archives beside the file instead (FILE-YYYY.archive), as the app does.
+//
+// A PATH may be a data file or a directory, which is searched recursively for
+// workouts.json files (and, for verify, year archives). Files are processed in
+// parallel and each file's results are written to stdout as soon as it is done.
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QThread>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <cstdio>
+#include <functional>
+#include <utility>
+#include "models/archive_blocks.h"
+#include "models/storage_manager.h"
+#include "models/workout_json_reader.h"
+#include "models/workout_merge.h"
+
+namespace {
+
+struct Options {
+    QDate from;
+    QDate to;
+    QString exercise;
+    WorkoutStatus status = WorkoutStatus::NoWorkout;
+    bool create = false;
+    bool archive = false;  // save tiered, as the app does
+    QString format;
+    int threads = 1;                     // per file, for verify
+    QAtomicInt* damagedFiles = nullptr;  // counted by verify
+};
+
+// Serializes whole chunks so lines from parallel jobs never interleave
+class OutputSink {
+public:
+    void write(const QByteArray& data)
+    {
+        if (data.isEmpty()) return;
+        QMutexLocker locker(&mutex);
+        std::fwrite(data.constData(), 1, data.size(), stdout);
+        std::fflush(stdout);
+    }
+
+private:
+    QMutex mutex;
+};
+
+void printError(const QString& message)
+{
+    std::fprintf(stderr, "workout-cli: %s\n", qPrintable(message));
+}
+
+bool inRange(const QDate& date, const Options& options)
+{
+    return (!options.from.isValid() || date >= options.from)
+        && (!options.to.isValid() || date <= options.to);
+}
+
+QByteArray csvField(const QString& value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"'))
+        && !value.contains(QLatin1Char('\n'))) {
+        return value.toUtf8();
+    }
+    QString escaped = value;
+    escaped.replace(QLatin1String("\""), QLatin1String("\"\""));
+    return '"' + escaped.toUtf8() + '"';
+}
+
+QList<QStringList> parseCsv(const QString& text)
+{
+    QList<QStringList> rows;
+    QStringList row;
+    QString field;
+    bool quoted = false;
+
+    for (int i = 0; i < text.size(); ++i) {
+        QChar c = text[i];
+        if (quoted) {
+            if (c == QLatin1Char('"')) {
+                if (i + 1 < text.size() && text[i + 1] == QLatin1Char('"')) {
+                    field += c;
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += c;
+            }
+        } else if (c == QLatin1Char('"')) {
+            quoted = true;
+        } else if (c == QLatin1Char(',')) {
+            row << field;
+            field.clear();
+        } else if (c == QLatin1Char('\n')) {
+            row << field;
+            field.clear();
+            rows << row;
+            row.clear();
+        } else if (c != QLatin1Char('\r')) {
+            field += c;
+        }
+    }
+    if (!field.isEmpty() || !row.isEmpty()) {
+        row << field;
+        rows << row;
+    }
+    return rows;
+}
+
+QStringList collectFiles(const QStringList& paths, const QStringList& names = {"workouts.json"})
+{
+    QStringList files;
+    for (const QString& path : paths) {
+        QFileInfo info(path);
+        if (info.isDir()) {
+            QDirIterator it(path, names, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                files << it.next();
+            }
+        } else {
+            files << path;
+        }
+    }
+    files.sort();
+    return files;
+}
+
+bool loadStore(StorageManager& store, const QString& path)
+{
+    if (!QFileInfo::exists(path)) {
+        printError(QString("%1: no such file").arg(path));
+        return false;
+    }
+    if (!store.loadFromFile(path)) {
+        printError(QString("%1: could not be loaded").arg(path));
+        return false;
+    }
+    return true;
+}
+
+// Each job turns one data file into a chunk of output; returns false on error
+using FileJob = std::function<bool(const QString& path, QByteArray& output)>;
+
+int runParallel(const QStringList& files, int jobs, const FileJob& job, OutputSink& sink)
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+    QAtomicInt failures;
+
+    for (const QString& path : files) {
+        pool.start([&job, &sink, &failures, path]() {
+            QByteArray output;
+            if (job(path, output)) {
+                sink.write(output);
+            } else {
+                failures.fetchAndAddRelaxed(1);
+            }
+        });
+    }
+    pool.waitForDone();
+    return failures.loadRelaxed();
+}
+
+bool statsJob(const QString& path, const Options& options, QByteArray& output)
+{
+    StorageManager store;
+    if (!loadStore(store, path)) return false;
+
+    int workouts = 0;
+    int perStatus[4] = {0, 0, 0, 0};
+    int exerciseCount = 0;
+    qint64 volume = 0;
+
+    for (const QDate& date : store.getAllWorkoutDates()) {
+        if (!inRange(date, options)) continue;
+
+        const WorkoutRecord* workout = store.find(date);
+        if (!workout) continue;
+
+        ++workouts;
+        ++perStatus[static_cast<int>(workout->status) & 3];
+        exerciseCount += workout->exercises().size();
+        for (const Exercise& exercise : workout->exercises()) {
+            volume += qint64(exercise.sets) * exercise.reps;
+        }
+    }
+
+    output = QString("%1\t%2\t%3\t%4\t%5\t%6\t%7\t%8\n")
+                 .arg(path)
+                 .arg(workouts)
+                 .arg(perStatus[static_cast<int>(WorkoutStatus::Completed)])
+                 .arg(perStatus[static_cast<int>(WorkoutStatus::Missed)])
+                 .arg(perStatus[static_cast<int>(WorkoutStatus::RestDay)])
+                 .arg(perStatus[static_cast<int>(WorkoutStatus::NoWorkout)])
+                 .arg(exerciseCount)
+                 .arg(volume)
+                 .toUtf8();
+    return true;
+}
+
+bool findExerciseJob(const QString& path, const Options& options, QByteArray& output)
+{
+    StorageManager store;
+    if (!loadStore(store, path)) return false;
+
+    for (const QDate& date : store.getAllWorkoutDates()) {
+        if (!inRange(date, options)) continue;
+
+        const WorkoutRecord* workout = store.find(date);
+        if (!workout) continue;
+
+        for (const Exercise& exercise : workout->exercises()) {
+            if (exercise.name.compare(options.exercise, Qt::CaseInsensitive) == 0) {
+                output += path.toUtf8() + '\t' + date.toString(Qt::ISODate).toUtf8()
+                        + '\t' + workout->name().toUtf8() + '\n';
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+bool markJob(const QString& path, const Options& options, QByteArray& output)
+{
+    StorageManager store;
+    if (!loadStore(store, path)) return false;
+    store.setAutoSave(false);
+    store.setArchiving(options.archive);
+
+    int changed = 0;
+    for (QDate date = options.from; date <= options.to; date = date.addDays(1)) {
+        const WorkoutRecord* workout = store.find(date);
+        if ((workout && workout->status != options.status) || (!workout && options.create)) {
+            store.setStatus(date, options.status);
+            ++changed;
+        }
+    }
+
+    if (store.isModified() && !store.saveToFile(path)) {
+        printError(QString("%1: could not be saved").arg(path));
+        return false;
+    }
+
+    output = QString("%1\t%2\n").arg(path).arg(changed).toUtf8();
+    return true;
+}
+
+bool exportJob(const QString& path, const Options& options, QByteArray& output)
+{
+    StorageManager store;
+    if (!loadStore(store, path)) return false;
+
+    const bool jsonLines = options.format == QLatin1String("jsonl");
+
+    for (const QDate& date : store.getAllWorkoutDates()) {
+        if (!inRange(date, options)) continue;
+
+        const WorkoutRecord* workout = store.find(date);
+        if (!workout) continue;
+
+        if (jsonLines) {
+            QJsonObject workoutObj;
+            workoutObj["file"] = path;
+            workoutObj["date"] = date.toString(Qt::ISODate);
+            workoutObj["status"] = workoutStatusName(workout->status);
+            workoutObj["name"] = workout->name();
+            workoutObj["description"] = workout->description();
+
+            QJsonArray exercisesArray;
+            for (const Exercise& exercise : workout->exercises()) {
+                QJsonObject exerciseObj;
+                exerciseObj["name"] = exercise.name;
+                exerciseObj["sets"] = exercise.sets;
+                exerciseObj["reps"] = exercise.reps;
+                exercisesArray.append(exerciseObj);
+            }
+            workoutObj["exercises"] = exercisesArray;
+
+            output += QJsonDocument(workoutObj).toJson(QJsonDocument::Compact) + '\n';
+            continue;
+        }
+
+        QByteArray prefix = csvField(path) + ',' + date.toString(Qt::ISODate).toUtf8() + ','
+                          + workoutStatusName(workout->status).toUtf8() + ','
+                          + csvField(workout->name()) + ',' + csvField(workout->description()) + ',';
+        if (workout->exercises().isEmpty()) {
+            output += prefix + ",,\n";
+        }
+        for (const Exercise& exercise : workout->exercises()) {
+            output += prefix + csvField(exercise.name) + ',' + QByteArray::number(exercise.sets)
+                    + ',' + QByteArray::number(exercise.reps) + '\n';
+        }
+    }
+    return true;
+}
+
+// Checks every record against its checksum. A file that does not parse is
+// scanned in parallel chunks for what is still intact; archive blocks are
+// checked on their own. Prints a summary line per file and one line per
+// damaged byte range.
+bool verifyJob(const QString& path, const Options& options, QByteArray& output)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        printError(QString("%1: could not be opened").arg(path));
+        return false;
+    }
+    QVector<ArchiveBlock> blocks;
+    if (path.endsWith(QLatin1String(".archive"))) {
+        blocks = readArchiveBlocks(file.readAll());
+    } else {
+        ArchiveBlock whole;
+        whole.json = file.readAll();
+        whole.end = whole.json.size();
+        blocks.append(whole);
+    }
+
+    int records = 0;
+    int checked = 0;
+    QByteArray ranges;
+    int damagedRanges = 0;
+    for (const ArchiveBlock& block : std::as_const(blocks)) {
+        if (!block.isIntact()) {
+            ranges += QString("damaged\t%1\t%2-%3\t\t%4\n").arg(path).arg(block.begin).arg(block.end)
+                          .arg(block.error).toUtf8();
+            ++damagedRanges;
+            continue;
+        }
+
+        StringPool strings;
+        BodyStore bodies;
+        RecordTable table;
+        WorkoutJsonReader reader(block.json, strings, bodies);
+        if (!reader.read(table)) {
+            table.clear();
+            reader.salvage(table, options.threads);
+        }
+        records += reader.recordCount();
+        checked += reader.checkedCount();
+        // Ranges inside an archive block count from the start of its
+        // uncompressed document
+        for (const DamagedRange& range : reader.damaged()) {
+            ranges += QString("damaged\t%1\t%2-%3\t%4\t%5\n").arg(path).arg(range.begin).arg(range.end)
+                          .arg(range.date.toString(Qt::ISODate), range.reason).toUtf8();
+            ++damagedRanges;
+        }
+    }
+
+    output = QString("%1\t%2\t%3\t%4\n").arg(path).arg(records).arg(checked).arg(damagedRanges).toUtf8();
+    output += ranges;
+    if (damagedRanges > 0) {
+        options.damagedFiles->fetchAndAddRelaxed(1);
+    }
+    return true;
+}
+
+// Loads what is intact of a damaged data file and its archives and writes it
+// back (or to `outputPath`). Loading keeps each damaged original as
+// FILE.damaged.
+int repairFile(const QString& path, const QString& outputPath, bool archive)
+{
+    StorageManager store;
+    store.setAutoSave(false);
+    store.setSalvageDamaged(true);
+    store.setArchiving(archive);
+    if (!loadStore(store, path)) {
+        return 1;
+    }
+    const int records = int(store.records().size());
+    const bool damaged = store.isModified();
+    if (!damaged && outputPath.isEmpty()) {
+        std::printf("%s\tintact\t%d\n", qPrintable(path), records);
+        return 0;
+    }
+
+    const QString target = outputPath.isEmpty() ? path : outputPath;
+    if (!store.saveToFile(target)) {
+        printError(QString("%1: could not be saved").arg(target));
+        return 1;
+    }
+    std::printf("%s\t%s\t%d\n", qPrintable(target), damaged ? "repaired" : "intact", records);
+    return 0;
+}
+
+int importCsv(const QString& csvPath, const QString& outputPath)
+{
+    QFile file(csvPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        printError(QString("%1: could not be opened").arg(csvPath));
+        return 1;
+    }
+
+    QList<QStringList> rows = parseCsv(QString::fromUtf8(file.readAll()));
+    if (rows.isEmpty()) {
+        printError(QString("%1: empty file").arg(csvPath));
+        return 1;
+    }
+
+    // Columns are located by header name so exported files round-trip
+    const QStringList header = rows.takeFirst();
+    const int dateColumn = header.indexOf("date");
+    const int statusColumn = header.indexOf("status");
+    const int nameColumn = header.indexOf("workout");
+    const int descriptionColumn = header.indexOf("description");
+    const int exerciseColumn = header.indexOf("exercise");
+    const int setsColumn = header.indexOf("sets");
+    const int repsColumn = header.indexOf("reps");
+    if (dateColumn < 0) {
+        printError(QString("%1: missing 'date' column").arg(csvPath));
+        return 1;
+    }
+
+    auto column = [](const QStringList& row, int index) {
+        return index >= 0 && index < row.size() ? row[index] : QString();
+    };
+
+    struct PendingWorkout {
+        WorkoutBody body;
+        WorkoutStatus status = WorkoutStatus::NoWorkout;
+    };
+    QMap<QDate, PendingWorkout> pending;
+
+    for (const QStringList& row : rows) {
+        QDate date = QDate::fromString(column(row, dateColumn), Qt::ISODate);
+        if (!date.isValid()) continue;
+
+        bool isNew = !pending.contains(date);
+        PendingWorkout& workout = pending[date];
+        if (isNew) {
+            workout.body.name = column(row, nameColumn);
+            workout.body.description = column(row, descriptionColumn);
+            parseWorkoutStatus(column(row, statusColumn), workout.status);
+        }
+
+        QString exerciseName = column(row, exerciseColumn);
+        if (!exerciseName.isEmpty()) {
+            workout.body.exercises.append(Exercise{exerciseName,
+                                              column(row, setsColumn).toInt(),
+                                              column(row, repsColumn).toInt()});
+        }
+    }
+
+    StorageManager store;
+    store.setAutoSave(false);
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+        store.saveWorkout(it.key(), WorkoutRecord(std::move(it->body), it->status));
+    }
+
+    if (!store.saveToFile(outputPath)) {
+        printError(QString("%1: could not be saved").arg(outputPath));
+        return 1;
+    }
+
+    std::printf("%s\t%d\n", qPrintable(outputPath), int(pending.size()));
+    return 0;
+}
+
+// Merges THEIRS into OURS relative to BASE and writes the result to
+// `outputPath` (OURS itself by default). Conflicts are listed on stdout; they
+// are only written when `prefer` says which side wins.
+int mergeFiles(const QStringList& paths, const QString& prefer, const QString& outputPath, bool archive)
+{
+    StorageManager base;
+    StorageManager ours;
+    StorageManager theirs;
+    if (!loadStore(base, paths[0]) || !loadStore(ours, paths[1]) || !loadStore(theirs, paths[2])) {
+        return 1;
+    }
+    ours.setAutoSave(false);
+    ours.setArchiving(archive);
+
+    WorkoutMerge merge(base, ours, theirs);
+    for (const MergeDay& day : merge.days()) {
+        if (day.conflicts) {
+            std::printf("conflict\t%s\t%s\n", qPrintable(day.date.toString(Qt::ISODate)),
+                        qPrintable(mergeFieldNames(day.conflicts)));
+        } else {
+            std::printf("theirs\t%s\t%s\n", qPrintable(day.date.toString(Qt::ISODate)),
+                        qPrintable(mergeFieldNames(day.taken)));
+        }
+    }
+
+    const int conflicts = merge.conflictCount();
+    if (conflicts > 0 && prefer.isEmpty()) {
+        printError(QString("%1 conflicting days; nothing written (use --prefer ours|theirs)").arg(conflicts));
+        return 3;
+    }
+    merge.resolveAll(prefer == QLatin1String("theirs") ? MergeSide::Theirs : MergeSide::Ours);
+    ours.replaceDays(merge.result());
+
+    const QString target = outputPath.isEmpty() ? paths[1] : outputPath;
+    if (!ours.saveToFile(target)) {
+        printError(QString("%1: could not be saved").arg(target));
+        return 1;
+    }
+    std::printf("%s\t%d\t%d\n", qPrintable(target), int(merge.days().size()), conflicts);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("workout-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Batch queries and bulk edits over workouts.json files.\n\n"
+        "Commands:\n"
+        "  stats PATH...                 Per-file workout counts and volume\n"
+        "  find-exercise NAME PATH...    Dates whose workout includes NAME\n"
+        "  mark PATH...                  Set the status of a date range\n"
+        "  export PATH...                Write records as CSV or JSON lines\n"
+        "  import CSV                    Build a data file from a CSV export\n"
+        "  merge BASE OURS THEIRS        Three-way merge of two edited copies\n"
+        "  verify PATH...                Check record checksums, list damaged ranges\n"
+        "  repair FILE                   Rewrite a damaged file with what is intact");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "stats, find-exercise, mark, export, import, merge, verify or repair.");
+    parser.addPositionalArgument("paths", "Data files or directories.", "PATH...");
+
+    QCommandLineOption fromOption("from", "First date of the range (YYYY-MM-DD).", "date");
+    QCommandLineOption toOption("to", "Last date of the range (YYYY-MM-DD).", "date");
+    QCommandLineOption statusOption("status", "completed, missed, rest or planned.", "status");
+    QCommandLineOption createOption("create", "mark: also create records for empty days.");
+    QCommandLineOption formatOption("format", "export: csv or jsonl.", "format", "csv");
+    QCommandLineOption outputOption({"o", "output"}, "import, merge, repair: data file to write.", "file");
+    QCommandLineOption preferOption("prefer", "merge: side that wins conflicts, ours or theirs.", "side");
+    QCommandLineOption archiveOption("archive", "mark, merge, repair: move closed years to FILE-YYYY.archive "
+                                                "beside the file, as the app does, instead of writing it whole.");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Files processed in parallel.", "n",
+                                  QString::number(QThread::idealThreadCount()));
+    QCommandLineOption verboseOption("verbose", "Show storage log messages.");
+    parser.addOptions({fromOption, toOption, statusOption, createOption, formatOption,
+                       outputOption, preferOption, archiveOption, jobsOption, verboseOption});
+    parser.process(app);
+
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("default.debug=false\ndefault.info=false");
+    }
+
+    QStringList args = parser.positionalArguments();
+    if (args.isEmpty()) {
+        parser.showHelp(1);
+    }
+    const QString command = args.takeFirst();
+
+    Options options;
+    options.from = QDate::fromString(parser.value(fromOption), Qt::ISODate);
+    options.to = QDate::fromString(parser.value(toOption), Qt::ISODate);
+    options.create = parser.isSet(createOption);
+    options.format = parser.value(formatOption);
+    options.archive = parser.isSet(archiveOption);
+
+    if (command == QLatin1String("import")) {
+        if (args.size() != 1 || !parser.isSet(outputOption)) {
+            printError("import expects one CSV file and --output");
+            return 1;
+        }
+        return importCsv(args.first(), parser.value(outputOption));
+    }
+
+    if (command == QLatin1String("merge")) {
+        const QString prefer = parser.value(preferOption);
+        if (args.size() != 3 || (!prefer.isEmpty() && prefer != QLatin1String("ours")
+                                 && prefer != QLatin1String("theirs"))) {
+            printError("merge expects BASE, OURS and THEIRS files and --prefer ours or theirs");
+            return 1;
+        }
+        return mergeFiles(args, prefer, parser.value(outputOption), options.archive);
+    }
+
+    if (command == QLatin1String("repair")) {
+        if (args.size() != 1) {
+            printError("repair expects one data file");
+            return 1;
+        }
+        return repairFile(args.first(), parser.value(outputOption), options.archive);
+    }
+
+    FileJob job;
+    QByteArray header;
+    QStringList names = {"workouts.json"};
+    QAtomicInt damagedFiles;
+    options.damagedFiles = &damagedFiles;
+
+    if (command == QLatin1String("stats")) {
+        header = "file\tworkouts\tcompleted\tmissed\trest\tplanned\texercises\tvolume\n";
+        job = [&options](const QString& path, QByteArray& output) {
+            return statsJob(path, options, output);
+        };
+    } else if (command == QLatin1String("find-exercise")) {
+        if (args.isEmpty()) {
+            printError("find-exercise expects an exercise name");
+            return 1;
+        }
+        options.exercise = args.takeFirst();
+        job = [&options](const QString& path, QByteArray& output) {
+            return findExerciseJob(path, options, output);
+        };
+    } else if (command == QLatin1String("mark")) {
+        if (!options.from.isValid() || !options.to.isValid()
+            || !parseWorkoutStatus(parser.value(statusOption), options.status)) {
+            printError("mark expects --status, --from and --to");
+            return 1;
+        }
+        job = [&options](const QString& path, QByteArray& output) {
+            return markJob(path, options, output);
+        };
+    } else if (command == QLatin1String("export")) {
+        if (options.format != QLatin1String("csv") && options.format != QLatin1String("jsonl")) {
+            printError("export --format must be csv or jsonl");
+            return 1;
+        }
+        if (options.format == QLatin1String("csv")) {
+            header = "file,date,status,workout,description,exercise,sets,reps\n";
+        }
+        job = [&options](const QString& path, QByteArray& output) {
+            return exportJob(path, options, output);
+        };
+    } else if (command == QLatin1String("verify")) {
+        header = "file\trecords\tchecked\tdamaged\n";
+        names << "*.archive";
+        job = [&options](const QString& path, QByteArray& output) {
+            return verifyJob(path, options, output);
+        };
+    } else {
+        printError(QString("unknown command '%1'").arg(command));
+        return 1;
+    }
+
+    const QStringList files = collectFiles(args, names);
+    if (files.isEmpty()) {
+        printError("no data files given");
+        return 1;
+    }
+
+    OutputSink sink;
+    sink.write(header);
+
+    // Threads left over from running files side by side go to each file
+    int jobs = qMax(1, parser.value(jobsOption).toInt());
+    options.threads = qMax(1, QThread::idealThreadCount() / int(qMin<qsizetype>(jobs, files.size())));
+    int failures = runParallel(files, jobs, job, sink);
+    if (failures > 0) {
+        return 2;
+    }
+    return damagedFiles.loadRelaxed() == 0 ? 0 : 3;
+}